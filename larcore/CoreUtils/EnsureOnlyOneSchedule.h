@@ -19,6 +19,12 @@
  *     ..
  *   };
  *
+ * Services wrapping a provider with `lar::SimpleServiceProviderWrapper` or
+ * `lar::ServiceProviderImplementationWrapper` can instead get one provider
+ * per schedule by flagging it with `lar::ProviderPerSchedule`.
+ * Other components can be wrapped in `lar::SerializedAccess`, which lets
+ * them run in multi-schedule jobs one access at a time.
+ *
  */
 
 namespace lar {
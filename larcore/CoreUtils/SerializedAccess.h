@@ -0,0 +1,216 @@
+/**
+ * @file   SerializedAccess.h
+ * @brief  Adapter serializing the access to an object not supporting threads
+ * @see    larcore/CoreUtils/EnsureOnlyOneSchedule.h
+ *
+ * This library is currently a pure header.
+ * The callers will need to link to:
+ *
+ * * `${TBB}`
+ *
+ * It provides:
+ *
+ * - lar::SerializedAccess, owning an object and granting access to it to one
+ *   thread at a time, while collecting statistics about the contention
+ *
+ */
+
+#ifndef LARCORE_COREUTILS_SERIALIZEDACCESS_H
+#define LARCORE_COREUTILS_SERIALIZEDACCESS_H
+
+// TBB libraries
+#include "tbb/queuing_mutex.h"
+
+// C/C++ standard libraries
+#include <chrono>
+#include <utility> // std::forward()
+#include <algorithm> // std::max()
+
+
+namespace lar {
+
+  /**
+   * @brief Owns an object and serializes all the accesses to it.
+   * @tparam T type of the object
+   * @tparam Mutex type of mutex (with TBB-like `scoped_lock` interface)
+   *
+   * Components keeping state which is not safe for concurrent use (e.g. a
+   * "current event") can be protected by this adapter instead of forcing the
+   * whole job to a single schedule with `lar::EnsureOnlyOneSchedule`.
+   * Each access is granted through an `Access_t` object, which holds the lock
+   * for as long as it exists:
+   * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+   * lar::SerializedAccess<LegacyAlg> fAlg;
+   *
+   * // ...
+   * {
+   *   auto alg = fAlg.access(); // waits for other threads to be done
+   *   alg->setEvent(event);
+   *   result = alg->process();
+   * } // `alg` is destroyed here and access is released
+   *
+   * // or, equivalently:
+   * result = fAlg.apply
+   *   ([&event](LegacyAlg& alg){ alg.setEvent(event); return alg.process(); });
+   * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+   *
+   * With the default `tbb::queuing_mutex`, the access is granted in the order
+   * it was requested ("fair" queue).
+   *
+   * The adapter measures how long each access waited for the lock and how long
+   * it held it. These statistics (`statistics()`) tell whether the component
+   * is a bottleneck, and therefore whether it is worth making it thread-safe.
+   */
+  template <typename T, typename Mutex = tbb::queuing_mutex>
+  class SerializedAccess {
+
+      public:
+
+    using Object_t = T; ///< Type of the protected object.
+    using Mutex_t = Mutex; ///< Type of mutex.
+    using Clock_t = std::chrono::steady_clock; ///< Clock used for timing.
+    using Duration_t = Clock_t::duration; ///< Type of time intervals.
+
+
+    /// Contention statistics.
+    struct Statistics_t {
+
+      unsigned long long int nAccesses = 0U; ///< Number of accesses.
+      unsigned long long int nContended = 0U; ///< Accesses which had to wait.
+
+      Duration_t totalWait = Duration_t::zero(); ///< Total waiting time.
+      Duration_t maxWait = Duration_t::zero(); ///< Longest wait.
+      Duration_t totalHold = Duration_t::zero(); ///< Total time of access.
+      Duration_t maxHold = Duration_t::zero(); ///< Longest access.
+
+      /// Returns the average waiting time per access.
+      Duration_t averageWait() const
+        {
+          return nAccesses
+            ? (totalWait / Duration_t::rep(nAccesses)): Duration_t::zero();
+        }
+
+      /// Returns the average duration of an access.
+      Duration_t averageHold() const
+        {
+          return nAccesses
+            ? (totalHold / Duration_t::rep(nAccesses)): Duration_t::zero();
+        }
+
+      /// Prints the statistics into the `out` stream (no end of line).
+      template <typename Stream>
+      void dump(Stream&& out) const
+        {
+          using ms = std::chrono::duration<double, std::milli>;
+          out << nAccesses << " accesses (" << nContended << " had to wait)"
+            << "; wait: " << ms(totalWait).count() << " ms total, "
+            << ms(averageWait()).count() << " ms average, "
+            << ms(maxWait).count() << " ms max"
+            << "; access: " << ms(totalHold).count() << " ms total, "
+            << ms(averageHold()).count() << " ms average, "
+            << ms(maxHold).count() << " ms max";
+        } // dump()
+
+    }; // Statistics_t
+
+
+    /**
+     * @brief Exclusive access to the object, released on destruction.
+     *
+     * This object can't be copied nor moved.
+     */
+    class Access_t {
+
+        public:
+
+      /// Acquires the access to the object of `owner` (waiting if needed).
+      explicit Access_t(SerializedAccess& owner)
+        : fOwner(owner)
+        {
+          Clock_t::time_point const requested = Clock_t::now();
+          bool const contended = !fLock.try_acquire(fOwner.fMutex);
+          if (contended) fLock.acquire(fOwner.fMutex);
+          fAcquired = Clock_t::now();
+          fOwner.recordWait(fAcquired - requested, contended);
+        }
+
+      Access_t(Access_t const&) = delete;
+      Access_t& operator= (Access_t const&) = delete;
+
+      /// Records the duration of the access, and releases it.
+      ~Access_t() { fOwner.recordHold(Clock_t::now() - fAcquired); }
+
+      /// Access to the protected object.
+      Object_t& operator*() const { return fOwner.fObject; }
+
+      /// Access to the protected object.
+      Object_t* operator->() const { return &(fOwner.fObject); }
+
+        private:
+      SerializedAccess& fOwner; ///< The adapter owning the object.
+      typename Mutex_t::scoped_lock fLock; ///< Lock on the object.
+      Clock_t::time_point fAcquired; ///< When the access was acquired.
+
+    }; // class Access_t
+
+
+    /// Constructor: forwards all the arguments to the object constructor.
+    template <typename... Args>
+    explicit SerializedAccess(Args&&... args)
+      : fObject(std::forward<Args>(args)...)
+      {}
+
+    SerializedAccess(SerializedAccess const&) = delete;
+    SerializedAccess& operator= (SerializedAccess const&) = delete;
+
+
+    /// Returns the exclusive access to the object (waiting if needed).
+    Access_t access() { return Access_t{ *this }; }
+
+    /// Calls `f(object)` with exclusive access, and returns its result.
+    template <typename F>
+    decltype(auto) apply(F&& f)
+      {
+        Access_t const access { *this };
+        return std::forward<F>(f)(*access);
+      }
+
+    /// Returns a copy of the current contention statistics.
+    Statistics_t statistics() const
+      {
+        typename Mutex_t::scoped_lock const lock { fMutex };
+        return fStats;
+      }
+
+
+      private:
+
+    Object_t fObject; ///< The protected object.
+
+    mutable Mutex_t fMutex; ///< Serializes access to object and statistics.
+
+    Statistics_t fStats; ///< Contention statistics.
+
+
+    /// Records a wait for access (called with the lock held).
+    void recordWait(Duration_t wait, bool contended)
+      {
+        ++fStats.nAccesses;
+        if (contended) ++fStats.nContended;
+        fStats.totalWait += wait;
+        fStats.maxWait = std::max(fStats.maxWait, wait);
+      }
+
+    /// Records the duration of an access (called with the lock held).
+    void recordHold(Duration_t hold)
+      {
+        fStats.totalHold += hold;
+        fStats.maxHold = std::max(fStats.maxHold, hold);
+      }
+
+  }; // class SerializedAccess
+
+} // namespace lar
+
+
+#endif // LARCORE_COREUTILS_SERIALIZEDACCESS_H
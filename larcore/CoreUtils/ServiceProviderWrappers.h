@@ -8,6 +8,7 @@
  * The callers will need to link to:
  *
  * * `${ART_FRAMEWORK_SERVICES_REGISTRY}`
+ * * `${ART_UTILITIES}`
  *
  * It provides:
  *
@@ -15,6 +16,9 @@
  * * ServiceProviderImplementationWrapper: wrap a concrete implementation of a
  *   service provider interface supporting multiple implementations
  *
+ * Both wrappers keep one provider instance per art schedule instead of a
+ * single one if the provider is flagged by `lar::ProviderPerSchedule`.
+ *
  */
 
 #ifndef LARCORE_COREUTILS_SERVICEPROVIDERWRAPPERS_H
@@ -22,23 +26,179 @@
 
 
 // LArSoft libraries
-#include "larcore/CoreUtils/ServiceUtil.h" // lar::providerFrom() (for includers)
+#include "larcore/CoreUtils/ServiceUtil.h" // lar::invalidateCachedProviders()
 
 // framework and support libraries
 #include "art/Framework/Services/Registry/ServiceTable.h"
 #include "art/Framework/Services/Registry/ServiceMacros.h" // (for includers)
+#include "art/Framework/Services/Registry/ActivityRegistry.h"
+#include "art/Persistency/Provenance/ModuleContext.h"
+#include "art/Utilities/Globals.h"
+#include "art/Utilities/ScheduleID.h"
+#include "canvas/Utilities/Exception.h"
 
 // C/C++ standard libraries
 #include <memory> // std::unique_ptr<>
+#include <vector>
+#include <mutex> // std::call_once(), std::once_flag
+#include <cstddef> // std::size_t
 
 
 // forward declarations
-namespace art { class ActivityRegistry; }
 namespace fhicl { class ParameterSet; }
 
 
 namespace lar {
 
+   namespace details {
+
+      /**
+       * @brief Tracks the schedules the current thread is running modules for.
+       *
+       * Module execution is tracked through the `sPreModule` and
+       * `sPostModule` signals of the service wrappers with one provider per
+       * schedule.
+       * A thread waiting inside a module (e.g. in a TBB parallel algorithm)
+       * may run a module of another schedule meanwhile (task stealing): the
+       * schedules are kept in a stack, so that the schedule of the first
+       * module is back in place when the second one is done.
+       * Threads not running any module have no schedule.
+       */
+      class ScheduleTracker {
+
+            public:
+         /// Records that the current thread starts a module of schedule `sid`.
+         static void enter(art::ScheduleID sid)
+            { schedules().push_back(sid.id()); }
+
+         /// Records that the current thread is done with its latest module.
+         static void leave()
+            { if (!schedules().empty()) schedules().pop_back(); }
+
+         /// Returns whether the current thread is running a module.
+         static bool known() { return !schedules().empty(); }
+
+         /// Returns the schedule of the current module (requires `known()`).
+         static art::ScheduleID current()
+            { return art::ScheduleID(schedules().back()); }
+
+            private:
+         /// Schedule indices of the modules the thread is running, innermost
+         /// last.
+         static std::vector<std::size_t>& schedules()
+            {
+               thread_local std::vector<std::size_t> scheduleStack;
+               return scheduleStack;
+            }
+
+      }; // ScheduleTracker
+
+
+      /**
+       * @brief Owner of the provider(s) of a service wrapper.
+       * @tparam PROVIDER type of the service provider
+       * @tparam PerSchedule whether to keep one provider per schedule
+       *
+       * This version owns a single provider, created on construction.
+       */
+      template <typename PROVIDER, bool PerSchedule = false>
+      class ProviderStorage {
+
+            public:
+         using provider_type = PROVIDER;
+         using Config = typename provider_type::Config;
+
+         ProviderStorage(Config const& config, art::ActivityRegistry&)
+            : prov(std::make_unique<provider_type>(config))
+            {}
+
+         /// Returns the provider (there is only one).
+         provider_type const* get() const { return prov.get(); }
+
+         /// Returns the provider (the same for all schedules).
+         provider_type const* get(art::ScheduleID) const { return get(); }
+
+            private:
+         std::unique_ptr<provider_type> prov; ///< service provider
+
+      }; // ProviderStorage<>
+
+
+      /**
+       * @brief Owner of one provider for each art schedule.
+       *
+       * The provider for each schedule is created on the first request.
+       * `get()` returns the provider of the schedule whose module the calling
+       * thread is running, as tracked by `ScheduleTracker`.
+       * Threads not running an event module (e.g. during `beginJob()` or
+       * `beginRun()`, or worker threads spawned by a module) have no known
+       * schedule: `get()` throws an exception for them, unless the job has a
+       * single schedule, and they need to use `get(art::ScheduleID)`.
+       */
+      template <typename PROVIDER>
+      class ProviderStorage<PROVIDER, true> {
+
+            public:
+         using provider_type = PROVIDER;
+         using Config = typename provider_type::Config;
+
+         ProviderStorage(Config const& config, art::ActivityRegistry& reg)
+            : config(config)
+            , provs(art::Globals::instance()->nschedules())
+            {
+               reg.sPreModule.watch([](art::ModuleContext const& mc)
+                  { ScheduleTracker::enter(mc.scheduleID()); });
+               reg.sPostModule.watch([](art::ModuleContext const&)
+                  { ScheduleTracker::leave(); });
+            }
+
+         /**
+          * @brief Returns the provider for the schedule of the current thread.
+          * @throw art::Exception (`art::errors::LogicError`) if the thread
+          *        is not running a module and there are many schedules
+          */
+         provider_type const* get() const
+            {
+               if (provs.size() == 1U) return get(art::ScheduleID(0U));
+               if (!ScheduleTracker::known()) {
+                  throw art::Exception(art::errors::LogicError)
+                     << "The provider of " << provs.size()
+                     << " schedules was requested outside of an event module"
+                     " (or from a thread not running the module):"
+                     " the schedule must be specified explicitly"
+                     " (e.g. via scheduleProvider()).\n";
+               }
+               return get(ScheduleTracker::current());
+            }
+
+         /// Returns the provider for the schedule `sid`, creating it if needed.
+         provider_type const* get(art::ScheduleID sid) const
+            {
+               ScheduleProvider_t& entry = provs.at(sid.id());
+               std::call_once(entry.created,
+                  [this, &entry](){
+                     entry.prov = std::make_unique<provider_type>(config);
+                  });
+               return entry.prov.get();
+            }
+
+            private:
+         /// The provider of a schedule, and the flag of its creation.
+         struct ScheduleProvider_t {
+            std::once_flag created;
+            std::unique_ptr<provider_type> prov;
+         }; // ScheduleProvider_t
+
+         Config const config; ///< Configuration for the new providers.
+
+         /// Providers, by schedule number.
+         mutable std::vector<ScheduleProvider_t> provs;
+
+      }; // ProviderStorage<PROVIDER, true>
+
+   } // namespace details
+
+
    /** **********************************************************************
     * @brief Service returning a provider
     * @tparam PROVIDER type of service provider to be returned
@@ -77,7 +237,17 @@ namespace lar {
     *   `lar::providerFrom()`)
     * - a `Parameters` definition (used by art to print accepted configuration)
     * - a constructor supporting FHiCL configuration validation
-    * - transparent life management of the provider instance
+    * - transparent life management of the provider instance, including the
+    *   invalidation of the providers cached by `lar::cachedProviderFrom()`
+    *
+    * If `lar::ProviderPerSchedule<PROVIDER>` is true, the service keeps a
+    * separate provider for each art schedule, created when first requested,
+    * and `provider()` returns the one of the schedule the calling module runs
+    * on. This allows providers with mutable scratch state to be used by jobs
+    * with many schedules. The provider of a specific schedule is returned by
+    * `scheduleProvider()`, which is required outside of event modules and in
+    * threads started by a module: there, `provider()` throws an exception if
+    * the job has more than one schedule.
     *
     * Requirements on the service provider:
     * - a data type `Config` being the configuration object. This is the object
@@ -98,18 +268,28 @@ namespace lar {
 
       /// Constructor (using a configuration table)
       SimpleServiceProviderWrapper
-         (Parameters const& config, art::ActivityRegistry&)
-         : prov(std::make_unique<provider_type>(config()))
-         {}
+         (Parameters const& config, art::ActivityRegistry& reg)
+         : prov(config(), reg)
+         { lar::invalidateCachedProviders(); }
+
+      /// Destructor: providers cached by `lar::cachedProviderFrom()` are stale
+      ~SimpleServiceProviderWrapper() { lar::invalidateCachedProviders(); }
 
 
       /// Returns a constant pointer to the service provider
       provider_type const* provider() const { return prov.get(); }
 
+      /// Returns a constant pointer to the provider for schedule `sid`
+      provider_type const* scheduleProvider(art::ScheduleID sid) const
+         { return prov.get(sid); }
+
 
          private:
 
-      std::unique_ptr<provider_type> prov; ///< service provider
+      /// service provider(s)
+      details::ProviderStorage
+         <provider_type, lar::providerPerSchedule_v<provider_type>>
+         prov;
 
    }; // SimpleServiceProviderWrapper<>
 
@@ -221,6 +401,12 @@ namespace lar {
     * * a `concrete_provider_type` definition (that is PROVIDER)
     * * a `service_interface_type` definition (that is INTERFACE)
     *
+    * As for `SimpleServiceProviderWrapper`, flagging PROVIDER with
+    * `lar::ProviderPerSchedule` yields one provider per art schedule. In that
+    * case, the provider interface (`INTERFACE::provider_type`) must be flagged
+    * too, so that `lar::cachedProviderFrom()` does not cache the provider of
+    * a single schedule for all of them.
+    *
     * Requirements on the service provider (PROVIDER):
     * - a data type `Config` being the configuration object. This is the object
     *   wrapped by `fhicl::Table` when performing FHiCL validation.
@@ -252,15 +438,36 @@ namespace lar {
         = art::ServiceTable<typename concrete_provider_type::Config>;
 
 
+      static_assert(
+        !lar::providerPerSchedule_v<concrete_provider_type>
+          || lar::providerPerSchedule_v<provider_type>,
+        "The interface of a provider with an instance per schedule"
+        " must be flagged by lar::ProviderPerSchedule too"
+        );
+
+
       /// Constructor (using a configuration table)
       ServiceProviderImplementationWrapper
-         (Parameters const& config, art::ActivityRegistry&)
-         : prov(std::make_unique<concrete_provider_type>(config()))
-         {}
+         (Parameters const& config, art::ActivityRegistry& reg)
+         : prov(config(), reg)
+         { lar::invalidateCachedProviders(); }
+
+      /// Destructor: providers cached by `lar::cachedProviderFrom()` are stale
+      ~ServiceProviderImplementationWrapper()
+         { lar::invalidateCachedProviders(); }
+
+      /// Returns a constant pointer to the provider for schedule `sid`
+      concrete_provider_type const* scheduleProvider(art::ScheduleID sid) const
+         { return prov.get(sid); }
 
 
          private:
-      std::unique_ptr<concrete_provider_type> prov; ///< service provider
+      /// service provider(s)
+      details::ProviderStorage<
+         concrete_provider_type,
+         lar::providerPerSchedule_v<concrete_provider_type>
+         >
+         prov;
 
       /// Returns a constant pointer to the service provider
       virtual provider_type const* do_provider() const override
@@ -13,6 +13,12 @@
  *   services
  * - lar::providersFrom_t, a type defined as a provider pack with the providers
  *   from all the specified services
+ * - lar::cachedProviderFrom(), like lar::providerFrom() but resolving the
+ *   provider only once until lar::invalidateCachedProviders() is called
+ * - lar::cachedProvidersFrom(), like lar::providersFrom() but with the
+ *   providers from lar::cachedProviderFrom()
+ * - lar::ProviderPerSchedule, a trait flagging providers with one instance
+ *   per art schedule
  *
  */
 
@@ -31,6 +37,8 @@
 // C/C++ standard libraries
 #include <type_traits> // std::decay<>, std::is_same<>, std::add_const_t<>
 #include <typeinfo>
+#include <atomic>
+#include <mutex>
 
 
 namespace lar {
@@ -42,9 +50,40 @@ namespace lar {
     template <typename... Services>
     struct ProviderPackExtractor;
 
+    template <typename Service>
+    struct CachedProviderSlot;
+
+    /// Generation of the cached providers; `0` is never a valid generation.
+    inline std::atomic<unsigned int> CachedProvidersGeneration { 1U };
+
   } // namespace details
 
 
+  /** **************************************************************************
+   * @brief Trait: whether the service keeps a `PROVIDER` for each schedule.
+   * @tparam PROVIDER type of service provider
+   * @see lar::SimpleServiceProviderWrapper
+   *
+   * Providers with mutable state (e.g. scratch buffers) can't be shared by
+   * events processed concurrently. Specializing this trait as
+   * `std::true_type` makes the service wrappers in `ServiceProviderWrappers.h`
+   * create one provider instance per art schedule:
+   *
+   *     template <>
+   *     struct lar::ProviderPerSchedule<myprov::MyProvider>: std::true_type {};
+   *
+   * The specialization must be visible wherever the service is declared.
+   * The providers of such services are never cached by
+   * `lar::cachedProviderFrom()`.
+   */
+  template <typename PROVIDER>
+  struct ProviderPerSchedule: std::false_type {};
+
+  /// Value of `lar::ProviderPerSchedule` for `PROVIDER`.
+  template <typename PROVIDER>
+  constexpr bool providerPerSchedule_v = ProviderPerSchedule<PROVIDER>::value;
+
+
   /** **************************************************************************
    * @brief Returns a constant pointer to the provider of specified service.
    * @tparam T type of the service
@@ -95,15 +134,88 @@ namespace lar {
     } // providerFrom()
 
 
+  /** **************************************************************************
+   * @brief Marks all the providers cached by `lar::cachedProviderFrom()` stale.
+   *
+   * The next call to `lar::cachedProviderFrom()` for any service will resolve
+   * the provider again via `lar::providerFrom()`.
+   *
+   * It is the service which creates, replaces or destroys a provider that
+   * must call this function, right after the change: the callers of
+   * `lar::cachedProviderFrom()` can't know when that happens. The service
+   * wrappers in `ServiceProviderWrappers.h` do it on construction and
+   * destruction, and `geo::Geometry` on construction and at the end of the
+   * job. Services handing out their own providers must do the same, or their
+   * providers must be accessed via `lar::providerFrom()` only.
+   */
+  inline void invalidateCachedProviders() noexcept
+    {
+      details::CachedProvidersGeneration.fetch_add
+        (1U, std::memory_order_acq_rel);
+    }
+
+  /// Returns the current generation of the cached providers.
+  inline unsigned int cachedProvidersGeneration() noexcept
+    {
+      return
+        details::CachedProvidersGeneration.load(std::memory_order_acquire);
+    }
+
+
+  /** **************************************************************************
+   * @brief Returns a constant pointer to the provider of specified service.
+   * @tparam T type of the service
+   * @return a constant pointer to the provider of specified service
+   * @throws art::Exception as lar::providerFrom()
+   * @see lar::providerFrom(), lar::invalidateCachedProviders()
+   *
+   * The provider is resolved with `lar::providerFrom()` on the first call, and
+   * the result is kept in a slot (one per service type, shared by all threads)
+   * until `lar::invalidateCachedProviders()` is called. In the meanwhile, the
+   * retrieval of the provider costs a few atomic loads, and no access to the
+   * art service registry.
+   * Null providers are not cached (and the call throws every time).
+   *
+   * This is suitable for code asking for the provider very often (e.g. once
+   * per event or per hit):
+   *
+   *     auto const* geom = lar::cachedProviderFrom<geo::Geometry>();
+   *
+   * Concurrent calls are safe. Threads finding a stale slot resolve the
+   * provider again, one at a time.
+   *
+   * @note The cache is correct only if the service replacing its provider
+   *       calls `lar::invalidateCachedProviders()` (see there): until then,
+   *       the previous provider keeps being returned.
+   *
+   * Providers flagged by `lar::ProviderPerSchedule` depend on the schedule of
+   * the caller, and they are always resolved via `lar::providerFrom()`.
+   */
+  template <typename T>
+  typename T::provider_type const* cachedProviderFrom()
+    {
+      using Service_t = std::add_const_t<T>;
+      if constexpr
+        (providerPerSchedule_v<typename Service_t::provider_type>)
+      {
+        return lar::providerFrom<Service_t>();
+      }
+      else {
+        static details::CachedProviderSlot<Service_t> slot;
+        return slot.get();
+      }
+    } // cachedProviderFrom()
+
+
   /** **************************************************************************
    * @brief Returns a lar::ProviderPack with providers from all services
    * @tparam Services a list of service types
    * @return a lar::ProviderPack with providers from all specified services
    * @throws art::Exception as lar::providerFrom()
-   * @see lar::providerFrom()
+   * @see lar::cachedProvidersFrom()
    *
-   * This function relies on `lar::providerFrom()` to extract providers from
-   * all the specified services.
+   * This function relies on lar::providerFrom() to extract providers from all
+   * the specified services.
    * The parameter pack stores the providers in the same order as the services
    * were specified, but this is not very relevant since provider packs can
    * be implicitly converted in other provider packs with the same providers
@@ -127,6 +239,24 @@ namespace lar {
     { return details::ProviderPackExtractor<Services...>::parameterPack(); }
 
 
+  /** **************************************************************************
+   * @brief Returns a lar::ProviderPack with providers from all services
+   * @tparam Services a list of service types
+   * @return a lar::ProviderPack with providers from all specified services
+   * @throws art::Exception as lar::providerFrom()
+   * @see lar::providersFrom(), lar::invalidateCachedProviders()
+   *
+   * This is the same as `lar::providersFrom()`, but each provider is
+   * extracted by `lar::cachedProviderFrom()`, with the same requirements.
+   */
+  template <typename... Services>
+  auto cachedProvidersFrom()
+    {
+      return
+        details::ProviderPackExtractor<Services...>::cachedParameterPack();
+    }
+
+
   /** **************************************************************************
    * @brief Type of a provider pack with a provider from each of the Services
    * @tparam Services the list of services to extract the provider type of
@@ -206,6 +336,17 @@ namespace lar {
             lar::providerFrom<First>()
             };
         }
+
+      static ProviderPack<
+        typename First::provider_type, typename Others::provider_type...
+        >
+        cachedParameterPack()
+        {
+          return {
+            ProviderPackExtractor<Others...>::cachedParameterPack(),
+            lar::cachedProviderFrom<First>()
+            };
+        }
     };
 
 
@@ -213,9 +354,67 @@ namespace lar {
     struct ProviderPackExtractor<Service> {
        static auto parameterPack()
           { return lar::makeProviderPack(lar::providerFrom<Service>()); }
+
+       static auto cachedParameterPack()
+          { return lar::makeProviderPack(lar::cachedProviderFrom<Service>()); }
     };
 
 
+    //--------------------------------------------------------------------------
+    /**
+     * @brief Cached provider of `Service`, tagged with its generation.
+     *
+     * Readers check the generation of the slot before and after reading the
+     * provider pointer (as in a "sequence lock"), and they go through the slow
+     * path if the generation is stale or changed while reading.
+     * The slow path resolves the provider under a mutex, and while updating
+     * the slot it marks it invalid (generation `0`).
+     */
+    template <typename Service>
+    struct CachedProviderSlot {
+
+      using provider_type = typename Service::provider_type;
+
+      /// Returns the cached provider, resolving it if stale.
+      provider_type const* get()
+        {
+          unsigned int const gen = fGeneration.load(std::memory_order_acquire);
+          if (gen == lar::cachedProvidersGeneration()) {
+            provider_type const* const provider
+              = fProvider.load(std::memory_order_acquire);
+            if (fGeneration.load(std::memory_order_acquire) == gen)
+              return provider;
+          }
+          return resolve();
+        } // get()
+
+        private:
+      std::mutex fResolveMutex; ///< Serializes the resolution of the provider.
+      std::atomic<provider_type const*> fProvider { nullptr }; ///< Provider.
+      std::atomic<unsigned int> fGeneration { 0U }; ///< Generation of provider.
+
+      /// Resolves the provider via `lar::providerFrom()` and caches it.
+      provider_type const* resolve()
+        {
+          std::lock_guard<std::mutex> const lock { fResolveMutex };
+
+          // if a generation changes during resolution, the result is stale
+          // and it will be resolved again on the next call
+          unsigned int const gen = lar::cachedProvidersGeneration();
+          if (fGeneration.load(std::memory_order_acquire) == gen)
+            return fProvider.load(std::memory_order_acquire);
+
+          provider_type const* const provider = lar::providerFrom<Service>();
+
+          fGeneration.store(0U, std::memory_order_release);
+          fProvider.store(provider, std::memory_order_release);
+          fGeneration.store(gen, std::memory_order_release);
+          return provider;
+        } // resolve()
+
+    }; // CachedProviderSlot
+
+
   } // namespace details
 
 } // namespace lar
@@ -0,0 +1,163 @@
+/**
+ * @file   SnapshotHolder.h
+ * @brief  Publication of immutable snapshots of data shared among threads
+ *
+ * This library is currently a pure header.
+ * It provides:
+ *
+ * - lar::SnapshotHolder, holding the current snapshot of some data and
+ *   replacing it atomically with a new one
+ *
+ */
+
+#ifndef LARCORE_COREUTILS_SNAPSHOTHOLDER_H
+#define LARCORE_COREUTILS_SNAPSHOTHOLDER_H
+
+// C/C++ standard libraries
+#include <memory> // std::shared_ptr<>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <cstddef> // std::size_t
+
+
+namespace lar {
+
+  /**
+   * @brief Holds the current immutable snapshot of some data.
+   * @tparam T type of the data in the snapshot
+   *
+   * Readers and writers of the data never share a mutable object: each writer
+   * prepares a complete new snapshot and then publishes it, replacing the
+   * current one atomically ("read-copy-update"). Readers see either the old
+   * or the new snapshot, never a partially updated one, and they are never
+   * blocked by a writer preparing the next snapshot.
+   *
+   * There are two ways to read the data:
+   *
+   * * `snapshot()` returns a shared pointer to the current snapshot, which
+   *   stays valid for as long as the reader holds it, even if a newer
+   *   snapshot is published in the meanwhile; it is an atomic load of a
+   *   shared pointer, which does not wait for writers;
+   * * `current()` returns a plain pointer to the current snapshot, and it
+   *   costs just an atomic load; snapshots replaced by newer ones are kept
+   *   alive ("retired") until the next call to `releaseRetired()`, which
+   *   must happen only when no reader can be holding such pointers (for
+   *   example, between runs, or at the end of the job).
+   *
+   * Example:
+   * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+   * lar::SnapshotHolder<Tables> tables;
+   *
+   * // writer:
+   * auto newTables = std::make_shared<Tables>();
+   * newTables->fill(geom);
+   * tables.publish(std::move(newTables));
+   *
+   * // reader keeping the tables through a possible update:
+   * std::shared_ptr<Tables const> const myTables = tables.snapshot();
+   * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+   *
+   * All methods are thread-safe. Publishing and releasing are serialized by
+   * a mutex, which the reading methods never take.
+   */
+  template <typename T>
+  class SnapshotHolder {
+
+      public:
+
+    /// Type of pointer to a snapshot, keeping it alive.
+    using Snapshot_t = std::shared_ptr<T const>;
+
+
+    /// Constructor: no snapshot published yet.
+    SnapshotHolder() = default;
+
+    /// Constructor: publishes the `initial` snapshot.
+    explicit SnapshotHolder(Snapshot_t initial)
+      { publish(std::move(initial)); }
+
+
+    /// Returns the current snapshot (null if none was published).
+    Snapshot_t snapshot() const
+      { return std::atomic_load_explicit(&fLatest, std::memory_order_acquire); }
+
+    /// Returns a pointer to the current snapshot (`nullptr` if none).
+    /// @see `releaseRetired()`
+    T const* current() const noexcept
+      { return fCurrent.load(std::memory_order_acquire); }
+
+    /// Returns whether a snapshot was ever published.
+    bool hasSnapshot() const noexcept { return current() != nullptr; }
+
+    /// Returns the number of snapshots published so far.
+    unsigned int generation() const noexcept
+      { return fGeneration.load(std::memory_order_acquire); }
+
+
+    /**
+     * @brief Makes `newSnapshot` the current snapshot.
+     * @param newSnapshot the snapshot to be published
+     * @return the snapshot which was current until now
+     *
+     * The previous snapshot is retired but kept alive until
+     * `releaseRetired()` is called.
+     */
+    Snapshot_t publish(Snapshot_t newSnapshot)
+      {
+        std::lock_guard<std::mutex> const lock { fMutex };
+        Snapshot_t previous
+          = fSnapshots.empty()? Snapshot_t{}: fSnapshots.back();
+        fSnapshots.push_back(std::move(newSnapshot));
+        std::atomic_store_explicit
+          (&fLatest, fSnapshots.back(), std::memory_order_release);
+        fCurrent.store(fSnapshots.back().get(), std::memory_order_release);
+        fGeneration.fetch_add(1U, std::memory_order_acq_rel);
+        return previous;
+      }
+
+    /**
+     * @brief Drops the references to all the retired snapshots.
+     * @return the number of retired snapshots released
+     *
+     * Retired snapshots still held by `snapshot()` readers stay alive until
+     * these release them; pointers from `current()` to retired snapshots
+     * become invalid.
+     */
+    std::size_t releaseRetired()
+      {
+        std::lock_guard<std::mutex> const lock { fMutex };
+        if (fSnapshots.size() <= 1U) return 0U;
+        std::size_t const nReleased = fSnapshots.size() - 1U;
+        fSnapshots.erase(fSnapshots.begin(), fSnapshots.end() - 1);
+        return nReleased;
+      }
+
+    /// Returns the number of retired snapshots still kept alive.
+    std::size_t nRetired() const
+      {
+        std::lock_guard<std::mutex> const lock { fMutex };
+        return fSnapshots.empty()? 0U: fSnapshots.size() - 1U;
+      }
+
+
+      private:
+
+    mutable std::mutex fMutex; ///< Serializes changes to `fSnapshots`.
+
+    /// All snapshots not released yet; the last one is the current.
+    std::vector<Snapshot_t> fSnapshots;
+
+    /// Current snapshot, only accessed via `std::atomic_load()`/`store()`.
+    Snapshot_t fLatest;
+
+    std::atomic<T const*> fCurrent { nullptr }; ///< Current snapshot.
+
+    std::atomic<unsigned int> fGeneration { 0U }; ///< Snapshots published.
+
+  }; // class SnapshotHolder
+
+} // namespace lar
+
+
+#endif // LARCORE_COREUTILS_SNAPSHOTHOLDER_H
@@ -0,0 +1,554 @@
+/**
+ * @file   larcore/Geometry/AuxDetChannelIndex.h
+ * @brief  Dense channel tables and spatial index of the auxiliary detectors.
+ * @see    larcore/Geometry/AuxDetGeometry.h
+ *
+ * This library is header-only.
+ */
+
+#ifndef LARCORE_GEOMETRY_AUXDETCHANNELINDEX_H
+#define LARCORE_GEOMETRY_AUXDETCHANNELINDEX_H
+
+// LArSoft libraries
+#include "larcore/Geometry/TPCPositionIndex.h" // geo::BoxGridIndex
+#include "larcorealg/Geometry/AuxDetGeometryCore.h"
+#include "larcorealg/Geometry/AuxDetGeo.h"
+#include "larcorealg/Geometry/AuxDetSensitiveGeo.h"
+#include "larcorealg/Geometry/BoxBoundedGeo.h"
+#include "larcorealg/CoreUtils/span.h"
+#include "larcoreobj/SimpleTypesAndConstants/geo_vectors.h" // geo::Point_t
+
+// framework libraries
+#include "cetlib_except/exception.h"
+
+// ROOT libraries
+#include "TVector3.h"
+
+// C/C++ standard libraries
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <algorithm> // std::min(), std::max(), std::transform()
+#include <limits>
+#include <cstdint> // std::uint32_t
+#include <cstddef> // std::size_t
+
+
+namespace geo {
+
+  /**
+   * @brief Fast lookup of auxiliary detector channels and positions.
+   *
+   * The index is built from a completely initialized
+   * `geo::AuxDetGeometryCore` (geometry and channel mapping), and it provides:
+   *
+   * * the index of an auxiliary detector from its name (hash table);
+   * * for each auxiliary detector, a dense table of its channels, with the
+   *   sensitive volume each channel belongs to and the position of the
+   *   channel (as `AuxDetChannelToPosition()`);
+   * * the auxiliary detector and the sensitive volume containing a point,
+   *   found through uniform grids (`geo::BoxGridIndex`) instead of scanning
+   *   all the volumes.
+   *
+   * Each query has a batched version, filling the answers for many channels
+   * or points at once.
+   *
+   * Channels not served by the channel mapping are reported with invalid
+   * indices (`NoIndex`), without throwing.
+   *
+   * @note The channel mapping interface (`geo::AuxDetChannelMapAlg`) can't
+   *       list the channels of an auxiliary detector, so the channel tables
+   *       are sized by assumption: for each auxiliary detector, they cover
+   *       the channels from `0` to twice the number of its sensitive volumes
+   *       (excluded). The index is fast only for channel mappings which
+   *       number the channels of each detector from `0`, with at most two
+   *       channels per sensitive volume. Channels beyond the table are still
+   *       answered correctly, but each query is then a channel mapping query,
+   *       with its cost.
+   *
+   * A point is contained in an auxiliary detector or sensitive volume if it
+   * is inside its trapezoid, extended by the `tolerance` given at
+   * construction, which is the criterion of
+   * `geo::AuxDetChannelMapAlg::NearestAuxDet()`; as there, the first volume
+   * containing the point is chosen, and sensitive volumes are looked for only
+   * in the first auxiliary detector containing the point.
+   *
+   * The index points to the geometry objects it was built from, and it must
+   * be rebuilt when they change. Queries can be performed concurrently.
+   */
+  class AuxDetChannelIndex {
+
+      public:
+
+    /// Type of auxiliary detector channel number.
+    using Channel_t = std::uint32_t;
+
+    /// Value of an invalid auxiliary detector or sensitive volume index.
+    static constexpr std::size_t NoIndex = std::numeric_limits<std::size_t>::max();
+
+    /// Indices of a sensitive volume: auxiliary detector and volume in it.
+    struct SensitiveID_t {
+      std::size_t auxDet = NoIndex; ///< Index of the auxiliary detector.
+      std::size_t sensitive = NoIndex; ///< Index of the sensitive volume.
+
+      /// Returns whether this identifies a sensitive volume.
+      bool isValid() const
+        { return (auxDet != NoIndex) && (sensitive != NoIndex); }
+    }; // SensitiveID_t
+
+
+    /// Constructor: an empty index.
+    AuxDetChannelIndex() = default;
+
+    /**
+     * @brief Constructor: indexes the auxiliary detectors in `geom`.
+     * @param geom the geometry to be indexed, with its channel mapping
+     * @param tolerance tolerance of the position queries [cm]
+     */
+    explicit AuxDetChannelIndex
+      (geo::AuxDetGeometryCore const& geom, double tolerance = 0.0);
+
+
+    // --- BEGIN -- Auxiliary detectors ----------------------------------------
+    /// Returns the number of indexed auxiliary detectors.
+    std::size_t nAuxDets() const { return fAuxDets.size(); }
+
+    /// Returns the index of the auxiliary detector `name` (`NoIndex` if none).
+    std::size_t auxDetIndex(std::string const& name) const
+      {
+        auto const iAuxDet = fNameToAuxDet.find(name);
+        return (iAuxDet == fNameToAuxDet.end())? NoIndex: iAuxDet->second;
+      }
+
+    /// Returns the auxiliary detector number `ad` (`nullptr` if none).
+    geo::AuxDetGeo const* auxDet(std::size_t ad) const
+      { return (ad < fAuxDets.size())? fAuxDets[ad].geo: nullptr; }
+
+    /// Returns the sensitive volume `sv` (`nullptr` if none).
+    geo::AuxDetSensitiveGeo const* sensitive(SensitiveID_t const& sv) const
+      {
+        geo::AuxDetGeo const* const ad = auxDet(sv.auxDet);
+        return (ad && (sv.sensitive < ad->NSensitiveVolume()))
+          ? &(ad->SensitiveVolume(sv.sensitive)): nullptr;
+      }
+    // --- END -- Auxiliary detectors ------------------------------------------
+
+
+    // --- BEGIN -- Channel queries --------------------------------------------
+    /// Returns the sensitive volume of `channel` of auxiliary detector `ad`.
+    SensitiveID_t channelToSensitive(std::size_t ad, Channel_t channel) const
+      {
+        ChannelEntry_t const* const entry = channelEntry(ad, channel);
+        if (entry) return { ad, entry->sensitive };
+        return { ad, fallbackSensitive(ad, channel) };
+      }
+
+    /**
+     * @brief Returns the position of `channel` of auxiliary detector `ad`.
+     * @param ad index of the auxiliary detector
+     * @param channel the channel to be queried
+     * @param valid (output) whether the channel is valid
+     * @return the position of the channel (undefined if not `valid`)
+     *
+     * The position is the one from
+     * `geo::AuxDetGeometryCore::AuxDetChannelToPosition()`.
+     */
+    geo::Point_t channelPosition
+      (std::size_t ad, Channel_t channel, bool& valid) const;
+
+    /**
+     * @brief Fills the sensitive volumes of the specified channels.
+     * @param ad index of the auxiliary detector of all the channels
+     * @param channels the channels to be queried
+     * @param sensitives (output) the sensitive volume of each channel
+     * @throw cet::exception (category: `"AuxDetChannelIndex"`) if
+     *        `sensitives` is shorter than `channels`
+     */
+    void channelsToSensitive(
+      std::size_t ad, util::span<Channel_t const*> channels,
+      util::span<SensitiveID_t*> sensitives
+      ) const;
+
+    /**
+     * @brief Fills the positions of the specified channels.
+     * @param ad index of the auxiliary detector of all the channels
+     * @param channels the channels to be queried
+     * @param positions (output) the position of each channel
+     * @return the number of channels which were not valid
+     * @throw cet::exception (category: `"AuxDetChannelIndex"`) if
+     *        `positions` is shorter than `channels`
+     *
+     * The positions of channels which are not valid are undefined.
+     */
+    std::size_t channelPositions(
+      std::size_t ad, util::span<Channel_t const*> channels,
+      util::span<geo::Point_t*> positions
+      ) const;
+    // --- END -- Channel queries ----------------------------------------------
+
+
+    // --- BEGIN -- Position queries -------------------------------------------
+    /// Returns the index of the auxiliary detector containing `point`.
+    std::size_t auxDetAt(geo::Point_t const& point) const;
+
+    /// Returns the sensitive volume containing `point`.
+    SensitiveID_t sensitiveAt(geo::Point_t const& point) const;
+
+    /**
+     * @brief Fills the auxiliary detectors containing the specified points.
+     * @param points the points to be located
+     * @param auxDets (output) index of the auxiliary detector of each point
+     * @throw cet::exception (category: `"AuxDetChannelIndex"`) if `auxDets`
+     *        is shorter than `points`
+     */
+    void auxDetsAt(
+      util::span<geo::Point_t const*> points,
+      util::span<std::size_t*> auxDets
+      ) const;
+
+    /**
+     * @brief Fills the sensitive volumes containing the specified points.
+     * @param points the points to be located
+     * @param sensitives (output) the sensitive volume of each point
+     * @throw cet::exception (category: `"AuxDetChannelIndex"`) if
+     *        `sensitives` is shorter than `points`
+     */
+    void sensitivesAt(
+      util::span<geo::Point_t const*> points,
+      util::span<SensitiveID_t*> sensitives
+      ) const;
+    // --- END -- Position queries ---------------------------------------------
+
+
+      private:
+
+    /// Information about a channel in the dense tables.
+    struct ChannelEntry_t {
+      std::size_t sensitive = NoIndex; ///< Sensitive volume (`NoIndex`: none).
+      geo::Point_t position; ///< Position of the channel.
+    }; // ChannelEntry_t
+
+    /// Information about an auxiliary detector.
+    struct AuxDetEntry_t {
+      geo::AuxDetGeo const* geo = nullptr; ///< Geometry of the detector.
+      std::vector<ChannelEntry_t> channels; ///< Channels `0` to `size() - 1`.
+    }; // AuxDetEntry_t
+
+    /// The geometry being indexed (for the channels beyond the tables).
+    geo::AuxDetGeometryCore const* fGeom = nullptr;
+
+    double fTolerance = 0.0; ///< Tolerance of the position queries [cm].
+
+    std::vector<AuxDetEntry_t> fAuxDets; ///< All auxiliary detectors.
+
+    /// Index of each auxiliary detector by name.
+    std::unordered_map<std::string, std::size_t> fNameToAuxDet;
+
+    /// All sensitive volumes, in the order of the spatial index.
+    std::vector<SensitiveID_t> fSensitives;
+
+    geo::BoxGridIndex fAuxDetGrid; ///< Spatial index of auxiliary detectors.
+    geo::BoxGridIndex fSensitiveGrid; ///< Spatial index of sensitive volumes.
+
+
+    /// Returns the table entry of a valid channel (`nullptr` if not there).
+    ChannelEntry_t const* channelEntry(std::size_t ad, Channel_t channel) const
+      {
+        if (ad >= fAuxDets.size()) return nullptr;
+        std::vector<ChannelEntry_t> const& channels = fAuxDets[ad].channels;
+        return ((channel < channels.size())
+          && (channels[channel].sensitive != NoIndex))
+          ? &(channels[channel]): nullptr;
+      }
+
+    /// Returns the sensitive volume of a channel from the channel mapping.
+    std::size_t fallbackSensitive(std::size_t ad, Channel_t channel) const;
+
+    /// Returns the index of `sensitive` in the auxiliary detector `ad`.
+    static std::size_t sensitiveIndex
+      (geo::AuxDetGeo const& ad, geo::AuxDetSensitiveGeo const& sensitive);
+
+    /// Returns whether `point` is in `volume` (with `tolerance`).
+    template <typename Volume>
+    static bool contains
+      (Volume const& volume, geo::Point_t const& point, double tolerance);
+
+    /// Returns the box containing `volume`, enlarged by `tolerance`.
+    template <typename Volume>
+    static geo::BoxBoundedGeo boundingBox
+      (Volume const& volume, double tolerance);
+
+    /// Throws if `output` is shorter than `input`.
+    static void checkOutputSize
+      (std::size_t input, std::size_t output, const char* caller);
+
+  }; // class AuxDetChannelIndex
+
+
+} // namespace geo
+
+
+//------------------------------------------------------------------------------
+//--- inline implementation
+//------------------------------------------------------------------------------
+inline geo::AuxDetChannelIndex::AuxDetChannelIndex
+  (geo::AuxDetGeometryCore const& geom, double tolerance /* = 0.0 */)
+  : fGeom(&geom)
+  , fTolerance(tolerance)
+{
+  std::vector<geo::BoxBoundedGeo> auxDetBoxes, sensitiveBoxes;
+
+  std::size_t const nAuxDets = geom.NAuxDets();
+  fAuxDets.resize(nAuxDets);
+  auxDetBoxes.reserve(nAuxDets);
+  for (std::size_t ad = 0; ad < nAuxDets; ++ad) {
+    geo::AuxDetGeo const& auxDet = geom.AuxDet(ad);
+    AuxDetEntry_t& entry = fAuxDets[ad];
+    entry.geo = &auxDet;
+    std::string const name = auxDet.Name();
+    fNameToAuxDet.emplace(name, ad);
+    auxDetBoxes.push_back(boundingBox(auxDet, fTolerance));
+
+    std::size_t const nSensitive = auxDet.NSensitiveVolume();
+    for (std::size_t sv = 0; sv < nSensitive; ++sv) {
+      fSensitives.push_back({ ad, sv });
+      sensitiveBoxes.push_back
+        (boundingBox(auxDet.SensitiveVolume(sv), fTolerance));
+    } // for sensitive volumes
+
+    // the channel mapping reports invalid channels by throwing;
+    // the size of the table is an assumption (see the class documentation)
+    entry.channels.resize(2U * nSensitive);
+    for (Channel_t channel = 0; channel < entry.channels.size(); ++channel) {
+      ChannelEntry_t& channelEntry = entry.channels[channel];
+      try {
+        channelEntry.sensitive = sensitiveIndex
+          (auxDet, geom.ChannelToAuxDetSensitive(name, channel));
+        if (channelEntry.sensitive == NoIndex) continue;
+        TVector3 const pos = geom.AuxDetChannelToPosition(channel, name);
+        channelEntry.position = { pos.X(), pos.Y(), pos.Z() };
+      }
+      catch (cet::exception const&) {
+        channelEntry.sensitive = NoIndex;
+      }
+    } // for channels
+
+  } // for auxiliary detectors
+
+  auto const pointers = [](std::vector<geo::BoxBoundedGeo> const& boxes)
+    {
+      std::vector<geo::BoxBoundedGeo const*> ptrs;
+      ptrs.reserve(boxes.size());
+      for (geo::BoxBoundedGeo const& box: boxes) ptrs.push_back(&box);
+      return ptrs;
+    };
+  // the tolerance is already in the boxes
+  fAuxDetGrid = geo::BoxGridIndex{ pointers(auxDetBoxes), 1.0 };
+  fSensitiveGrid = geo::BoxGridIndex{ pointers(sensitiveBoxes), 1.0 };
+
+} // geo::AuxDetChannelIndex::AuxDetChannelIndex()
+
+
+//------------------------------------------------------------------------------
+inline geo::Point_t geo::AuxDetChannelIndex::channelPosition
+  (std::size_t ad, Channel_t channel, bool& valid) const
+{
+  ChannelEntry_t const* const entry = channelEntry(ad, channel);
+  if (entry) {
+    valid = true;
+    return entry->position;
+  }
+
+  valid = false;
+  if (fallbackSensitive(ad, channel) == NoIndex) return {};
+  try {
+    TVector3 const pos
+      = fGeom->AuxDetChannelToPosition(channel, fAuxDets[ad].geo->Name());
+    valid = true;
+    return { pos.X(), pos.Y(), pos.Z() };
+  }
+  catch (cet::exception const&) { return {}; }
+
+} // geo::AuxDetChannelIndex::channelPosition()
+
+
+//------------------------------------------------------------------------------
+inline void geo::AuxDetChannelIndex::channelsToSensitive(
+  std::size_t ad, util::span<Channel_t const*> channels,
+  util::span<SensitiveID_t*> sensitives
+) const {
+  checkOutputSize(channels.size(), sensitives.size(), "channelsToSensitive");
+  std::transform(channels.begin(), channels.end(), sensitives.begin(),
+    [this, ad](Channel_t channel){ return channelToSensitive(ad, channel); });
+} // geo::AuxDetChannelIndex::channelsToSensitive()
+
+
+//------------------------------------------------------------------------------
+inline std::size_t geo::AuxDetChannelIndex::channelPositions(
+  std::size_t ad, util::span<Channel_t const*> channels,
+  util::span<geo::Point_t*> positions
+) const {
+  checkOutputSize(channels.size(), positions.size(), "channelPositions");
+  std::size_t nInvalid = 0U;
+  auto iPosition = positions.begin();
+  for (Channel_t const channel: channels) {
+    bool valid;
+    *(iPosition++) = channelPosition(ad, channel, valid);
+    if (!valid) ++nInvalid;
+  }
+  return nInvalid;
+} // geo::AuxDetChannelIndex::channelPositions()
+
+
+//------------------------------------------------------------------------------
+inline std::size_t geo::AuxDetChannelIndex::auxDetAt
+  (geo::Point_t const& point) const
+{
+  std::size_t const ad = fAuxDetGrid.find(point, [this, &point](std::size_t i)
+    { return contains(*(fAuxDets[i].geo), point, fTolerance); });
+  return (ad == geo::BoxGridIndex::NoBox)? NoIndex: ad;
+} // geo::AuxDetChannelIndex::auxDetAt()
+
+
+//------------------------------------------------------------------------------
+inline auto geo::AuxDetChannelIndex::sensitiveAt
+  (geo::Point_t const& point) const -> SensitiveID_t
+{
+  // like the channel mapping, we look for sensitive volumes only in the
+  // first auxiliary detector containing the point
+  std::size_t const ad = auxDetAt(point);
+  if (ad == NoIndex) return {};
+
+  std::size_t const iSensitive = fSensitiveGrid.find(point,
+    [this, &point, ad](std::size_t i)
+    {
+      SensitiveID_t const& sv = fSensitives[i];
+      return (sv.auxDet == ad) && contains
+        (fAuxDets[ad].geo->SensitiveVolume(sv.sensitive), point, fTolerance);
+    });
+  return (iSensitive == geo::BoxGridIndex::NoBox)
+    ? SensitiveID_t{ ad, NoIndex }: fSensitives[iSensitive];
+
+} // geo::AuxDetChannelIndex::sensitiveAt()
+
+
+//------------------------------------------------------------------------------
+inline void geo::AuxDetChannelIndex::auxDetsAt(
+  util::span<geo::Point_t const*> points,
+  util::span<std::size_t*> auxDets
+) const {
+  checkOutputSize(points.size(), auxDets.size(), "auxDetsAt");
+  std::transform(points.begin(), points.end(), auxDets.begin(),
+    [this](geo::Point_t const& point){ return auxDetAt(point); });
+} // geo::AuxDetChannelIndex::auxDetsAt()
+
+
+//------------------------------------------------------------------------------
+inline void geo::AuxDetChannelIndex::sensitivesAt(
+  util::span<geo::Point_t const*> points,
+  util::span<SensitiveID_t*> sensitives
+) const {
+  checkOutputSize(points.size(), sensitives.size(), "sensitivesAt");
+  std::transform(points.begin(), points.end(), sensitives.begin(),
+    [this](geo::Point_t const& point){ return sensitiveAt(point); });
+} // geo::AuxDetChannelIndex::sensitivesAt()
+
+
+//------------------------------------------------------------------------------
+inline std::size_t geo::AuxDetChannelIndex::fallbackSensitive
+  (std::size_t ad, Channel_t channel) const
+{
+  if (ad >= fAuxDets.size()) return NoIndex;
+  geo::AuxDetGeo const& auxDet = *(fAuxDets[ad].geo);
+  // channels in the table range were all tried already
+  if (channel < fAuxDets[ad].channels.size()) return NoIndex;
+  try {
+    return sensitiveIndex
+      (auxDet, fGeom->ChannelToAuxDetSensitive(auxDet.Name(), channel));
+  }
+  catch (cet::exception const&) { return NoIndex; }
+} // geo::AuxDetChannelIndex::fallbackSensitive()
+
+
+//------------------------------------------------------------------------------
+inline std::size_t geo::AuxDetChannelIndex::sensitiveIndex
+  (geo::AuxDetGeo const& ad, geo::AuxDetSensitiveGeo const& sensitive)
+{
+  for (std::size_t sv = 0; sv < ad.NSensitiveVolume(); ++sv)
+    if (&(ad.SensitiveVolume(sv)) == &sensitive) return sv;
+  return NoIndex;
+} // geo::AuxDetChannelIndex::sensitiveIndex()
+
+
+//------------------------------------------------------------------------------
+template <typename Volume>
+bool geo::AuxDetChannelIndex::contains
+  (Volume const& volume, geo::Point_t const& point, double tolerance)
+{
+  // same criterion as geo::AuxDetChannelMapAlg::NearestAuxDet()
+  double const world[3] = { point.X(), point.Y(), point.Z() };
+  double local[3];
+  volume.WorldToLocal(world, local);
+
+  double const halfLength = volume.Length() / 2.0;
+  double const halfCenterWidth
+    = (volume.HalfWidth1() + volume.HalfWidth2()) / 2.0;
+  double const halfWidth = halfCenterWidth
+    - local[2] * (halfCenterWidth - volume.HalfWidth2()) / halfLength;
+  return (local[2] >= -(halfLength + tolerance))
+    && (local[2] <= halfLength + tolerance)
+    && (local[1] >= -volume.HalfHeight() - tolerance)
+    && (local[1] <= volume.HalfHeight() + tolerance)
+    && (local[0] >= -halfWidth - tolerance)
+    && (local[0] <= halfWidth + tolerance);
+} // geo::AuxDetChannelIndex::contains()
+
+
+//------------------------------------------------------------------------------
+template <typename Volume>
+geo::BoxBoundedGeo geo::AuxDetChannelIndex::boundingBox
+  (Volume const& volume, double tolerance)
+{
+  // the corners of the box around the trapezoid, in the volume frame;
+  // a small margin covers the rounding in the change of frame
+  double const margin = tolerance + 1e-6;
+  double const dx
+    = std::max(volume.HalfWidth1(), volume.HalfWidth2()) + margin;
+  double const dy = volume.HalfHeight() + margin;
+  double const dz = volume.Length() / 2.0 + margin;
+
+  double min[3], max[3];
+  std::fill(min, min + 3, std::numeric_limits<double>::max());
+  std::fill(max, max + 3, std::numeric_limits<double>::lowest());
+  for (double const x: { -dx, dx }) {
+    for (double const y: { -dy, dy }) {
+      for (double const z: { -dz, dz }) {
+        double const local[3] = { x, y, z };
+        double world[3];
+        volume.LocalToWorld(local, world);
+        for (std::size_t axis = 0; axis < 3U; ++axis) {
+          min[axis] = std::min(min[axis], world[axis]);
+          max[axis] = std::max(max[axis], world[axis]);
+        }
+      } // for z
+    } // for y
+  } // for x
+  return geo::BoxBoundedGeo{ min[0], max[0], min[1], max[1], min[2], max[2] };
+} // geo::AuxDetChannelIndex::boundingBox()
+
+
+//------------------------------------------------------------------------------
+inline void geo::AuxDetChannelIndex::checkOutputSize
+  (std::size_t input, std::size_t output, const char* caller)
+{
+  if (output >= input) return;
+  throw cet::exception("AuxDetChannelIndex")
+    << caller << "(): room for only " << output << " results for "
+    << input << " queries.\n";
+} // geo::AuxDetChannelIndex::checkOutputSize()
+
+
+//------------------------------------------------------------------------------
+
+
+#endif // LARCORE_GEOMETRY_AUXDETCHANNELINDEX_H
@@ -10,6 +10,8 @@
 #define GEO_AUXDETGEOMETRY_H
 
 // LArSoft libraries
+#include "larcore/CoreUtils/SnapshotHolder.h"
+#include "larcore/Geometry/AuxDetChannelIndex.h"
 
 // the following are included for convenience only
 #include "larcorealg/Geometry/AuxDetGeometryCore.h"
@@ -84,10 +86,45 @@ namespace geo {
    *   is directly passed to the channel mapping algorithm (see
    *   geo::ChannelMapAlg); its content is dependent on the chosen
    *   implementation of ChannelMapAlg
+   * - *IndexTolerance* (real, default: `0`): tolerance [cm] of the position
+   *   queries of the channel index (see `ChannelIndex()`)
    *
    * @note Currently, the file defined by `GDML` parameter is also served to
    * ROOT for the internal geometry representation.
    *
+   *
+   * Geometry reloading and multithreading
+   * ======================================
+   *
+   * The service provider is never modified after it is published.
+   * When a run requires a different geometry, a new provider is created,
+   * completely initialized and then published atomically in place of the old
+   * one (see `lar::SnapshotHolder`). This makes the service safe to use from
+   * multiple schedules and threads:
+   *
+   * * `GetProvider()` and `GetProviderPtr()` return the provider current at
+   *   the time of the call; replaced providers are kept until the end of the
+   *   job, so that these references never become invalid, but they keep
+   *   describing the geometry they were obtained for; to follow geometry
+   *   changes, the provider should be obtained again at each new run
+   * * `GetProviderSnapshot()` returns a pointer which owns the provider.
+   *
+   *
+   * Channel index
+   * ==============
+   *
+   * Together with each provider, a `geo::AuxDetChannelIndex` is built and
+   * published, offering fast (and batched) lookup of the sensitive volume and
+   * position of channels, and of the detectors containing points:
+   * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+   * geo::AuxDetChannelIndex const& index
+   *   = art::ServiceHandle<geo::AuxDetGeometry const>()->ChannelIndex();
+   * std::size_t const ad = index.auxDetIndex(auxDetName);
+   * auto const [ auxDet, sv ] = index.channelToSensitive(ad, channel);
+   * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+   * The index refers to the provider it was published with, which
+   * `GetProvider()` returns at the same time.
+   *
    */
   class AuxDetGeometry
   {
@@ -95,36 +132,57 @@ namespace geo {
 
     AuxDetGeometry(fhicl::ParameterSet const& pset, art::ActivityRegistry& reg);
 
-    /// Returns a constant reference to the service provider
-    AuxDetGeometryCore const& GetProvider() const { return fProvider; }
+    /// Returns a constant reference to the current service provider
+    AuxDetGeometryCore const& GetProvider() const { return *GetProviderPtr(); }
+
+    /// Returns a constant pointer to the current service provider
+    AuxDetGeometryCore const* GetProviderPtr() const
+      { return fProvider.current()->provider.get(); }
 
-    /// Returns a constant pointer to the service provider
-    AuxDetGeometryCore const* GetProviderPtr() const { return &GetProvider(); }
+    /// Returns the current service provider, kept alive by the pointer
+    std::shared_ptr<AuxDetGeometryCore const> GetProviderSnapshot() const
+      {
+        std::shared_ptr<ProviderData_t const> data = fProvider.snapshot();
+        AuxDetGeometryCore const* provider = data->provider.get();
+        return { std::move(data), provider };
+      }
+
+    /// Returns the channel and position index of the current provider
+    geo::AuxDetChannelIndex const& ChannelIndex() const
+      { return fProvider.current()->index; }
+
+    /// Returns how many times a geometry was loaded (including the first one)
+    unsigned int NGeometryLoads() const { return fProvider.generation(); }
 
   private:
 
     /// Updates the geometry if needed at the beginning of each new run
     void preBeginRun(art::Run const& run);
 
-    /// Expands the provided paths and loads the geometry description(s)
+    /// Expands the provided paths, loads the geometry description(s) into a
+    /// new provider and publishes it
     void LoadNewGeometry(std::string gdmlfile, std::string rootfile);
 
-    void InitializeChannelMap();
-
-    /// Returns a reference to the service provider
-    AuxDetGeometryCore& GetProvider() { return fProvider; }
+    /// Applies the channel mapping to the `provider` being initialized
+    void InitializeChannelMap(AuxDetGeometryCore& provider) const;
 
-    /// Returns a pointer to the service provider
-    AuxDetGeometryCore* GetProviderPtr() { return &GetProvider(); }
 
+    /// A provider, and the index built from it.
+    struct ProviderData_t {
+      std::unique_ptr<AuxDetGeometryCore const> provider; ///< the provider
+      geo::AuxDetChannelIndex index; ///< index of `provider`
+    };
 
-    AuxDetGeometryCore fProvider; ///< the actual service provider
+    fhicl::ParameterSet       fProviderParameters;///< Configuration of new providers
+    lar::SnapshotHolder<ProviderData_t> fProvider; ///< the actual service provider
 
     std::string               fRelPath;          ///< Relative path added to FW_SEARCH_PATH to search for
                                                  ///< geometry file
     bool                      fForceUseFCLOnly;  ///< Force Geometry to only use the geometry
                                                  ///< files specified in the fcl file
     fhicl::ParameterSet       fSortingParameters;///< Parameter set to define the channel map sorting
+    double                    fIndexTolerance;   ///< Tolerance of the channel index
+                                                 ///< position queries [cm]
   };
 
 } // namespace geo
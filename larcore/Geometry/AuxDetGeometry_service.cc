@@ -19,6 +19,7 @@
 
 // C/C++ standard libraries
 #include <string>
+#include <memory> // std::make_unique()
 
 
 namespace geo {
@@ -27,10 +28,11 @@ namespace geo {
   //......................................................................
   // Constructor.
   AuxDetGeometry::AuxDetGeometry(fhicl::ParameterSet const& pset, art::ActivityRegistry &reg)
-    : fProvider         (pset)
+    : fProviderParameters(pset)
     , fRelPath          (pset.get< std::string       >("RelativePath",      ""   ))
     , fForceUseFCLOnly  (pset.get< bool              >("ForceUseFCLOnly" ,  false))
     , fSortingParameters(pset.get<fhicl::ParameterSet>("SortingParameters", {}))
+    , fIndexTolerance   (pset.get< double            >("IndexTolerance",    0.0  ))
   {
     // add a final directory separator ("/") to fRelPath if not already there
     if (!fRelPath.empty() && (fRelPath.back() != '/')) fRelPath += '/';
@@ -89,7 +91,7 @@ namespace geo {
 
 
   //......................................................................
-  void AuxDetGeometry::InitializeChannelMap()
+  void AuxDetGeometry::InitializeChannelMap(AuxDetGeometryCore& provider) const
   {
     // the channel map is responsible of calling the channel map configuration
     // of the geometry
@@ -97,7 +99,7 @@ namespace geo {
     if (!channelMap) {
       throw cet::exception("ChannelMapLoadFail") << " failed to load new channel map";
     }
-    fProvider.ApplyChannelMap(move(channelMap));
+    provider.ApplyChannelMap(move(channelMap));
   } // Geometry::InitializeChannelMap()
 
   //......................................................................
@@ -130,11 +132,20 @@ namespace geo {
                                              << "\nbail ungracefully.\n";
     }
 
+    // the new provider is completely initialized before being published;
+    // until then, the previous one (if any) is still served
+    auto provider = std::make_unique<AuxDetGeometryCore>(fProviderParameters);
+
     // initialize the geometry with the files we have found
-    GetProvider().LoadGeometryFile(GDMLfile, ROOTfile);
+    provider->LoadGeometryFile(GDMLfile, ROOTfile);
 
     // now update the channel map
-    InitializeChannelMap();
+    InitializeChannelMap(*provider);
+
+    auto data = std::make_shared<ProviderData_t>();
+    data->index = geo::AuxDetChannelIndex{ *provider, fIndexTolerance };
+    data->provider = std::move(provider);
+    fProvider.publish(std::move(data));
 
   } // Geometry::LoadNewGeometry()
 
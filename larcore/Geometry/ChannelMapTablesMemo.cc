@@ -0,0 +1,243 @@
+/**
+ * @file   larcore/Geometry/ChannelMapTablesMemo.cc
+ * @brief  Memoization of the channel mapping tables of a geometry.
+ * @see    larcore/Geometry/ChannelMapTablesMemo.h
+ */
+
+// library header
+#include "larcore/Geometry/ChannelMapTablesMemo.h"
+
+// LArSoft libraries
+#include "larcore/Geometry/ColumnarFile.h"
+
+// framework libraries
+#include "cetlib_except/exception.h"
+
+// C/C++ standard libraries
+#include <fstream>
+#include <algorithm> // std::equal()
+#include <cstdio> // std::rename(), std::remove()
+#include <cstring> // std::memcpy()
+#include <cstddef> // std::byte
+#include <unistd.h> // ::getpid(), ::gethostname()
+
+
+//------------------------------------------------------------------------------
+namespace {
+
+  /// Version of the memo: content of the files and composition of the key.
+  constexpr std::uint64_t MemoFileVersion = 2U;
+
+  /// Returns a buffer of 64-bit words with the serialization of `table`.
+  template <typename Table>
+  std::vector<std::uint64_t> serializeTable(Table const& table) {
+    std::size_t const size = table.serializedSize();
+    std::vector<std::uint64_t> buffer
+      ((size + sizeof(std::uint64_t) - 1U) / sizeof(std::uint64_t), 0U);
+    table.serialize(reinterpret_cast<std::byte*>(buffer.data()));
+    return buffer;
+  } // serializeTable()
+
+
+  /// Returns the words of the whole `key`, as stored in the memo files.
+  std::vector<std::uint64_t> keyWords
+    (geo::ChannelMapTablesMemo::Key_t const& key)
+  {
+    cet::MD5Result const hash = cet::MD5Digest{ key.toString() }.digest();
+    std::vector<std::uint64_t> words { MemoFileVersion, 0U, 0U };
+    std::memcpy(words.data() + 1, hash.bytes.data(), hash.bytes.size());
+    return words;
+  } // keyWords()
+
+} // local namespace
+
+
+//------------------------------------------------------------------------------
+//--- geo::ChannelMapTablesMemo::Key_t
+//------------------------------------------------------------------------------
+std::string geo::ChannelMapTablesMemo::Key_t::toString() const {
+  cet::MD5Digest digest;
+  digest.append("version=" + std::to_string(MemoFileVersion));
+  digest.append(detectorName);
+  digest.append(channelMapName);
+  digest.append(sortingHash.toString());
+  digest.append(geometryHash.toString());
+  return digest.digest().toString();
+} // geo::ChannelMapTablesMemo::Key_t::toString()
+
+
+//------------------------------------------------------------------------------
+//--- geo::ChannelMapTablesMemo
+//------------------------------------------------------------------------------
+auto geo::ChannelMapTablesMemo::makeKey(
+  std::string const& detectorName,
+  std::string const& channelMapName,
+  fhicl::ParameterSet const& sortingParameters,
+  cet::MD5Result const& geometryHash
+) -> Key_t {
+  // `to_string()` is canonical: keys are always written in the same order
+  return {
+    detectorName,
+    channelMapName,
+    cet::MD5Digest{ sortingParameters.to_string() }.digest(),
+    geometryHash
+    };
+} // geo::ChannelMapTablesMemo::makeKey()
+
+
+//------------------------------------------------------------------------------
+auto geo::ChannelMapTablesMemo::find
+  (Key_t const& key, std::string const& directory /* = "" */) const
+  -> std::optional<Tables_t>
+{
+  if (directory.empty()) return std::nullopt;
+
+  std::shared_ptr<Data_t const> data
+    = readFile(filePath(key, directory), key);
+  if (!data) return std::nullopt;
+
+  std::lock_guard<std::mutex> const lock { fMutex };
+  ++fFileHits;
+  return viewTables(std::move(data));
+
+} // geo::ChannelMapTablesMemo::find()
+
+
+//------------------------------------------------------------------------------
+auto geo::ChannelMapTablesMemo::store(
+  Key_t const& key,
+  geo::WireToChannelTable const& wireToChannel,
+  geo::ChannelToWireTable const& channelToWires,
+  std::string const& directory /* = "" */
+) -> Tables_t {
+
+  auto data = std::make_shared<Data_t>();
+  data->wireToChannel = serializeTable(wireToChannel);
+  data->channelToWires = serializeTable(channelToWires);
+
+  if (!directory.empty() && writeFile(filePath(key, directory), key, *data))
+  {
+    std::lock_guard<std::mutex> const lock { fMutex };
+    ++fWritten;
+  }
+
+  return viewTables(std::move(data));
+
+} // geo::ChannelMapTablesMemo::store()
+
+
+//------------------------------------------------------------------------------
+std::string geo::ChannelMapTablesMemo::filePath
+  (Key_t const& key, std::string const& directory)
+{
+  std::string path = directory;
+  if (!path.empty() && (path.back() != '/')) path += '/';
+  return path + "channelmap_" + key.toString() + ".lcol";
+} // geo::ChannelMapTablesMemo::filePath()
+
+
+//------------------------------------------------------------------------------
+unsigned int geo::ChannelMapTablesMemo::nFileHits() const {
+  std::lock_guard<std::mutex> const lock { fMutex };
+  return fFileHits;
+} // geo::ChannelMapTablesMemo::nFileHits()
+
+
+//------------------------------------------------------------------------------
+unsigned int geo::ChannelMapTablesMemo::nWritten() const {
+  std::lock_guard<std::mutex> const lock { fMutex };
+  return fWritten;
+} // geo::ChannelMapTablesMemo::nWritten()
+
+
+//------------------------------------------------------------------------------
+auto geo::ChannelMapTablesMemo::viewTables(std::shared_ptr<Data_t const> data)
+  -> Tables_t
+{
+  Tables_t tables;
+  tables.wireToChannel = geo::WireToChannelTable::view
+    (reinterpret_cast<std::byte const*>(data->wireToChannel.data()));
+  tables.channelToWires = geo::ChannelToWireTable::view
+    (reinterpret_cast<std::byte const*>(data->channelToWires.data()));
+  tables.data = std::move(data);
+  return tables;
+} // geo::ChannelMapTablesMemo::viewTables()
+
+
+//------------------------------------------------------------------------------
+auto geo::ChannelMapTablesMemo::readFile
+  (std::string const& path, Key_t const& key) -> std::shared_ptr<Data_t const>
+{
+  if (!std::ifstream{ path }.good()) return {};
+
+  try {
+    geo::ColumnarFileReader const reader { path };
+    auto const fileKey = reader.column<std::uint64_t>("key");
+    std::vector<std::uint64_t> const expectedKey = keyWords(key);
+    if (!std::equal(fileKey.begin(), fileKey.end(),
+      expectedKey.begin(), expectedKey.end()))
+    {
+      return {};
+    }
+
+    auto const wireToChannel = reader.column<std::uint64_t>("wireToChannel");
+    auto const channelToWires
+      = reader.column<std::uint64_t>("channelToWires");
+    auto data = std::make_shared<Data_t>();
+    data->wireToChannel.assign(wireToChannel.begin(), wireToChannel.end());
+    data->channelToWires.assign(channelToWires.begin(), channelToWires.end());
+
+    // a matching key is not enough: the tables must also fit their columns
+    if (!geo::WireToChannelTable::validView(
+        reinterpret_cast<std::byte const*>(data->wireToChannel.data()),
+        data->wireToChannel.size() * sizeof(std::uint64_t)
+      )
+      || !geo::ChannelToWireTable::validView(
+        reinterpret_cast<std::byte const*>(data->channelToWires.data()),
+        data->channelToWires.size() * sizeof(std::uint64_t)
+      )
+    ) {
+      return {};
+    }
+    return data;
+  }
+  catch (cet::exception const&) {
+    return {}; // a broken file is just not used
+  }
+
+} // geo::ChannelMapTablesMemo::readFile()
+
+
+//------------------------------------------------------------------------------
+bool geo::ChannelMapTablesMemo::writeFile
+  (std::string const& path, Key_t const& key, Data_t const& data)
+{
+  geo::ColumnarFileWriter writer;
+  writer.addColumn("key", keyWords(key));
+  writer.addColumn("wireToChannel", data.wireToChannel);
+  writer.addColumn("channelToWires", data.channelToWires);
+
+  // write under a unique name first, so that no other job may read a partial
+  // file; the final renaming is atomic; the directory may be shared by jobs
+  // on different nodes, whose process IDs may coincide
+  char hostName[256] = "";
+  if (::gethostname(hostName, sizeof(hostName) - 1U) != 0) hostName[0] = 0;
+  std::string const tempFile = path + "." + hostName
+    + "." + std::to_string(::getpid()) + ".tmp";
+  try {
+    writer.write(tempFile);
+  }
+  catch (cet::exception const&) {
+    std::remove(tempFile.c_str());
+    return false;
+  }
+  if (std::rename(tempFile.c_str(), path.c_str()) != 0) {
+    std::remove(tempFile.c_str());
+    return false;
+  }
+  return true;
+
+} // geo::ChannelMapTablesMemo::writeFile()
+
+
+//------------------------------------------------------------------------------
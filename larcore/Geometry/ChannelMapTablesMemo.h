@@ -0,0 +1,179 @@
+/**
+ * @file   larcore/Geometry/ChannelMapTablesMemo.h
+ * @brief  Memoization of the channel mapping tables of a geometry.
+ * @see    larcore/Geometry/ChannelMapTablesMemo.cc
+ */
+
+#ifndef LARCORE_GEOMETRY_CHANNELMAPTABLESMEMO_H
+#define LARCORE_GEOMETRY_CHANNELMAPTABLESMEMO_H
+
+// LArSoft libraries
+#include "larcore/Geometry/ChannelToWireTable.h"
+#include "larcore/Geometry/WireToChannelTable.h"
+
+// framework libraries
+#include "fhiclcpp/ParameterSet.h"
+#include "cetlib/MD5Digest.h"
+
+// C/C++ standard libraries
+#include <memory> // std::shared_ptr<>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+#include <tuple> // std::tie()
+#include <cstdint> // std::uint64_t
+
+
+namespace geo {
+
+  /**
+   * @brief Keeps the channel mapping tables of geometries already loaded.
+   *
+   * Building the channel mapping tables (`geo::WireToChannelTable` and
+   * `geo::ChannelToWireTable`) requires querying the channel mapping
+   * algorithm for every wire and every channel. The result depends only on
+   * the detector, on the channel mapping implementation (the type of the
+   * geometry helper service), on its configuration ("sorting parameters")
+   * and on the geometry itself, which together make the key (`Key_t`) of
+   * the tables. The key includes a version of the memo format too.
+   *
+   * Tables are stored (`store()`) in serialized form into a file in the
+   * memo directory (in `geo::ColumnarFormat`, named after the key), and
+   * retrieved (`find()`) as views of the data read back from there, so that
+   * later jobs can reuse them. The memo is file-only: the `Geometry` service
+   * loads the geometry only once per job, so that tables kept in memory
+   * would never be looked up again.
+   *
+   * Files are trusted only if their key matches and the tables they contain
+   * are consistent and fit in their columns (`validView()` of each table).
+   * The tables retrieved are bit-by-bit identical to the ones stored.
+   * All methods are thread-safe.
+   */
+  class ChannelMapTablesMemo {
+
+      public:
+
+    /// Identifier of a set of channel mapping tables.
+    struct Key_t {
+      std::string detectorName; ///< Name of the detector.
+      std::string channelMapName; ///< Type of the channel mapping provider.
+      cet::MD5Result sortingHash; ///< Hash of channel mapping configuration.
+      cet::MD5Result geometryHash; ///< Hash of the geometry content.
+
+      /// Returns a hash of the whole key (as hexadecimal string).
+      std::string toString() const;
+
+      bool operator< (Key_t const& other) const
+        {
+          return std::tie
+              (detectorName, channelMapName, sortingHash.bytes,
+              geometryHash.bytes)
+            < std::tie(other.detectorName, other.channelMapName,
+              other.sortingHash.bytes, other.geometryHash.bytes);
+        }
+
+    }; // Key_t
+
+    /// Channel mapping tables, viewing the memoized data.
+    struct Tables_t {
+      geo::WireToChannelTable wireToChannel; ///< Channel of each wire.
+      geo::ChannelToWireTable channelToWires; ///< Wires of each channel.
+      std::shared_ptr<void const> data; ///< Keeps the viewed data alive.
+    }; // Tables_t
+
+
+    /**
+     * @brief Returns the key of the specified channel mapping.
+     * @param detectorName name of the detector
+     * @param channelMapName name of the type providing the channel mapping
+     *        (e.g. the demangled dynamic type of the geometry helper service)
+     * @param sortingParameters configuration of the channel mapping
+     * @param geometryHash content hash of the geometry
+     */
+    static Key_t makeKey(
+      std::string const& detectorName,
+      std::string const& channelMapName,
+      fhicl::ParameterSet const& sortingParameters,
+      cet::MD5Result const& geometryHash
+      );
+
+
+    /**
+     * @brief Returns the tables memoized with `key`, if any.
+     * @param key the key of the tables
+     * @param directory where to look for tables stored by other jobs
+     * @return the tables, or no value if none is memoized for `key`
+     *
+     * Files which can't be read, do not match the key or hold inconsistent
+     * tables are ignored. With no `directory`, nothing is ever found.
+     */
+    std::optional<Tables_t> find
+      (Key_t const& key, std::string const& directory = "") const;
+
+    /**
+     * @brief Memoizes the specified tables with `key`.
+     * @param key the key of the tables
+     * @param wireToChannel the channel of each wire
+     * @param channelToWires the wires of each channel
+     * @param directory where to write the tables for other jobs (if not empty)
+     * @return views of the memoized tables (identical to the arguments)
+     *
+     * Both tables must be completely filled (or fillable). With no
+     * `directory` the tables are not memoized at all, and only their
+     * serialized copy is returned.
+     * Failure to write the file is not fatal (`nWritten()` won't count it).
+     */
+    Tables_t store(
+      Key_t const& key,
+      geo::WireToChannelTable const& wireToChannel,
+      geo::ChannelToWireTable const& channelToWires,
+      std::string const& directory = ""
+      );
+
+    /// Returns the path of the file for tables with `key` in `directory`.
+    static std::string filePath
+      (Key_t const& key, std::string const& directory);
+
+
+    // --- BEGIN -- Statistics -------------------------------------------------
+    /// Number of `find()` calls served from a file.
+    unsigned int nFileHits() const;
+
+    /// Number of tables written into files.
+    unsigned int nWritten() const;
+    // --- END -- Statistics ---------------------------------------------------
+
+
+      private:
+
+    /// Serialized tables.
+    struct Data_t {
+      std::vector<std::uint64_t> wireToChannel; ///< Channel of each wire.
+      std::vector<std::uint64_t> channelToWires; ///< Wires of each channel.
+    }; // Data_t
+
+    mutable std::mutex fMutex; ///< Protects all the data members.
+
+    mutable unsigned int fFileHits = 0U; ///< Calls served from file.
+    unsigned int fWritten = 0U; ///< Tables written into files.
+
+
+    /// Returns tables viewing `data`, which must have been validated.
+    static Tables_t viewTables(std::shared_ptr<Data_t const> data);
+
+    /// Reads data with `key` from `path`; null if not possible or not valid.
+    static std::shared_ptr<Data_t const> readFile
+      (std::string const& path, Key_t const& key);
+
+    /// Writes `data` into `path`; returns whether it succeeded.
+    static bool writeFile
+      (std::string const& path, Key_t const& key, Data_t const& data);
+
+  }; // class ChannelMapTablesMemo
+
+
+} // namespace geo
+
+
+#endif // LARCORE_GEOMETRY_CHANNELMAPTABLESMEMO_H
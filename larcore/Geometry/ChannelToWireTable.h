@@ -0,0 +1,241 @@
+/**
+ * @file   larcore/Geometry/ChannelToWireTable.h
+ * @brief  Flat table of the wires covered by each TPC readout channel.
+ * @see    larcore/Geometry/Geometry.h
+ *
+ * This library is header-only.
+ */
+
+#ifndef LARCORE_GEOMETRY_CHANNELTOWIRETABLE_H
+#define LARCORE_GEOMETRY_CHANNELTOWIRETABLE_H
+
+// LArSoft libraries
+#include "larcorealg/Geometry/GeometryCore.h"
+#include "larcorealg/CoreUtils/span.h"
+#include "larcoreobj/SimpleTypesAndConstants/geo_types.h" // geo::WireID
+#include "larcoreobj/SimpleTypesAndConstants/RawTypes.h" // raw::ChannelID_t
+
+// C/C++ standard libraries
+#include <vector>
+#include <type_traits> // std::is_trivially_copyable_v
+#include <cstring> // std::memcpy()
+#include <cstdint> // std::uint64_t
+#include <cstddef> // std::size_t, std::byte
+
+
+namespace geo {
+
+  /**
+   * @brief Table of the wires covered by each TPC channel.
+   *
+   * The table is filled once from a fully initialized geometry (that is, after
+   * the channel mapping has been applied) and never changed afterwards.
+   * It has a compressed sparse row layout: a single contiguous list of all the
+   * wire IDs, sorted by channel, and a list of offsets where the wires of each
+   * channel start.
+   * The wires of each channel are in the order returned by
+   * `geo::GeometryCore::ChannelToWire()`.
+   *
+   * Queries do not allocate memory and do not throw; since the object is
+   * immutable, they can be safely performed from multiple threads at once.
+   *
+   * Channels are assumed to be numbered contiguously from `0` to
+   * `geo::GeometryCore::Nchannels() - 1`.
+   *
+   * The table can be serialized into a memory buffer (`serialize()`), and a
+   * table can be created as a view of serialized data (`view()`), without
+   * copying it: this allows a single copy of the table, e.g. in shared memory,
+   * to be used by many processes.
+   */
+  class ChannelToWireTable {
+
+      public:
+
+    /// Type of range of wire IDs returned by the queries.
+    using WireIDs_t = util::span<geo::WireID const*>;
+
+    /// Constructor: an empty table.
+    ChannelToWireTable() = default;
+
+    /// Constructor: fills the table from the specified `geom`.
+    explicit ChannelToWireTable(geo::GeometryCore const& geom);
+
+    // the views would point to the data of the original table
+    ChannelToWireTable(ChannelToWireTable const&) = delete;
+    ChannelToWireTable(ChannelToWireTable&&) = default;
+    ChannelToWireTable& operator= (ChannelToWireTable const&) = delete;
+    ChannelToWireTable& operator= (ChannelToWireTable&&) = default;
+
+
+    /// Returns the number of channels in the table.
+    std::size_t nChannels() const
+      { return (fNOffsets == 0U)? 0U: fNOffsets - 1U; }
+
+    /// Returns the total number of wires in the table.
+    std::size_t nWires() const { return fNWireIDs; }
+
+    /// Returns whether the table is empty.
+    bool empty() const { return fNOffsets == 0U; }
+
+    /// Returns whether `channel` is described in the table.
+    bool hasChannel(raw::ChannelID_t channel) const
+      { return raw::isValidChannelID(channel) && (channel < nChannels()); }
+
+    /// Returns the wires covered by `channel` (empty if channel is unknown).
+    WireIDs_t wires(raw::ChannelID_t channel) const
+      {
+        if (!hasChannel(channel)) return { nullptr, nullptr };
+        return {
+          fWireIDData + fOffsetData[channel],
+          fWireIDData + fOffsetData[channel + 1]
+          };
+      }
+
+
+    // --- BEGIN -- Serialization ----------------------------------------------
+    /// Returns the size of the serialized table [bytes].
+    std::size_t serializedSize() const
+      { return 2U * Word + fNOffsets * Word + fNWireIDs * sizeof(geo::WireID); }
+
+    /// Writes the table into `buffer`, which must have `serializedSize()`
+    /// bytes and be aligned to 8 bytes.
+    void serialize(std::byte* buffer) const;
+
+    /// Returns a table using the data serialized at `buffer` (not copied),
+    /// which must stay available for the whole lifetime of the table.
+    static ChannelToWireTable view(std::byte const* buffer);
+
+    /**
+     * @brief Returns whether `buffer` holds a consistent serialized table.
+     * @param buffer the serialized data (aligned to 8 bytes)
+     * @param size the number of bytes available in `buffer`
+     * @return whether `view(buffer)` is safe to use
+     *
+     * The table must fit in `size` bytes (`serializedSize()`), and its
+     * offsets must be sorted and within the wire list.
+     * Only the `size` bytes of `buffer` are ever read.
+     */
+    static bool validView(std::byte const* buffer, std::size_t size);
+
+    // --- END -- Serialization ------------------------------------------------
+
+
+      private:
+
+    /// Offset of the first wire of each channel, plus the total wire count.
+    std::vector<std::size_t> fOffsets;
+
+    std::vector<geo::WireID> fWireIDs; ///< Wires of all channels.
+
+    // the queries use these, pointing either to the vectors above or to
+    // external (serialized) data
+    std::size_t const* fOffsetData = nullptr; ///< Offset of each channel.
+    std::size_t fNOffsets = 0U; ///< Number of offsets.
+    geo::WireID const* fWireIDData = nullptr; ///< Wires of all channels.
+    std::size_t fNWireIDs = 0U; ///< Number of wires.
+
+    /// Size of a serialized integral number.
+    static constexpr std::size_t Word = sizeof(std::uint64_t);
+
+    static_assert(sizeof(std::size_t) == Word,
+      "Serialization requires 64-bit offsets");
+    static_assert(std::is_trivially_copyable_v<geo::WireID>,
+      "Serialization requires trivially copyable wire IDs");
+
+  }; // class ChannelToWireTable
+
+
+} // namespace geo
+
+
+//------------------------------------------------------------------------------
+//--- inline implementation
+//------------------------------------------------------------------------------
+inline geo::ChannelToWireTable::ChannelToWireTable
+  (geo::GeometryCore const& geom)
+{
+  unsigned int const nChannels = geom.Nchannels();
+
+  fOffsets.reserve(nChannels + 1U);
+  fWireIDs.reserve(nChannels); // a good guess for most detectors
+
+  fOffsets.push_back(0U);
+  for (raw::ChannelID_t channel = 0; channel < nChannels; ++channel) {
+    std::vector<geo::WireID> const wires = geom.ChannelToWire(channel);
+    fWireIDs.insert(fWireIDs.end(), wires.begin(), wires.end());
+    fOffsets.push_back(fWireIDs.size());
+  } // for
+
+  fWireIDs.shrink_to_fit();
+
+  fOffsetData = fOffsets.data();
+  fNOffsets = fOffsets.size();
+  fWireIDData = fWireIDs.data();
+  fNWireIDs = fWireIDs.size();
+
+} // geo::ChannelToWireTable::ChannelToWireTable()
+
+
+//------------------------------------------------------------------------------
+inline void geo::ChannelToWireTable::serialize(std::byte* buffer) const {
+
+  std::uint64_t const sizes[2] = { fNOffsets, fNWireIDs };
+  std::memcpy(buffer, sizes, sizeof(sizes));
+  buffer += sizeof(sizes);
+  std::memcpy(buffer, fOffsetData, fNOffsets * Word);
+  buffer += fNOffsets * Word;
+  std::memcpy(buffer, fWireIDData, fNWireIDs * sizeof(geo::WireID));
+
+} // geo::ChannelToWireTable::serialize()
+
+
+//------------------------------------------------------------------------------
+inline auto geo::ChannelToWireTable::view(std::byte const* buffer)
+  -> ChannelToWireTable
+{
+  std::uint64_t sizes[2];
+  std::memcpy(sizes, buffer, sizeof(sizes));
+  buffer += sizeof(sizes);
+
+  ChannelToWireTable table;
+  table.fNOffsets = sizes[0];
+  table.fNWireIDs = sizes[1];
+  table.fOffsetData = reinterpret_cast<std::size_t const*>(buffer);
+  buffer += table.fNOffsets * Word;
+  table.fWireIDData = reinterpret_cast<geo::WireID const*>(buffer);
+  return table;
+
+} // geo::ChannelToWireTable::view()
+
+
+//------------------------------------------------------------------------------
+inline bool geo::ChannelToWireTable::validView
+  (std::byte const* buffer, std::size_t size)
+{
+  if (size < 2U * Word) return false;
+  std::uint64_t sizes[2];
+  std::memcpy(sizes, buffer, sizeof(sizes));
+
+  // checked one at a time, so that large values can't overflow the sum
+  std::size_t const available = size - 2U * Word;
+  if (sizes[0] > available / Word) return false;
+  if (sizes[1] > (available - sizes[0] * Word) / sizeof(geo::WireID))
+    return false;
+
+  ChannelToWireTable const table = view(buffer);
+  if (table.serializedSize() > size) return false;
+
+  if (table.fNOffsets == 0U) return table.fNWireIDs == 0U;
+  if (table.fOffsetData[0] != 0U) return false;
+  for (std::size_t i = 1U; i < table.fNOffsets; ++i) {
+    if (table.fOffsetData[i] < table.fOffsetData[i - 1]) return false;
+  }
+  return table.fOffsetData[table.fNOffsets - 1] == table.fNWireIDs;
+
+} // geo::ChannelToWireTable::validView()
+
+
+//------------------------------------------------------------------------------
+
+
+#endif // LARCORE_GEOMETRY_CHANNELTOWIRETABLE_H
@@ -0,0 +1,267 @@
+/**
+ * @file   larcore/Geometry/ColumnarFile.cc
+ * @brief  Simple binary file format for tables stored column by column.
+ * @see    larcore/Geometry/ColumnarFile.h
+ */
+
+// library header
+#include "larcore/Geometry/ColumnarFile.h"
+
+// framework libraries
+#include "cetlib_except/exception.h"
+
+// C/C++ standard libraries
+#include <fstream>
+#include <algorithm> // std::find_if(), std::copy_n()
+#include <iterator> // std::begin(), std::end()
+#include <cstring> // std::memcpy(), strnlen()
+
+
+//------------------------------------------------------------------------------
+namespace {
+
+  // the format is defined little-endian, and we write the native numbers
+  static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__,
+    "Columnar files are supported only on little-endian platforms");
+
+  /// Alignment of the column data in the file [bytes].
+  constexpr std::uint64_t DataAlignment = 8U;
+
+  /// Returns `offset` rounded up to the data alignment.
+  constexpr std::uint64_t aligned(std::uint64_t offset)
+    { return (offset + DataAlignment - 1U) / DataAlignment * DataAlignment; }
+
+  /// Appends the bytes of `value` to `buffer`.
+  template <typename T>
+  void append(std::vector<char>& buffer, T const& value) {
+    char const* const bytes = reinterpret_cast<char const*>(&value);
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(value));
+  }
+
+  /// Returns the value of type `T` at `offset` bytes in `data`.
+  template <typename T>
+  T extract(char const* data, std::size_t offset) {
+    T value;
+    std::memcpy(&value, data + offset, sizeof(value));
+    return value;
+  }
+
+  /// Returns the size of the elements of the specified `type` (0 if unknown).
+  std::uint32_t elementSize(geo::ColumnarFormat::Type_t type) {
+    using Type_t = geo::ColumnarFormat::Type_t;
+    switch (type) {
+      case Type_t::UInt32:  return sizeof(std::uint32_t);
+      case Type_t::UInt64:  return sizeof(std::uint64_t);
+      case Type_t::Float64: return sizeof(double);
+    } // switch
+    return 0U;
+  } // elementSize()
+
+} // local namespace
+
+
+//------------------------------------------------------------------------------
+//--- geo::ColumnarFileWriter
+//------------------------------------------------------------------------------
+void geo::ColumnarFileWriter::addRawColumn(
+  std::string const& name, ColumnarFormat::Type_t type,
+  std::uint32_t elementSize, std::uint64_t nElements, void const* data
+) {
+  if (name.empty() || (name.length() > ColumnarFormat::MaxNameLength)) {
+    throw cet::exception("ColumnarFile")
+      << "Invalid column name '" << name << "' (must have 1 to "
+      << ColumnarFormat::MaxNameLength << " characters).\n";
+  }
+  auto const sameName
+    = [&name](Column_t const& column){ return column.name == name; };
+  if (std::find_if(fColumns.begin(), fColumns.end(), sameName)
+    != fColumns.end())
+  {
+    throw cet::exception("ColumnarFile")
+      << "Column '" << name << "' added twice.\n";
+  }
+
+  Column_t column { name, type, elementSize, nElements, {} };
+  char const* const bytes = static_cast<char const*>(data);
+  column.data.assign(bytes, bytes + elementSize * nElements);
+  fColumns.push_back(std::move(column));
+} // geo::ColumnarFileWriter::addRawColumn()
+
+
+//------------------------------------------------------------------------------
+void geo::ColumnarFileWriter::write(std::string const& path) const {
+
+  //
+  // header and column directory
+  //
+  std::vector<char> header;
+  header.insert(header.end(),
+    std::begin(ColumnarFormat::Magic), std::end(ColumnarFormat::Magic));
+  append(header, ColumnarFormat::Version);
+  append(header, static_cast<std::uint32_t>(fColumns.size()));
+
+  std::uint64_t offset = aligned
+    (ColumnarFormat::HeaderSize + ColumnarFormat::DescriptorSize * fColumns.size());
+  std::vector<std::uint64_t> offsets;
+  for (Column_t const& column: fColumns) {
+    char name[ColumnarFormat::MaxNameLength + 1U] = {};
+    std::copy_n(column.name.data(), column.name.length(), name);
+    header.insert(header.end(), std::begin(name), std::end(name));
+    append(header, static_cast<std::uint32_t>(column.type));
+    append(header, column.elementSize);
+    append(header, column.nElements);
+    append(header, offset);
+    offsets.push_back(offset);
+    offset = aligned(offset + column.data.size());
+  } // for
+
+  //
+  // writing
+  //
+  std::ofstream out { path, std::ios::binary | std::ios::trunc };
+  if (!out) {
+    throw cet::exception("ColumnarFile")
+      << "Can't open output file '" << path << "'.\n";
+  }
+
+  out.write(header.data(), header.size());
+  std::uint64_t written = header.size();
+  for (std::size_t iColumn = 0; iColumn < fColumns.size(); ++iColumn) {
+    static constexpr char Padding[DataAlignment] = {};
+    std::vector<char> const& data = fColumns[iColumn].data;
+    out.write(Padding, offsets[iColumn] - written);
+    out.write(data.data(), data.size());
+    written = offsets[iColumn] + data.size();
+  } // for
+
+  out.close();
+  if (!out) {
+    throw cet::exception("ColumnarFile")
+      << "Error while writing output file '" << path << "'.\n";
+  }
+
+} // geo::ColumnarFileWriter::write()
+
+
+//------------------------------------------------------------------------------
+//--- geo::ColumnarFileReader
+//------------------------------------------------------------------------------
+geo::ColumnarFileReader::ColumnarFileReader(std::string const& path)
+  : fPath(path)
+{
+
+  std::ifstream in { path, std::ios::binary | std::ios::ate };
+  if (!in) {
+    throw cet::exception("ColumnarFile")
+      << "Can't open input file '" << path << "'.\n";
+  }
+  std::uint64_t const fileSize = in.tellg();
+  in.seekg(0);
+
+  // the buffer made of 64-bit words keeps the columns aligned
+  fBuffer.resize((fileSize + sizeof(std::uint64_t) - 1U) / sizeof(std::uint64_t));
+  char* const data = reinterpret_cast<char*>(fBuffer.data());
+  if (!in.read(data, fileSize)) {
+    throw cet::exception("ColumnarFile")
+      << "Error while reading input file '" << path << "'.\n";
+  }
+
+  //
+  // header
+  //
+  if ((fileSize < ColumnarFormat::HeaderSize)
+    || !std::equal(std::begin(ColumnarFormat::Magic),
+      std::end(ColumnarFormat::Magic), data)
+  ) {
+    throw cet::exception("ColumnarFile")
+      << "File '" << path << "' is not a columnar file.\n";
+  }
+  auto const version = extract<std::uint32_t>(data, 8U);
+  if (version != ColumnarFormat::Version) {
+    throw cet::exception("ColumnarFile")
+      << "File '" << path << "' has format version " << version
+      << " (only version " << ColumnarFormat::Version << " is supported).\n";
+  }
+  auto const nColumns = extract<std::uint32_t>(data, 12U);
+  if (ColumnarFormat::HeaderSize + ColumnarFormat::DescriptorSize * nColumns
+    > fileSize)
+  {
+    throw cet::exception("ColumnarFile")
+      << "File '" << path << "' is truncated (column directory).\n";
+  }
+
+  //
+  // column directory
+  //
+  fColumns.reserve(nColumns);
+  for (std::uint32_t iColumn = 0; iColumn < nColumns; ++iColumn) {
+    std::size_t const start
+      = ColumnarFormat::HeaderSize + ColumnarFormat::DescriptorSize * iColumn;
+    char const* const name = data + start;
+    ColumnInfo_t info {
+      std::string(name, ::strnlen(name, ColumnarFormat::MaxNameLength + 1U)),
+      static_cast<ColumnarFormat::Type_t>(extract<std::uint32_t>(data, start + 32U)),
+      extract<std::uint64_t>(data, start + 40U),
+      extract<std::uint64_t>(data, start + 48U)
+    };
+    auto const size = extract<std::uint32_t>(data, start + 36U);
+    if ((size == 0U) || (size != elementSize(info.type))) {
+      throw cet::exception("ColumnarFile")
+        << "Column '" << info.name << "' in file '" << path
+        << "' has unsupported type " << static_cast<std::uint32_t>(info.type)
+        << " (element size: " << size << ").\n";
+    }
+    // written so that corrupted offsets and sizes can't overflow
+    if ((info.offset % DataAlignment != 0U) || (info.offset > fileSize)
+      || (info.nElements > (fileSize - info.offset) / size))
+    {
+      throw cet::exception("ColumnarFile")
+        << "Column '" << info.name << "' in file '" << path
+        << "' is misplaced or truncated.\n";
+    }
+    fColumns.push_back(std::move(info));
+  } // for columns
+
+} // geo::ColumnarFileReader::ColumnarFileReader()
+
+
+//------------------------------------------------------------------------------
+std::vector<std::string> geo::ColumnarFileReader::columnNames() const {
+  std::vector<std::string> names;
+  names.reserve(fColumns.size());
+  for (ColumnInfo_t const& info: fColumns) names.push_back(info.name);
+  return names;
+} // geo::ColumnarFileReader::columnNames()
+
+
+//------------------------------------------------------------------------------
+auto geo::ColumnarFileReader::findColumn(std::string const& name) const
+  -> ColumnInfo_t const*
+{
+  auto const iColumn = std::find_if(fColumns.begin(), fColumns.end(),
+    [&name](ColumnInfo_t const& info){ return info.name == name; });
+  return (iColumn == fColumns.end())? nullptr: &*iColumn;
+} // geo::ColumnarFileReader::findColumn()
+
+
+//------------------------------------------------------------------------------
+auto geo::ColumnarFileReader::checkedColumn
+  (std::string const& name, ColumnarFormat::Type_t type) const
+  -> ColumnInfo_t const&
+{
+  ColumnInfo_t const* info = findColumn(name);
+  if (!info) {
+    throw cet::exception("ColumnarFile")
+      << "No column '" << name << "' in file '" << fPath << "'.\n";
+  }
+  if (info->type != type) {
+    throw cet::exception("ColumnarFile")
+      << "Column '" << name << "' in file '" << fPath << "' has type "
+      << static_cast<std::uint32_t>(info->type) << ", not "
+      << static_cast<std::uint32_t>(type) << ".\n";
+  }
+  return *info;
+} // geo::ColumnarFileReader::checkedColumn()
+
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,229 @@
+/**
+ * @file   larcore/Geometry/ColumnarFile.h
+ * @brief  Simple binary file format for tables stored column by column.
+ * @see    larcore/Geometry/ColumnarFile.cc
+ */
+
+#ifndef LARCORE_GEOMETRY_COLUMNARFILE_H
+#define LARCORE_GEOMETRY_COLUMNARFILE_H
+
+// LArSoft libraries
+#include "larcorealg/CoreUtils/span.h"
+
+// C/C++ standard libraries
+#include <vector>
+#include <string>
+#include <type_traits> // std::is_same_v
+#include <cstdint> // std::uint32_t, std::uint64_t
+#include <cstddef> // std::size_t
+
+
+namespace geo {
+
+  /**
+   * @brief Description of the binary columnar file format.
+   *
+   * A columnar file stores a set of named columns, each one an array of
+   * numbers of the same type. All numbers are little-endian. The file is:
+   *
+   * | offset | size    | content                                         |
+   * | ------:| -------:| ----------------------------------------------- |
+   * |      0 |       8 | magic string `LARCOLS` followed by a NUL        |
+   * |      8 |       4 | format version (`1`)                            |
+   * |     12 |       4 | number of columns _N_                           |
+   * |     16 |  56 _N_ | column directory: _N_ column descriptors        |
+   * |        |         | column data                                     |
+   *
+   * Each column descriptor is:
+   *
+   * | offset | size | content                                              |
+   * | ------:| ----:| ---------------------------------------------------- |
+   * |      0 |   32 | column name, NUL-padded                              |
+   * |     32 |    4 | element type (`geo::ColumnarFormat::Type_t`)         |
+   * |     36 |    4 | element size [bytes]                                 |
+   * |     40 |    8 | number of elements                                   |
+   * |     48 |    8 | offset of the first element from the start of file  |
+   *
+   * The data of each column starts at an offset which is a multiple of 8
+   * bytes, so that a memory-mapped file can be accessed in place.
+   * Columns in the same file may have different lengths.
+   */
+  struct ColumnarFormat {
+
+    /// Types of column elements.
+    enum class Type_t: std::uint32_t {
+      UInt32  = 1, ///< `std::uint32_t`
+      UInt64  = 2, ///< `std::uint64_t`
+      Float64 = 3  ///< `double`
+    }; // Type_t
+
+    /// Magic string at the start of the file (including the final NUL).
+    static constexpr char Magic[8] = "LARCOLS";
+
+    /// Current version of the format.
+    static constexpr std::uint32_t Version = 1U;
+
+    /// Maximum length of a column name (excluding the final NUL).
+    static constexpr std::size_t MaxNameLength = 31U;
+
+    /// Size of the file header before the column directory [bytes].
+    static constexpr std::size_t HeaderSize = 16U;
+
+    /// Size of a column descriptor [bytes].
+    static constexpr std::size_t DescriptorSize = 56U;
+
+    /// Conventional value of 32-bit index columns for invalid entries.
+    static constexpr std::uint32_t InvalidIndex = 0xFFFFFFFFU;
+
+    /// Returns the type code of element type `T`.
+    template <typename T>
+    static constexpr Type_t typeOf();
+
+  }; // struct ColumnarFormat
+
+
+  /**
+   * @brief Writes a columnar file (see `geo::ColumnarFormat`).
+   *
+   * Example:
+   * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+   * geo::ColumnarFileWriter writer;
+   * writer.addColumn("channel", channels); // a std::vector<std::uint32_t>
+   * writer.write("channels.lcol");
+   * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+   * The data of the columns is copied when added.
+   * Errors are reported by throwing `cet::exception` (category:
+   * `"ColumnarFile"`).
+   */
+  class ColumnarFileWriter {
+
+      public:
+
+    /// Adds a column with the specified `name` and `data`.
+    template <typename T>
+    void addColumn(std::string const& name, std::vector<T> const& data);
+
+    /// Writes all the columns into the file at `path`.
+    void write(std::string const& path) const;
+
+
+      private:
+
+    /// A column ready to be written.
+    struct Column_t {
+      std::string name; ///< Name of the column.
+      ColumnarFormat::Type_t type; ///< Type of the elements.
+      std::uint32_t elementSize; ///< Size of each element [bytes].
+      std::uint64_t nElements; ///< Number of elements.
+      std::vector<char> data; ///< Content of the column.
+    }; // Column_t
+
+    std::vector<Column_t> fColumns; ///< All the columns.
+
+    /// Adds a column with the raw content of `data`.
+    void addRawColumn(
+      std::string const& name, ColumnarFormat::Type_t type,
+      std::uint32_t elementSize, std::uint64_t nElements, void const* data
+      );
+
+  }; // class ColumnarFileWriter
+
+
+  /**
+   * @brief Reads a columnar file (see `geo::ColumnarFormat`).
+   *
+   * The whole file is read into memory at construction. Columns are then
+   * available as ranges of elements of the appropriate type (`column()`).
+   * Errors are reported by throwing `cet::exception` (category:
+   * `"ColumnarFile"`).
+   */
+  class ColumnarFileReader {
+
+      public:
+
+    /// Reads the file at `path`.
+    explicit ColumnarFileReader(std::string const& path);
+
+    /// Returns the names of all the columns, in file order.
+    std::vector<std::string> columnNames() const;
+
+    /// Returns whether a column named `name` is present.
+    bool hasColumn(std::string const& name) const
+      { return findColumn(name) != nullptr; }
+
+    /**
+     * @brief Returns the elements of the column `name`.
+     * @tparam T type of the elements
+     * @param name name of the column
+     * @return a range of the elements, valid as long as this object is
+     * @throw cet::exception if the column is missing or not of type `T`
+     */
+    template <typename T>
+    util::span<T const*> column(std::string const& name) const;
+
+
+      private:
+
+    /// Description of a column in the file.
+    struct ColumnInfo_t {
+      std::string name; ///< Name of the column.
+      ColumnarFormat::Type_t type; ///< Type of the elements.
+      std::uint64_t nElements; ///< Number of elements.
+      std::uint64_t offset; ///< Offset of the data from the start of file.
+    }; // ColumnInfo_t
+
+    std::string fPath; ///< Path of the file.
+    std::vector<std::uint64_t> fBuffer; ///< Content of the file (aligned).
+    std::vector<ColumnInfo_t> fColumns; ///< All the columns.
+
+    /// Returns the column named `name`, `nullptr` if not present.
+    ColumnInfo_t const* findColumn(std::string const& name) const;
+
+    /// Returns the column named `name` checking its type is `type`.
+    ColumnInfo_t const& checkedColumn
+      (std::string const& name, ColumnarFormat::Type_t type) const;
+
+  }; // class ColumnarFileReader
+
+
+} // namespace geo
+
+
+//------------------------------------------------------------------------------
+//--- template implementation
+//------------------------------------------------------------------------------
+template <typename T>
+constexpr auto geo::ColumnarFormat::typeOf() -> Type_t {
+  if constexpr(std::is_same_v<T, std::uint32_t>) return Type_t::UInt32;
+  else if constexpr(std::is_same_v<T, std::uint64_t>) return Type_t::UInt64;
+  else if constexpr(std::is_same_v<T, double>) return Type_t::Float64;
+  else static_assert(sizeof(T) == 0U, "Unsupported column element type.");
+} // geo::ColumnarFormat::typeOf()
+
+
+//------------------------------------------------------------------------------
+template <typename T>
+void geo::ColumnarFileWriter::addColumn
+  (std::string const& name, std::vector<T> const& data)
+{
+  addRawColumn(name, ColumnarFormat::typeOf<T>(), sizeof(T), data.size(),
+    data.data());
+} // geo::ColumnarFileWriter::addColumn()
+
+
+//------------------------------------------------------------------------------
+template <typename T>
+util::span<T const*> geo::ColumnarFileReader::column
+  (std::string const& name) const
+{
+  ColumnInfo_t const& info = checkedColumn(name, ColumnarFormat::typeOf<T>());
+  T const* const begin = reinterpret_cast<T const*>
+    (reinterpret_cast<char const*>(fBuffer.data()) + info.offset);
+  return { begin, begin + info.nElements };
+} // geo::ColumnarFileReader::column()
+
+
+//------------------------------------------------------------------------------
+
+
+#endif // LARCORE_GEOMETRY_COLUMNARFILE_H
@@ -0,0 +1,342 @@
+/**
+ * @file    DumpChannelMapDiff_module.cc
+ * @brief   Prints the differences between the current and another channel map
+ * @see     DumpChannelMap_module.cc
+ *
+ */
+
+// LArSoft libraries
+#include "larcoreobj/SimpleTypesAndConstants/RawTypes.h" // raw::ChannelID_t
+
+// framework libraries
+#include "art/Framework/Core/EDAnalyzer.h"
+#include "art/Framework/Core/ModuleMacros.h"
+#include "fhiclcpp/types/Atom.h"
+#include "fhiclcpp/types/OptionalDelegatedParameter.h"
+#include "fhiclcpp/ParameterSet.h"
+
+// C/C++ standard libraries
+#include <string>
+
+// ... more follow
+
+namespace geo {
+  class DumpChannelMapDiff;
+}
+
+/** ****************************************************************************
+ * @brief Prints the channels mapped differently by an alternative channel map.
+ *
+ * This module compares the channel mapping of the geometry service with an
+ * alternative one, built in the same job on the same detector geometry, and
+ * prints only the channels whose set of wires differs between the two.
+ * A summary with the number of differing channels is printed at the end.
+ * The comparison is performed at the beginning of each run.
+ *
+ * The alternative channel mapping can be created either:
+ *
+ * * by the configured `geo::ExptGeoHelperInterface` service, with different
+ *   sorting parameters (`SortingParameters`); or
+ * * by an art tool implementing `geo::ChannelMapSetupTool`
+ *   (`ChannelMapTool`), which allows to compare with a different channel
+ *   mapping algorithm.
+ *
+ * The channel range is split into chunks of `ChunkSize` channels. Each chunk
+ * is processed concurrently with the others: both channel maps are queried
+ * for the wires of each of its channels, and the results are compared. The
+ * differences are printed in channel order as soon as each chunk is complete.
+ * No table of either map is filled in advance.
+ *
+ *
+ * Configuration parameters
+ * =========================
+ *
+ * - *SortingParameters* (parameter set, optional): sorting parameters for an
+ *   alternative channel mapping created by the channel mapping helper service
+ * - *ChannelMapTool* (parameter set, optional): configuration of an art tool
+ *   creating the alternative channel mapping; exactly one between this and
+ *   `SortingParameters` must be specified
+ * - *ChunkSize* (integer, default: 4096): number of channels compared
+ *   together
+ * - *MaxDifferences* (integer, default: no limit): if more channels than this
+ *   differ, an exception is thrown after the comparison (`0` requires the two
+ *   maps to be identical)
+ * - *ExpectedDifferences* (integer, default: no check): if not negative, an
+ *   exception is thrown after the comparison unless exactly this many
+ *   channels differ (mostly for tests)
+ * - *OutputCategory* (string, default: DumpChannelMapDiff): output category
+ *   used by the message facility to output information (INFO level)
+ *
+ */
+class geo::DumpChannelMapDiff: public art::EDAnalyzer {
+    public:
+
+  struct Config {
+    using Name = fhicl::Name;
+    using Comment = fhicl::Comment;
+
+    fhicl::OptionalDelegatedParameter SortingParameters {
+      Name("SortingParameters"),
+      Comment("sorting parameters for the alternative channel map")
+      };
+
+    fhicl::OptionalDelegatedParameter ChannelMapTool {
+      Name("ChannelMapTool"),
+      Comment("tool creating the alternative channel map")
+      };
+
+    fhicl::Atom<unsigned int> ChunkSize {
+      Name("ChunkSize"),
+      Comment("number of channels compared together"),
+      4096U
+      };
+
+    fhicl::Atom<int> MaxDifferences {
+      Name("MaxDifferences"),
+      Comment
+        ("throw if more channels than this differ (negative: no limit)"),
+      -1
+      };
+
+    fhicl::Atom<int> ExpectedDifferences {
+      Name("ExpectedDifferences"),
+      Comment
+        ("throw unless exactly this many channels differ (negative: no check)"),
+      -1
+      };
+
+    fhicl::Atom<std::string> OutputCategory {
+      Name("OutputCategory"),
+      Comment("output category used by the message facility"),
+      "DumpChannelMapDiff"
+      };
+
+  }; // Config
+
+  using Parameters = art::EDAnalyzer::Table<Config>;
+
+
+  explicit DumpChannelMapDiff(Parameters const& config);
+
+  // Plugins should not be copied or assigned.
+  DumpChannelMapDiff(DumpChannelMapDiff const &) = delete;
+  DumpChannelMapDiff(DumpChannelMapDiff &&) = delete;
+  DumpChannelMapDiff & operator = (DumpChannelMapDiff const &) = delete;
+  DumpChannelMapDiff & operator = (DumpChannelMapDiff &&) = delete;
+
+  // Required functions
+  virtual void analyze(art::Event const&) override {}
+
+  /// Drives the comparison
+  virtual void beginRun(art::Run const&) override;
+
+    private:
+
+  fhicl::ParameterSet SortingParameters; ///< Alternative sorting parameters.
+  fhicl::ParameterSet ChannelMapTool; ///< Alternative channel map tool.
+  bool UseTool; ///< Whether the alternative map is from `ChannelMapTool`.
+
+  unsigned int ChunkSize; ///< Channels compared together.
+  int MaxDifferences; ///< Maximum allowed number of differing channels.
+  int ExpectedDifferences; ///< Expected number of differing channels.
+  std::string OutputCategory; ///< Name of the category for output.
+
+}; // geo::DumpChannelMapDiff
+
+
+//==============================================================================
+//=== Module implementation
+//===
+
+// LArSoft libraries
+#include "larcore/Geometry/Geometry.h"
+#include "larcore/Geometry/ChannelMapSetupTool.h"
+#include "larcorealg/Geometry/GeometryCore.h"
+#include "larcorealg/Geometry/ChannelMapAlg.h"
+#include "larcoreobj/SimpleTypesAndConstants/geo_types.h" // geo::WireID
+
+// framework libraries
+#include "art/Framework/Services/Registry/ServiceHandle.h"
+#include "art/Utilities/make_tool.h"
+#include "messagefacility/MessageLogger/MessageLogger.h"
+#include "canvas/Utilities/Exception.h"
+
+// TBB libraries
+#include "tbb/pipeline.h"
+#include "tbb/task_arena.h" // tbb::this_task_arena
+
+// C/C++ standard libraries
+#include <sstream>
+#include <vector>
+#include <algorithm> // std::min(), std::max(), std::sort()
+#include <memory> // std::unique_ptr
+
+//------------------------------------------------------------------------------
+namespace {
+
+  /// Returns the wires of `channel` in `geom`, sorted (none if not present).
+  std::vector<geo::WireID> sortedWires
+    (geo::GeometryCore const& geom, raw::ChannelID_t channel)
+  {
+    // the channel mapping algorithms may throw on channels they don't have
+    if (channel >= geom.Nchannels()) return {};
+    std::vector<geo::WireID> sorted = geom.ChannelToWire(channel);
+    std::sort(sorted.begin(), sorted.end());
+    return sorted;
+  } // sortedWires()
+
+
+  /// Prints the wires in `wires` into `out`.
+  template <typename Stream>
+  void printWires(Stream& out, std::vector<geo::WireID> const& wires) {
+    if (wires.empty()) {
+      out << " (none)";
+      return;
+    }
+    for (geo::WireID const& wireID: wires) out << " { " << wireID << " };";
+  } // printWires()
+
+} // local namespace
+
+
+//------------------------------------------------------------------------------
+geo::DumpChannelMapDiff::DumpChannelMapDiff(Parameters const& config)
+  : art::EDAnalyzer(config)
+  , UseTool         (config().ChannelMapTool.hasValue())
+  , ChunkSize       (config().ChunkSize())
+  , MaxDifferences  (config().MaxDifferences())
+  , ExpectedDifferences(config().ExpectedDifferences())
+  , OutputCategory  (config().OutputCategory())
+{
+  if (UseTool == config().SortingParameters.hasValue()) {
+    throw art::Exception(art::errors::Configuration)
+      << "DumpChannelMapDiff: exactly one between `SortingParameters` and"
+      " `ChannelMapTool` must be specified.\n";
+  }
+  if (ChunkSize == 0U) {
+    throw art::Exception(art::errors::Configuration)
+      << "DumpChannelMapDiff: `ChunkSize` must be positive.\n";
+  }
+
+  if (UseTool)
+    config().ChannelMapTool.get_if_present(ChannelMapTool);
+  else
+    config().SortingParameters.get_if_present(SortingParameters);
+
+} // geo::DumpChannelMapDiff::DumpChannelMapDiff()
+
+
+//------------------------------------------------------------------------------
+void geo::DumpChannelMapDiff::beginRun(art::Run const&) {
+
+  art::ServiceHandle<geo::Geometry const> geometry;
+
+  //
+  // set up the alternative channel map
+  //
+  std::unique_ptr<geo::ChannelMapAlg> channelMap;
+  if (UseTool) {
+    channelMap
+      = art::make_tool<geo::ChannelMapSetupTool>(ChannelMapTool)
+      ->setupChannelMap();
+    if (!channelMap) {
+      throw cet::exception("ChannelMapLoadFail")
+        << "DumpChannelMapDiff: the channel map tool returned no channel map.\n";
+    }
+  }
+  else channelMap = geometry->MakeChannelMapAlg(SortingParameters);
+
+  std::unique_ptr<geo::GeometryCore const> const altGeom
+    = geometry->MakeGeometryWithChannelMap(std::move(channelMap));
+
+  // both maps are queried via their algorithms, not via the service tables
+  geo::GeometryCore const& refGeom = *geometry;
+
+  //
+  // compare, chunk by chunk
+  //
+  raw::ChannelID_t const NChannels
+    = std::max(refGeom.Nchannels(), altGeom->Nchannels());
+
+  mf::LogInfo(OutputCategory)
+    << "Comparing the channel map of " << NChannels << " channels ("
+    << refGeom.Nchannels() << " in the current map, "
+    << altGeom->Nchannels() << " in the alternative one)";
+
+  struct Chunk_t {
+    raw::ChannelID_t first = 0; ///< first channel in the chunk
+    raw::ChannelID_t last = 0; ///< last channel in the chunk (included)
+    unsigned int nDifferences = 0U; ///< channels differing in the chunk
+    std::string text; ///< description of the differences
+  };
+
+  std::size_t const maxChunks = 2 * tbb::this_task_arena::max_concurrency();
+
+  raw::ChannelID_t next = 0;
+  unsigned int nDifferences = 0U;
+  tbb::parallel_pipeline(maxChunks,
+    tbb::make_filter<void, Chunk_t>(tbb::filter::serial_in_order,
+      [&next, NChannels, this](tbb::flow_control& fc) -> Chunk_t {
+        if (next >= NChannels) {
+          fc.stop();
+          return {};
+        }
+        Chunk_t chunk;
+        chunk.first = next;
+        // no overflow even close to the largest channel ID
+        chunk.last
+          = next + std::min<raw::ChannelID_t>(ChunkSize, NChannels - next) - 1;
+        next = chunk.last + 1;
+        return chunk;
+      })
+    & tbb::make_filter<Chunk_t, Chunk_t>(tbb::filter::parallel,
+      [&refGeom, &altGeom](Chunk_t chunk) -> Chunk_t {
+        std::ostringstream out;
+        for (raw::ChannelID_t channel = chunk.first; channel <= chunk.last;
+          ++channel
+        ) {
+          std::vector<geo::WireID> const refWires
+            = sortedWires(refGeom, channel);
+          std::vector<geo::WireID> const altWires
+            = sortedWires(*altGeom, channel);
+          if (refWires == altWires) continue;
+          ++chunk.nDifferences;
+          out << "\n " << channel << ":\n   current:    ";
+          printWires(out, refWires);
+          out << "\n   alternative:";
+          printWires(out, altWires);
+        } // for
+        chunk.text = out.str();
+        return chunk;
+      })
+    & tbb::make_filter<Chunk_t, void>(tbb::filter::serial_in_order,
+      [&nDifferences, this](Chunk_t const& chunk) {
+        if (chunk.nDifferences == 0U) return;
+        nDifferences += chunk.nDifferences;
+        mf::LogVerbatim(OutputCategory) << chunk.text;
+      })
+    );
+
+  mf::LogInfo(OutputCategory)
+    << nDifferences << " / " << NChannels << " channels are mapped differently.";
+
+  if ((MaxDifferences >= 0) && (nDifferences > (unsigned int) MaxDifferences)) {
+    throw cet::exception("DumpChannelMapDiff")
+      << nDifferences << " channels are mapped differently (at most "
+      << MaxDifferences << " allowed).\n";
+  }
+  if ((ExpectedDifferences >= 0)
+    && (nDifferences != (unsigned int) ExpectedDifferences))
+  {
+    throw cet::exception("DumpChannelMapDiff")
+      << nDifferences << " channels are mapped differently ("
+      << ExpectedDifferences << " expected).\n";
+  }
+
+} // geo::DumpChannelMapDiff::beginRun()
+
+
+//------------------------------------------------------------------------------
+DEFINE_ART_MODULE(geo::DumpChannelMapDiff)
+
+//==============================================================================
@@ -22,6 +22,7 @@
 namespace geo {
   class DumpChannelMap;
   class GeometryCore;
+  class OpDetChannelTable;
 }
 
 /** ****************************************************************************
@@ -45,6 +46,52 @@ namespace geo {
  *   printed
  * - *OutputCategory* (string, default: DumpChannelMap): output category used
  *   by the message facility to output information (INFO level)
+ * - *OutputFile* (string, default: empty): if specified, the channel-to-wires
+ *   map is written into this file rather than through the message facility;
+ *   see below
+ * - *ChunkSize* (integer, default: 4096): number of channels formatted
+ *   together when writing into `OutputFile`
+ * - *ExportPrefix* (string, default: empty): if specified, the channel
+ *   mapping tables are also exported in binary columnar files whose path
+ *   starts with this prefix; see below
+ *
+ *
+ * Streaming output
+ * -----------------
+ *
+ * Dumping the channel-to-wires map of a large detector as a single message
+ * takes a long time, and the whole message needs to be kept in memory.
+ * When `OutputFile` is specified, the channel range is split into chunks of
+ * `ChunkSize` channels, which are formatted concurrently and written into the
+ * file in order as soon as they are ready. Only a few chunks (a small multiple
+ * of the available threads) are held in memory at any time.
+ * The content of the file is the same as the one of the message.
+ *
+ *
+ * Binary export
+ * --------------
+ *
+ * When `ExportPrefix` is specified, three binary files are written in the
+ * columnar format described in `geo::ColumnarFormat`
+ * (`larcore/Geometry/ColumnarFile.h`), and can be read back with
+ * `geo::ColumnarFileReader`. The export is independent of the other options.
+ *
+ * * `<ExportPrefix>channel_to_wires.lcol`: the wires of each channel, as
+ *   in `geo::GeometryCore::ChannelToWire()`; the wires of channel `c` are
+ *   the elements from `offset[c]` (included) to `offset[c+1]` (excluded) of
+ *   the other columns:
+ *     * `offset` (64-bit, one per channel plus one)
+ *     * `cryostat`, `tpc`, `plane`, `wire` (32-bit, one per wire)
+ * * `<ExportPrefix>wire_to_channel.lcol`: the channel of each wire, as in
+ *   `geo::GeometryCore::PlaneWireToChannel()`, one row per wire in the order
+ *   of `geo::GeometryCore::IterateWireIDs()`:
+ *     * `cryostat`, `tpc`, `plane`, `wire`, `channel` (32-bit)
+ * * `<ExportPrefix>opchannel_to_opdet.lcol`: the optical detector of each
+ *   optical channel, as in `geo::GeometryCore::OpDetGeoFromOpChannel()`, one
+ *   row per optical channel number (invalid channels have all the IDs set to
+ *   `geo::ColumnarFormat::InvalidIndex` and a center at the origin):
+ *     * `cryostat`, `opdet` (32-bit)
+ *     * `center_x`, `center_y`, `center_z` (double precision, centimeters)
  *
  */
 
@@ -97,6 +144,26 @@ public:
       raw::InvalidChannelID
       };
     
+    fhicl::Atom<std::string> OutputFile {
+      Name("OutputFile"),
+      Comment
+        ("write the channel-to-wires map into this file (default: message)"),
+      ""
+      };
+    
+    fhicl::Atom<unsigned int> ChunkSize {
+      Name("ChunkSize"),
+      Comment("number of channels formatted together when writing to file"),
+      4096U
+      };
+    
+    fhicl::Atom<std::string> ExportPrefix {
+      Name("ExportPrefix"),
+      Comment
+        ("export the maps into binary columnar files with this path prefix"),
+      ""
+      };
+    
   }; // Config
   
   using Parameters = art::EDAnalyzer::Table<Config>;
@@ -126,6 +193,11 @@ public:
   raw::ChannelID_t FirstChannel; ///< First channel to be printed.
   raw::ChannelID_t LastChannel; ///< Last channel to be printed.
 
+  std::string OutputFile; ///< File for the channel-to-wires map (if any).
+  unsigned int ChunkSize; ///< Channels formatted together in streaming mode.
+
+  std::string ExportPrefix; ///< Path prefix of the binary export (if any).
+
 }; // geo::DumpChannelMap
 
 
@@ -136,6 +208,7 @@ public:
 namespace geo {
   class GeometryCore;
   class OpDetGeo;
+  class ChannelToWireTable;
 } // namespace geo
 
 namespace {
@@ -151,27 +224,47 @@ namespace {
       {}
 
     /// Sets up the required environment
-    void Setup(geo::GeometryCore const& geometry)
-      { pGeom = &geometry; }
+    void Setup(
+      geo::GeometryCore const& geometry,
+      geo::ChannelToWireTable const& channelToWires
+      )
+      { pGeom = &geometry; pChannelToWires = &channelToWires; }
 
     /// Sets the lowest and highest channel ID to be printed (inclusive)
     void SetLimits
       (raw::ChannelID_t first_channel, raw::ChannelID_t last_channel)
       { FirstChannel = first_channel; LastChannel = last_channel; }
 
+    /// Sets the dump to go into the file at `path`, `chunkSize` channels
+    /// at a time (an empty `path` restores the dump via message facility)
+    void SetOutputFile(std::string path, unsigned int chunkSize)
+      { OutputFile = std::move(path); ChunkSize = chunkSize; }
+
     /// Dumps to the specified output category
     void Dump(std::string OutputCategory) const;
 
 
       protected:
     geo::GeometryCore const* pGeom = nullptr; ///< pointer to geometry
+    /// Wires of each channel.
+    geo::ChannelToWireTable const* pChannelToWires = nullptr;
 
     raw::ChannelID_t FirstChannel; ///< lowest channel to be printed
     raw::ChannelID_t LastChannel; ///< highest channel to be printed
 
+    std::string OutputFile; ///< file to write the dump into (if any)
+    unsigned int ChunkSize = 4096U; ///< channels formatted together
+
     /// Throws an exception if the object is not ready to dump
     void CheckConfig() const;
 
+    /// Prints the wires of `channel` into `out`
+    template <typename Stream>
+    void PrintChannel(Stream& out, raw::ChannelID_t channel) const;
+
+    /// Writes the channels from `first` to `last` into `OutputFile`
+    void DumpToFile(raw::ChannelID_t first, raw::ChannelID_t last) const;
+
   }; // class DumpChannelToWires
 
 
@@ -207,8 +300,9 @@ namespace {
     DumpOpticalDetectorChannels() {}
 
     /// Sets up the required environment
-    void Setup(geo::GeometryCore const& geometry)
-      { pGeom = &geometry; }
+    void Setup
+      (geo::GeometryCore const& geometry, geo::OpDetChannelTable const& opDets)
+      { pGeom = &geometry; pOpDets = &opDets; }
 
     /// Dumps to the specified output category
     void Dump(std::string OutputCategory) const;
@@ -216,6 +310,8 @@ namespace {
 
       protected:
     geo::GeometryCore const* pGeom = nullptr; ///< pointer to geometry
+    /// Optical detector of each channel.
+    geo::OpDetChannelTable const* pOpDets = nullptr;
 
     /// Throws an exception if the object is not ready to dump
     void CheckConfig() const;
@@ -227,6 +323,44 @@ namespace {
   }; // class DumpOpticalDetectorChannels
 
 
+  /// Exports the channel mapping tables into binary columnar files.
+  class ExportChannelMapColumns {
+      public:
+
+    /// Sets up the required environment
+    void Setup(
+      geo::GeometryCore const& geometry,
+      geo::ChannelToWireTable const& channelToWires,
+      geo::OpDetChannelTable const& opDets
+      )
+      { pGeom = &geometry; pChannelToWires = &channelToWires; pOpDets = &opDets; }
+
+    /// Writes all the tables into files with the specified path `prefix`
+    void Export(std::string const& prefix, std::string OutputCategory) const;
+
+
+      protected:
+    geo::GeometryCore const* pGeom = nullptr; ///< pointer to geometry
+    /// Wires of each channel.
+    geo::ChannelToWireTable const* pChannelToWires = nullptr;
+    /// Optical detector of each channel.
+    geo::OpDetChannelTable const* pOpDets = nullptr;
+
+    /// Throws an exception if the object is not ready to export
+    void CheckConfig() const;
+
+    /// Writes the channel-to-wires table into `path`
+    void ExportChannelToWires(std::string const& path) const;
+
+    /// Writes the wire-to-channel table into `path`
+    void ExportWireToChannel(std::string const& path) const;
+
+    /// Writes the optical channel-to-detector table into `path`
+    void ExportOpDetChannels(std::string const& path) const;
+
+  }; // class ExportChannelMapColumns
+
+
 } // local namespace
 
 
@@ -251,19 +385,28 @@ geo::DumpChannelMap::DumpChannelMap(Parameters const& config)
   , DoOpDetChannels (config().OpDetChannels())
   , FirstChannel    (config().FirstChannel())
   , LastChannel     (config().LastChannel())
+  , OutputFile      (config().OutputFile())
+  , ChunkSize       (config().ChunkSize())
+  , ExportPrefix    (config().ExportPrefix())
 {
+  if (ChunkSize == 0U) {
+    throw art::Exception(art::errors::Configuration)
+      << "DumpChannelMap: `ChunkSize` must be positive.\n";
+  }
 
 } // geo::DumpChannelMap::DumpChannelMap()
 
 //------------------------------------------------------------------------------
 void geo::DumpChannelMap::beginRun(art::Run const&) {
 
-  geo::GeometryCore const& geom = *(art::ServiceHandle<geo::Geometry const>());
+  art::ServiceHandle<geo::Geometry const> geometry;
+  geo::GeometryCore const& geom = *geometry;
 
   if (DoChannelToWires) {
     DumpChannelToWires dumper;
-    dumper.Setup(geom);
+    dumper.Setup(geom, geometry->ChannelToWireMap());
     dumper.SetLimits(FirstChannel, LastChannel);
+    dumper.SetOutputFile(OutputFile, ChunkSize);
     dumper.Dump(OutputCategory);
   }
 
@@ -276,10 +419,17 @@ void geo::DumpChannelMap::beginRun(art::Run const&) {
 
   if (DoOpDetChannels) {
     DumpOpticalDetectorChannels dumper;
-    dumper.Setup(geom);
+    dumper.Setup(geom, geometry->OpDetChannelMap());
     dumper.Dump(OutputCategory);
   }
 
+  if (!ExportPrefix.empty()) {
+    ExportChannelMapColumns exporter;
+    exporter.Setup
+      (geom, geometry->ChannelToWireMap(), geometry->OpDetChannelMap());
+    exporter.Export(ExportPrefix, OutputCategory);
+  }
+
 } // geo::DumpChannelMap::beginRun()
 
 //------------------------------------------------------------------------------
@@ -290,6 +440,9 @@ DEFINE_ART_MODULE(geo::DumpChannelMap)
 //===
 
 // LArSoft libraries
+#include "larcore/Geometry/ColumnarFile.h"
+#include "larcore/Geometry/ChannelToWireTable.h"
+#include "larcore/Geometry/OpDetChannelTable.h"
 #include "larcoreobj/SimpleTypesAndConstants/geo_types.h" // geo::WireID
 #include "larcorealg/Geometry/GeometryCore.h"
 
@@ -297,7 +450,16 @@ DEFINE_ART_MODULE(geo::DumpChannelMap)
 #include "messagefacility/MessageLogger/MessageLogger.h"
 #include "canvas/Utilities/Exception.h"
 
+// TBB libraries
+#include "tbb/pipeline.h"
+#include "tbb/task_arena.h" // tbb::this_task_arena
+
 // C/C++ standard libraries
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <algorithm> // std::min()
+#include <cstdint> // std::uint64_t, std::uint32_t
 
 //------------------------------------------------------------------------------
 //--- DumpChannelToWires
@@ -305,7 +467,7 @@ DEFINE_ART_MODULE(geo::DumpChannelMap)
 void DumpChannelToWires::CheckConfig() const {
 
   /// check that the configuration is complete
-  if (!pGeom) {
+  if (!pGeom || !pChannelToWires) {
     throw art::Exception(art::errors::LogicError)
       << "DumpChannelToWires: no valid geometry available!";
   }
@@ -343,23 +505,107 @@ void DumpChannelToWires::Dump(std::string OutputCategory) const {
   }
 
   // print map
+  if (!OutputFile.empty()) {
+    DumpToFile(PrintFirst, PrintLast);
+    mf::LogInfo(OutputCategory)
+      << "Channel map written into '" << OutputFile << "'";
+    return;
+  }
+
   mf::LogVerbatim log(OutputCategory);
-  for (raw::ChannelID_t channel = PrintFirst; channel <= PrintLast; ++channel) {
-    std::vector<geo::WireID> const Wires = pGeom->ChannelToWire(channel);
+  for (raw::ChannelID_t channel = PrintFirst; channel <= PrintLast; ++channel)
+    PrintChannel(log, channel);
 
-    log << "\n " << ((int) channel) << " ->";
-    switch (Wires.size()) {
-      case 0:  log << " no wires";                       break;
-      case 1:                                            break;
-      default: log << " [" << Wires.size() << " wires]"; break;
-    } // switch
+} // DumpChannelToWires::Dump()
 
-    for (geo::WireID const& wireID: Wires)
-      log << " { " << std::string(wireID) << " };";
+//------------------------------------------------------------------------------
+template <typename Stream>
+void DumpChannelToWires::PrintChannel
+  (Stream& out, raw::ChannelID_t channel) const
+{
+  geo::ChannelToWireTable::WireIDs_t const Wires
+    = pChannelToWires->wires(channel);
 
-  } // for (channels)
+  out << "\n " << ((int) channel) << " ->";
+  switch (Wires.size()) {
+    case 0:  out << " no wires";                       break;
+    case 1:                                            break;
+    default: out << " [" << Wires.size() << " wires]"; break;
+  } // switch
 
-} // DumpChannelToWires::Dump()
+  for (geo::WireID const& wireID: Wires) out << " { " << wireID << " };";
+
+} // DumpChannelToWires::PrintChannel()
+
+//------------------------------------------------------------------------------
+void DumpChannelToWires::DumpToFile
+  (raw::ChannelID_t first, raw::ChannelID_t last) const
+{
+  std::ofstream out { OutputFile };
+  if (!out) {
+    throw art::Exception(art::errors::FileOpenError)
+      << "DumpChannelToWires: can't open '" << OutputFile << "' for writing.\n";
+  }
+
+  /*
+   * Three-stage pipeline:
+   * 1. split the channel range into chunks (serial)
+   * 2. format each chunk into its own buffer (parallel)
+   * 3. write the buffers into the file (serial, in the original order)
+   * The number of chunks in flight, and therefore the memory, is limited.
+   */
+  struct Chunk_t {
+    raw::ChannelID_t first; ///< first channel in the chunk
+    raw::ChannelID_t last; ///< last channel in the chunk (included)
+    std::string text; ///< formatted output
+  }; // Chunk_t
+
+  std::size_t const maxChunks = 2 * tbb::this_task_arena::max_concurrency();
+
+  raw::ChannelID_t next = first;
+  bool done = false;
+  tbb::parallel_pipeline(maxChunks,
+    tbb::make_filter<void, Chunk_t>(tbb::filter::serial_in_order,
+      [this, &next, &done, last](tbb::flow_control& control) -> Chunk_t
+      {
+        if (done) {
+          control.stop();
+          return {};
+        }
+        std::uint64_t const chunkLast = std::min
+          (std::uint64_t(last), std::uint64_t(next) + ChunkSize - 1U);
+        Chunk_t chunk { next, raw::ChannelID_t(chunkLast), {} };
+        if (chunk.last == last) done = true;
+        else next = chunk.last + 1;
+        return chunk;
+      }
+      )
+    & tbb::make_filter<Chunk_t, Chunk_t>(tbb::filter::parallel,
+      [this](Chunk_t chunk) -> Chunk_t
+      {
+        std::ostringstream sstr;
+        for (raw::ChannelID_t channel = chunk.first; channel <= chunk.last;
+          ++channel
+        ) {
+          PrintChannel(sstr, channel);
+        }
+        chunk.text = sstr.str();
+        return chunk;
+      }
+      )
+    & tbb::make_filter<Chunk_t, void>(tbb::filter::serial_in_order,
+      [&out](Chunk_t const& chunk){ out << chunk.text; }
+      )
+    );
+
+  out << "\n";
+  if (!out) {
+    throw art::Exception(art::errors::FileWriteError)
+      << "DumpChannelToWires: error while writing into '" << OutputFile
+      << "'.\n";
+  }
+
+} // DumpChannelToWires::DumpToFile()
 
 //------------------------------------------------------------------------------
 //--- DumpWireToChannel
@@ -410,7 +656,7 @@ void DumpWireToChannel::Dump(std::string OutputCategory) const {
 void DumpOpticalDetectorChannels::CheckConfig() const {
 
   /// check that the configuration is complete
-  if (!pGeom) {
+  if (!pGeom || !pOpDets) {
     throw art::Exception(art::errors::LogicError)
       << "DumpOpticalDetectorChannels: no valid geometry available!";
   }
@@ -421,12 +667,7 @@ void DumpOpticalDetectorChannels::CheckConfig() const {
 geo::OpDetGeo const* DumpOpticalDetectorChannels::getOpticalDetector
   (unsigned int channelID) const
 {
-  try {
-    return &(pGeom->OpDetGeoFromOpChannel(channelID));
-  }
-  catch (cet::exception const&) {
-    return nullptr;
-  }
+  return pOpDets->opDet(channelID);
 } // DumpOpticalDetectorChannels::getOpticalDetector()
 
 
@@ -465,4 +706,139 @@ void DumpOpticalDetectorChannels::Dump(std::string OutputCategory) const {
 } // DumpOpticalDetectorChannels::Dump()
 
 
+//==============================================================================
+
+
+//------------------------------------------------------------------------------
+//--- ExportChannelMapColumns
+//------------------------------------------------------------------------------
+void ExportChannelMapColumns::CheckConfig() const {
+
+  /// check that the configuration is complete
+  if (!pGeom || !pChannelToWires || !pOpDets) {
+    throw art::Exception(art::errors::LogicError)
+      << "ExportChannelMapColumns: no valid geometry available!";
+  }
+} // ExportChannelMapColumns::CheckConfig()
+
+
+//------------------------------------------------------------------------------
+void ExportChannelMapColumns::Export
+  (std::string const& prefix, std::string OutputCategory) const
+{
+  /// check that the configuration is complete
+  CheckConfig();
+
+  ExportChannelToWires(prefix + "channel_to_wires.lcol");
+  ExportWireToChannel(prefix + "wire_to_channel.lcol");
+  ExportOpDetChannels(prefix + "opchannel_to_opdet.lcol");
+
+  mf::LogInfo(OutputCategory)
+    << "Channel mapping exported into '" << prefix << "*.lcol' files.";
+
+} // ExportChannelMapColumns::Export()
+
+
+//------------------------------------------------------------------------------
+void ExportChannelMapColumns::ExportChannelToWires
+  (std::string const& path) const
+{
+  std::size_t const NChannels = pChannelToWires->nChannels();
+  std::size_t const NWires = pChannelToWires->nWires();
+
+  std::vector<std::uint64_t> offsets;
+  offsets.reserve(NChannels + 1);
+  std::vector<std::uint32_t> cryostats, TPCs, planes, wires;
+  for (auto* column: { &cryostats, &TPCs, &planes, &wires })
+    column->reserve(NWires);
+
+  offsets.push_back(0U);
+  for (raw::ChannelID_t channel = 0; channel < NChannels; ++channel) {
+    for (geo::WireID const& wireID: pChannelToWires->wires(channel)) {
+      cryostats.push_back(wireID.Cryostat);
+      TPCs.push_back(wireID.TPC);
+      planes.push_back(wireID.Plane);
+      wires.push_back(wireID.Wire);
+    } // for wires
+    offsets.push_back(wires.size());
+  } // for channels
+
+  geo::ColumnarFileWriter writer;
+  writer.addColumn("offset", offsets);
+  writer.addColumn("cryostat", cryostats);
+  writer.addColumn("tpc", TPCs);
+  writer.addColumn("plane", planes);
+  writer.addColumn("wire", wires);
+  writer.write(path);
+
+} // ExportChannelMapColumns::ExportChannelToWires()
+
+
+//------------------------------------------------------------------------------
+void ExportChannelMapColumns::ExportWireToChannel
+  (std::string const& path) const
+{
+  std::vector<std::uint32_t> cryostats, TPCs, planes, wires, channels;
+
+  for (geo::WireID const& wireID: pGeom->IterateWireIDs()) {
+    cryostats.push_back(wireID.Cryostat);
+    TPCs.push_back(wireID.TPC);
+    planes.push_back(wireID.Plane);
+    wires.push_back(wireID.Wire);
+    channels.push_back(pGeom->PlaneWireToChannel(wireID));
+  } // for
+
+  geo::ColumnarFileWriter writer;
+  writer.addColumn("cryostat", cryostats);
+  writer.addColumn("tpc", TPCs);
+  writer.addColumn("plane", planes);
+  writer.addColumn("wire", wires);
+  writer.addColumn("channel", channels);
+  writer.write(path);
+
+} // ExportChannelMapColumns::ExportWireToChannel()
+
+
+//------------------------------------------------------------------------------
+void ExportChannelMapColumns::ExportOpDetChannels
+  (std::string const& path) const
+{
+  std::size_t const NChannels = pOpDets->size();
+
+  std::vector<std::uint32_t> cryostats, opDets;
+  std::vector<double> centerX, centerY, centerZ;
+  for (auto* column: { &cryostats, &opDets }) column->reserve(NChannels);
+  for (auto* column: { &centerX, &centerY, &centerZ })
+    column->reserve(NChannels);
+
+  for (unsigned int channelID = 0; channelID < NChannels; ++channelID) {
+    geo::OpDetGeo const* opDet = pOpDets->opDet(channelID);
+    if (!opDet) {
+      cryostats.push_back(geo::ColumnarFormat::InvalidIndex);
+      opDets.push_back(geo::ColumnarFormat::InvalidIndex);
+      centerX.push_back(0.0);
+      centerY.push_back(0.0);
+      centerZ.push_back(0.0);
+      continue;
+    }
+    geo::OpDetID const& opDetID = opDet->ID();
+    geo::Point_t const& center = opDet->GetCenter();
+    cryostats.push_back(opDetID.Cryostat);
+    opDets.push_back(opDetID.OpDet);
+    centerX.push_back(center.X());
+    centerY.push_back(center.Y());
+    centerZ.push_back(center.Z());
+  } // for
+
+  geo::ColumnarFileWriter writer;
+  writer.addColumn("cryostat", cryostats);
+  writer.addColumn("opdet", opDets);
+  writer.addColumn("center_x", centerX);
+  writer.addColumn("center_y", centerY);
+  writer.addColumn("center_z", centerZ);
+  writer.write(path);
+
+} // ExportChannelMapColumns::ExportOpDetChannels()
+
+
 //==============================================================================
@@ -14,6 +14,9 @@
 #include "fhiclcpp/types/Comment.h"
 #include "fhiclcpp/types/Name.h"
 
+// LArSoft libraries
+#include "larcore/Geometry/GeometryHashes.h"
+
 // C/C++ standard libraries
 #include <string>
 
@@ -25,7 +28,19 @@ namespace geo {
 /** ****************************************************************************
  * @brief Describes on screen the current geometry.
  *
- * One print is performed at the beginning of each run.
+ * The full geometry is printed at the beginning of the job. At the beginning
+ * of each run, the geometry is printed again only if it changed, as detected
+ * by the content hashes of the geometry service (`geo::Geometry::Hashes()`).
+ * In incremental mode, if the new geometry has the same detector name and
+ * the same cryostats, TPCs and planes as the previous one, only the
+ * cryostats, TPCs and planes whose content changed are printed.
+ *
+ * Note that the geometry service currently loads the geometry only once, at
+ * construction, and never reloads it within a job: a run with an incompatible
+ * geometry configuration is rejected (or just reported) by the service.
+ * Therefore, within a single job the geometry is printed only once, and the
+ * incremental mode becomes effective only if geometry reloads are supported
+ * in the future.
  *
  *
  * Configuration parameters
@@ -33,6 +48,8 @@ namespace geo {
  *
  * - *OutputCategory* (string, default: DumpGeometry): output category used
  *   by the message facility to output information (INFO level)
+ * - *incremental* (boolean, default: `true`): on geometry changes, print only
+ *   the parts of the geometry which changed
  *
  */
 class geo::DumpGeometry: public art::EDAnalyzer {
@@ -49,6 +66,12 @@ class geo::DumpGeometry: public art::EDAnalyzer {
       "DumpGeometry"
       };
 
+    fhicl::Atom<bool> incremental {
+      Name("incremental"),
+      Comment("on geometry changes, print only the changed parts of geometry"),
+      true
+      };
+
   }; // struct Config
 
   using Parameters = art::EDAnalyzer::Table<Config>;
@@ -73,18 +96,34 @@ class geo::DumpGeometry: public art::EDAnalyzer {
     private:
 
   std::string fOutputCategory; ///< Name of the category for output.
+  bool fIncremental; ///< Whether to dump only the changes.
   std::string fLastDetectorName; ///< Name of the last geometry dumped.
+  geo::GeometryHashes fLastHashes; ///< Hashes of the last geometry dumped.
 
   /// Dumps the specified geometry into the specified output stream.
   template <typename Stream>
   void dumpGeometryCore(Stream&& out, geo::GeometryCore const& geom) const;
 
+  /// Dumps the parts of the geometry differing from the last dumped one.
+  template <typename Stream>
+  void dumpGeometryChanges(
+    Stream&& out,
+    geo::GeometryCore const& geom, geo::GeometryHashes const& hashes
+    ) const;
+
   /// Dumps the geometry and records it.
   template <typename Stream>
-  void dump(Stream&& out, geo::GeometryCore const& geom);
+  void dump(
+    Stream&& out,
+    geo::GeometryCore const& geom, geo::GeometryHashes const& hashes
+    );
 
   /// Returns whether the specified geometry should be dumped.
-  bool shouldDumpGeometry(geo::GeometryCore const& geom) const;
+  bool shouldDumpGeometry(geo::GeometryHashes const& hashes) const;
+
+  /// Returns whether only the changes of the geometry should be dumped.
+  bool shouldDumpChangesOnly
+    (geo::GeometryCore const& geom, geo::GeometryHashes const& hashes) const;
 
 }; // class geo::DumpGeometry
 
@@ -96,6 +135,10 @@ class geo::DumpGeometry: public art::EDAnalyzer {
 // LArSoft libraries
 #include "larcore/Geometry/Geometry.h"
 #include "larcorealg/Geometry/GeometryCore.h"
+#include "larcorealg/Geometry/CryostatGeo.h"
+#include "larcorealg/Geometry/TPCGeo.h"
+#include "larcorealg/Geometry/PlaneGeo.h"
+#include "larcorealg/Geometry/WireGeo.h"
 
 // framework libraries
 #include "messagefacility/MessageLogger/MessageLogger.h"
@@ -104,14 +147,15 @@ class geo::DumpGeometry: public art::EDAnalyzer {
 geo::DumpGeometry::DumpGeometry(Parameters const& config)
   : EDAnalyzer(config)
   , fOutputCategory(config().outputCategory())
+  , fIncremental(config().incremental())
   {}
 
 
 //------------------------------------------------------------------------------
 void geo::DumpGeometry::beginJob() {
 
-  auto const& geom = *(lar::providerFrom<geo::Geometry>());
-  dump(mf::LogVerbatim(fOutputCategory), geom);
+  art::ServiceHandle<geo::Geometry const> geometry;
+  dump(mf::LogVerbatim(fOutputCategory), *geometry, geometry->Hashes());
 
 } // geo::DumpGeometry::beginJob()
 
@@ -119,11 +163,20 @@ void geo::DumpGeometry::beginJob() {
 //------------------------------------------------------------------------------
 void geo::DumpGeometry::beginRun(art::Run const& run) {
 
-  auto const& geom = *(lar::providerFrom<geo::Geometry>());
-  if (shouldDumpGeometry(geom)) {
-    mf::LogVerbatim log(fOutputCategory);
+  art::ServiceHandle<geo::Geometry const> geometry;
+  geo::GeometryCore const& geom = *geometry;
+  geo::GeometryHashes const& hashes = geometry->Hashes();
+  if (!shouldDumpGeometry(hashes)) return;
+
+  mf::LogVerbatim log(fOutputCategory);
+  if (shouldDumpChangesOnly(geom, hashes)) {
+    log << "\nGeometry changes in " << run.id() << ":\n";
+    dumpGeometryChanges(log, geom, hashes);
+    fLastHashes = hashes;
+  }
+  else {
     log << "\nGeometry used in " << run.id() << ":\n";
-    dump(log, geom);
+    dump(log, geom, hashes);
   }
 
 } // geo::DumpGeometry::beginRun()
@@ -143,24 +196,85 @@ void geo::DumpGeometry::dumpGeometryCore
 
 //------------------------------------------------------------------------------
 template <typename Stream>
-void geo::DumpGeometry::dump(Stream&& out, geo::GeometryCore const& geom) {
+void geo::DumpGeometry::dumpGeometryChanges(
+  Stream&& out,
+  geo::GeometryCore const& geom, geo::GeometryHashes const& hashes
+) const {
+
+  std::string const indent = "  ";
+
+  out << "Detector " << geom.DetectorName()
+    << " (only the elements changed since the last dump are shown)";
+  for (geo::CryostatGeo const& cryostat: geom.IterateCryostats()) {
+    geo::CryostatID const& cid = cryostat.ID();
+    if (hashes.cryostatHash(cid) == fLastHashes.cryostatHash(cid)) continue;
+
+    out << "\n";
+    cryostat.PrintCryostatInfo(out, indent, cryostat.MaxVerbosity);
+    for (unsigned int t = 0; t < cryostat.NTPC(); ++t) {
+      geo::TPCGeo const& tpc = cryostat.TPC(t);
+      geo::TPCID const& tpcid = tpc.ID();
+      if (hashes.TPCHash(tpcid) == fLastHashes.TPCHash(tpcid)) continue;
+
+      out << "\n" << indent;
+      tpc.PrintTPCInfo(out, indent + "  ", tpc.MaxVerbosity);
+      for (unsigned int p = 0; p < tpc.Nplanes(); ++p) {
+        geo::PlaneGeo const& plane = tpc.Plane(p);
+        geo::PlaneID const& planeid = plane.ID();
+        if (hashes.planeHash(planeid) == fLastHashes.planeHash(planeid))
+          continue;
+
+        out << "\n" << indent << "  ";
+        plane.PrintPlaneInfo(out, indent + "    ", plane.MaxVerbosity);
+        for (unsigned int w = 0; w < plane.Nwires(); ++w) {
+          geo::WireGeo const& wire = plane.Wire(w);
+          out << "\n" << indent << "    " << geo::WireID(planeid, w) << " ";
+          wire.PrintWireInfo(out, indent + "    ", wire.MaxVerbosity);
+        } // for wires
+      } // for planes
+    } // for TPCs
+  } // for cryostats
+
+} // geo::DumpGeometry::dumpGeometryChanges()
+
+
+//------------------------------------------------------------------------------
+template <typename Stream>
+void geo::DumpGeometry::dump(
+  Stream&& out,
+  geo::GeometryCore const& geom, geo::GeometryHashes const& hashes
+) {
 
   fLastDetectorName = geom.DetectorName();
+  fLastHashes = hashes;
   dumpGeometryCore(std::forward<Stream>(out), geom);
 
 } // geo::DumpGeometry::dump()
 
 
 //------------------------------------------------------------------------------
-bool geo::DumpGeometry::shouldDumpGeometry(geo::GeometryCore const& geom) const
+bool geo::DumpGeometry::shouldDumpGeometry
+  (geo::GeometryHashes const& hashes) const
 {
 
   // only dump if not already dumped
-  return geom.DetectorName() != fLastDetectorName;
+  return hashes.detectorHash() != fLastHashes.detectorHash();
 
 } // geo::DumpGeometry::shouldDumpGeometry()
 
 
+//------------------------------------------------------------------------------
+bool geo::DumpGeometry::shouldDumpChangesOnly
+  (geo::GeometryCore const& geom, geo::GeometryHashes const& hashes) const
+{
+
+  // a different detector, or a different layout, is always dumped in full
+  return fIncremental && (geom.DetectorName() == fLastDetectorName)
+    && hashes.sameStructure(fLastHashes);
+
+} // geo::DumpGeometry::shouldDumpChangesOnly()
+
+
 //------------------------------------------------------------------------------
 DEFINE_ART_MODULE(geo::DumpGeometry)
 
@@ -23,6 +23,9 @@
 #define GEO_ExptGeoHelperInterface_h
 
 
+// LArSoft libraries
+#include "larcore/Geometry/ChannelMapTablesMemo.h"
+
 // framework libraries
 #include "art/Framework/Services/Registry/ServiceMacros.h"
 #include "fhiclcpp/ParameterSet.h"
@@ -54,6 +57,12 @@ namespace geo
    * Calculations that occur frequently should be handled via interfaces that
    * are passed back to the Geometry service.
    *
+   * The channel mapping tables built from the channel mapping algorithm can
+   * be memoized with the helper (`ChannelMapMemo()`), so that loading again
+   * a geometry with the same configuration does not require building them
+   * again. This is handled by the Geometry service, and it requires no
+   * action from the experiment-specific sub-classes.
+   *
    * @note The public interface for this service cannot be overriden.
    * The experiment-specific sub-classes should implement only the private
    * methods without promoting their visibility.
@@ -82,8 +91,24 @@ namespace geo
       return doConfigureChannelMapAlg(sortingParameters, detectorName);
     }
 
+    /**
+     * @brief Returns the memo of the channel mapping tables.
+     *
+     * The tables are memoized in files by the Geometry service, keyed by
+     * detector name, the type of this helper, the sorting parameters passed
+     * to `ConfigureChannelMapAlg()` and the content hash of the geometry the
+     * algorithm is applied to.
+     */
+    geo::ChannelMapTablesMemo& ChannelMapMemo() const
+    {
+      return fChannelMapMemo;
+    }
+
   private:
 
+    /// Channel mapping tables built with the algorithms from this helper.
+    mutable geo::ChannelMapTablesMemo fChannelMapMemo;
+
     virtual
     ChannelMapAlgPtr_t
     doConfigureChannelMapAlg(fhicl::ParameterSet const& sortingParameters,
@@ -17,7 +17,15 @@
 #define LARCORE_GEOMETRY_GEOMETRY_H
 
 // LArSoft libraries
-#include "larcore/CoreUtils/ServiceUtil.h" // not used; for user's convenience
+#include "larcore/CoreUtils/ServiceUtil.h" // lar::invalidateCachedProviders()
+#include "larcore/Geometry/ChannelMapTablesMemo.h"
+#include "larcore/Geometry/ChannelToWireTable.h"
+#include "larcore/Geometry/GeometryHashes.h"
+#include "larcore/Geometry/OpDetChannelTable.h"
+#include "larcore/Geometry/TPCPositionIndex.h"
+#include "larcore/Geometry/WireArraysStore.h"
+#include "larcore/Geometry/WireCoordinateTable.h"
+#include "larcore/Geometry/WireToChannelTable.h"
 #include "larcorealg/Geometry/GeometryCore.h"
 #include "larcoreobj/SummaryData/GeometryConfigurationInfo.h"
 
@@ -32,6 +40,7 @@
 
 // framework libraries
 #include "fhiclcpp/ParameterSet.h"
+#include "cetlib/MD5Digest.h"
 #include "art/Framework/Principal/Run.h"
 #include "art/Framework/Services/Registry/ActivityRegistry.h"
 #include "art/Framework/Services/Registry/ServiceMacros.h"
@@ -43,7 +52,10 @@
 #include <set>
 #include <cstring>
 #include <memory>
+#include <mutex> // std::call_once(), std::once_flag
+#include <atomic>
 #include <iterator> // std::forward_iterator_tag
+#include <cassert>
 
 
 namespace geo {
@@ -95,17 +107,167 @@ namespace geo {
    *   geo::ChannelMapAlg); its content is dependent on the chosen
    *   implementation of `geo::ChannelMapAlg`
    * - *Builder* (a parameter set: default: empty): configuration for the
-   *   geometry builder; if omitted, the standard builder
-   *   (`geo::GeometryBuilderStandard`) with standard configuration will be
-   *   used; if specified, currently the standard builder is nevertheless used;
+   *   geometry builder; currently `geo::GeometryBuilderParallel` is always
+   *   used, which behaves as the standard builder
+   *   (`geo::GeometryBuilderStandard`) unless its `parallel` option is set,
+   *   in which case cryostats and TPCs are constructed concurrently;
    *   this interface can be "toolized", in which case this parameter set will
    *   select and configure the chosen tool.
+   * - *LazyWireTables* (boolean, default: `false`): if set, the wire-level
+   *   lookup tables (see "Fast lookup tables" below) are filled one plane at
+   *   a time, rather than all at their first use;
+   * - *CacheDirectory* (string, default: empty): if not empty, the geometry
+   *   description is cached in this directory in ROOT format, and jobs with the
+   *   same configuration will load the cached description instead of parsing
+   *   the GDML file again; see "Geometry description cache" below;
+   * - *SharedMemoryTables* (boolean, default: `false`): if set, the channel
+   *   mapping tables are shared with the other processes on the same node
+   *   running the same geometry configuration; see "Tables in shared memory"
+   *   below.
+   * - *MemoizeChannelMap* (boolean, default: `false`): if set, the channel
+   *   mapping tables are memoized into files in `CacheDirectory` (without
+   *   it, this option has no effect); see "Memoized channel mapping tables"
+   *   below.
+   * - *StoreFullConfiguration* (boolean, default: `false`): if set, the full
+   *   text of the service configuration is included in the configuration
+   *   information saved in each run, in addition to its hash; see
+   *   "Configuration consistency check" below.
    *
    * @note Currently, the file defined by `GDML` parameter is also served to
    * ROOT for the internal geometry representation.
    *
    *
    *
+   * Geometry description cache
+   * ===========================
+   *
+   * Parsing of the GDML description by ROOT may take a substantial part of the
+   * job initialization time. If `CacheDirectory` is specified, after the first
+   * load the geometry description is exported by ROOT into that directory in
+   * its native binary format, in a file named after a key (MD5 hash) of:
+   *
+   * * the content of the resolved GDML file;
+   * * the type of the geometry helper service (`ExptGeoHelperInterface`);
+   * * the `Builder` configuration, except for its execution-only settings
+   *   (`parallel` and `maxThreads`);
+   * * the `SortingParameters` configuration;
+   * * a version of the key format, and the ROOT version.
+   *
+   * Later jobs with the same key will find the cached file and feed it to
+   * ROOT instead of the GDML file, skipping the GDML parsing altogether.
+   * The GDML file path served to Geant4 is not affected.
+   * Note that only the content of the main GDML file contributes to the key:
+   * changes in files it includes are not detected, and the cache directory
+   * should be cleared when they happen.
+   *
+   * The cached file is written under a temporary name unique to the job
+   * (including host name and process ID) and then renamed, so that concurrent
+   * jobs sharing the directory, even from different nodes, never read a
+   * partial file nor write into the same one.
+   * Failure to write the cache is not fatal.
+   *
+   *
+   * Fast lookup tables
+   * ===================
+   *
+   * The service can fill some tables which allow some of the most common
+   * queries to be answered without memory allocation and without going
+   * through the channel mapping algorithm. Each table is filled on the first
+   * query which needs it, and it is never modified after that; the tables
+   * can be accessed concurrently from all the _art_ schedules, and only the
+   * queries racing with the filling of a table wait for it to be complete.
+   * The queries using them are:
+   *
+   * * `ChannelToWireSpan()`: the wires covered by a TPC channel
+   *   (`geo::ChannelToWireTable`).
+   * * `WireToChannelMap()`, and `PlaneWireToChannel()` on a range of wires:
+   *   the channel of each wire (`geo::WireToChannelTable`).
+   * * `WireArrays()`: start, end and direction of all the wires of a plane,
+   *   as aligned arrays of coordinates (`geo::PlaneWireArrays`), for
+   *   algorithms processing a whole plane at once.
+   * * `WireCoordinates()`, `NearestWires()` and `NearestWireIDs()`: the wire
+   *   coordinate and the closest wire of many points at once
+   *   (`geo::WireCoordinateTable`).
+   * * `PositionToCryostatID()`, `PositionToTPCID()` and `PositionToTPCIDs()`:
+   *   the cryostat and TPC containing a point, found via a uniform grid over
+   *   the cryostat and TPC boxes (`geo::TPCPositionIndex`) rather than by
+   *   checking all of them in turn; the results are the same as the ones of
+   *   `geo::GeometryCore`, but note that the latter is used, and the grid is
+   *   not, when calling through a `geo::GeometryCore` pointer.
+   * * `OpDetGeoPtrFromOpChannel()` and `OpDetGeosFromOpChannels()`: the
+   *   optical detector of optical channels (`geo::OpDetChannelTable`), with
+   *   `nullptr` for invalid channels instead of an exception.
+   *
+   * A job which never uses one of these queries never pays for its table.
+   * Jobs which query only a few wire planes can further restrict the cost by
+   * enabling `LazyWireTables`, with which the wire-to-channel table and the
+   * wire arrays are filled one plane at a time, on the first query of that
+   * plane. The number of planes filled is available via
+   * `NMaterializedPlanes()`, and it is reported at the end of the job.
+   *
+   *
+   * Tables in shared memory
+   * ========================
+   *
+   * Many single-threaded jobs running on the same node would each hold an
+   * identical copy of the channel mapping tables (`ChannelToWireMap()` and
+   * `WireToChannelMap()`). With `SharedMemoryTables` enabled, the first job
+   * publishes its tables in a POSIX shared memory segment
+   * (`geo::SharedMemorySegment`), named after the same key as the geometry
+   * description cache, and the other jobs with the same configuration map
+   * that segment read-only instead of building their own tables.
+   * Jobs starting while the segment is being written wait for it to be
+   * complete (up to one minute, after which they build their own tables).
+   * A segment left incomplete by a job which ended before completing it is
+   * removed by the next job finding it, which then publishes its own tables
+   * in its place (see `geo::SharedMemorySegment`).
+   * A complete segment is used only if its tables are consistent and fit in
+   * it; otherwise the job leaves it alone and uses its own tables.
+   *
+   * In this mode the tables are completely filled when the geometry is
+   * loaded, regardless of `LazyWireTables`. The geometry objects
+   * (`geo::CryostatGeo` etc.) and the other tables are still private to each
+   * job.
+   *
+   * The segment is not removed at the end of the job, so that later jobs can
+   * reuse it; it can be removed by deleting its file (on Linux,
+   * `/dev/shm/larcore_geometry_*`).
+   *
+   *
+   * Memoized channel mapping tables
+   * ================================
+   *
+   * Filling the channel mapping tables (`ChannelToWireMap()` and
+   * `WireToChannelMap()`) requires a query to the channel mapping algorithm
+   * for each wire and each channel. With `MemoizeChannelMap` enabled and a
+   * `CacheDirectory`, the filled tables are written into a file there via the
+   * memo of the geometry helper service
+   * (`geo::ExptGeoHelperInterface::ChannelMapMemo()`), keyed by detector
+   * name, type of the geometry helper service, `SortingParameters` and the
+   * content hash of the geometry (`DetectorHash()`; see
+   * `ChannelMapMemoKey()`). Later jobs with the same key read them from
+   * there instead of querying the algorithm (`geo::ChannelMapTablesMemo`).
+   * The memo is file-only: this service loads the geometry only once per
+   * job, so that there is nothing to gain from keeping tables in memory.
+   *
+   * The channel mapping algorithm is still configured and applied to the
+   * geometry, since the geometry objects are sorted by it. In this mode the
+   * tables are completely filled when the geometry is loaded, regardless of
+   * `LazyWireTables`.
+   *
+   *
+   * Geometry content hashes
+   * ========================
+   *
+   * On the first request, the service computes a content hash of each plane,
+   * TPC and cryostat, and of the whole detector, each one including the
+   * hashes of its daughters (`geo::GeometryHashes`). They are available via
+   * `Hashes()`, `DetectorHash()`, `CryostatHash()`, `TPCHash()` and
+   * `PlaneHash()`, and they allow a cheap check of whether two geometries, or
+   * two parts of them, are identical. The `DumpGeometry` module uses them to
+   * print only the parts of the geometry which change between runs.
+   *
+   *
    * Configuration consistency check
    * ================================
    * 
@@ -126,10 +288,30 @@ namespace geo {
    * the configuration information into the output files, for the checks in
    * the future job.
    * 
-   * The compatibility check is currently very silly, but it can improved in
-   * future versions. This check is the same as the legacy check, that verifies
-   * that the configured detector name (`geo::GeometryCore::DetectorName()`)
-   * has not changed.
+   * The check verifies that the configured detector name
+   * (`geo::GeometryCore::DetectorName()`) has not changed (this is also the
+   * legacy check). If both configurations carry version 3 information, two
+   * 128-bit (MD5) hashes are also compared:
+   * 
+   * * the hash of the canonical form of the `Geometry` service configuration,
+   *   excluding the parameters which do not affect the geometry description
+   *   (`SkipConfigurationCheck`, `CacheDirectory`, `LazyWireTables`,
+   *   `SharedMemoryTables`, `MemoizeChannelMap`, `PositionEpsilon`,
+   *   `StoreFullConfiguration` and `DisableWiresInG4`, and the `parallel`
+   *   and `maxThreads` settings of the `Builder` configuration);
+   * * the hash of the content of the resolved GDML file used for the geometry
+   *   description (i.e. the one with wires).
+   * 
+   * In version 3, the hashes are stored as a single line at the start of the
+   * `geometryServiceConfiguration` text of the configuration information; the
+   * full text of the configuration follows only if `StoreFullConfiguration`
+   * is set, which keeps the per-run record small.
+   * 
+   * Files with many short runs often carry the same configuration in all of
+   * them: the result of each check is remembered, keyed by the content of the
+   * configuration information, and runs with an already checked configuration
+   * just reuse it. The numbers of checks performed and reused are available
+   * via `ConfigurationCheckCounts()`, and reported at the end of the job.
    * 
    * To allow this check to operate correctly, the only requirement is that
    * the service `GeometryConfigurationWriter` be included in the job:
@@ -208,18 +390,430 @@ namespace geo {
     /// Returns the current geometry configuration information.
     sumdata::GeometryConfigurationInfo const& configurationInfo() const
       { return fConfInfo; }
-    
+
+    /// Numbers of configuration checks at the start of the runs.
+    struct ConfigurationCheckCounts_t {
+      unsigned int performed = 0U; ///< Checks actually performed.
+      unsigned int cached = 0U; ///< Checks answered by a previous result.
+    }; // ConfigurationCheckCounts_t
+
+    /**
+     * @brief Returns the number of configuration checks performed and cached.
+     *
+     * The configuration of each new run is checked against the one of this
+     * service (see "Configuration consistency check" below), but the result
+     * is remembered, and runs with a configuration already checked reuse it.
+     */
+    ConfigurationCheckCounts_t ConfigurationCheckCounts() const
+      {
+        return
+          { fNConfigurationChecks.load(), fNCachedConfigurationChecks.load() };
+      }
+
+
+    // --- BEGIN -- Fast lookup queries ----------------------------------------
+    /// @name Fast lookup queries
+    /// @{
+
+    /**
+     * @brief All the lookup tables built from the geometry and channel map.
+     *
+     * The tables of the geometry are kept together, and each one is filled
+     * only on its first use, in a thread-safe way, so that a job pays only
+     * for the tables it queries.
+     * The tables read the geometry of this service (and point to its
+     * objects), so they live as long as the service does: this service loads
+     * the geometry only once, on construction.
+     */
+    class LookupTables_t {
+        public:
+
+      /**
+       * @brief Prepares the tables of a geometry, without filling any.
+       * @param geom the geometry described by the tables (must outlive them)
+       * @param lazyPlanes fill the wire-level tables one plane at a time
+       * @param positionWiggle tolerance factor of the point location queries
+       */
+      LookupTables_t
+        (geo::GeometryCore const& geom, bool lazyPlanes, double positionWiggle);
+
+      /// Wires covered by each channel.
+      geo::ChannelToWireTable const& channelToWires() const;
+
+      /// Channel of each wire.
+      geo::WireToChannelTable const& wireToChannel() const;
+
+      /// Wire geometry as arrays.
+      geo::WireArraysStore const& wireArrays() const;
+
+      /// Wire coordinate of the planes.
+      geo::WireCoordinateTable const& wireCoordinates() const;
+
+      /// Cryostats and TPCs in space.
+      geo::TPCPositionIndex const& positionIndex() const;
+
+      /// Optical detector of each optical channel.
+      geo::OpDetChannelTable const& opDetChannels() const;
+
+      /// Content hashes of the geometry.
+      geo::GeometryHashes const& hashes() const;
+
+      /**
+       * @brief Uses the specified channel mapping tables instead of filling.
+       * @param wireToChannel the table of the channel of each wire
+       * @param channelToWires the table of the wires covered by each channel
+       * @param data storage the tables point into, if any (kept alive)
+       *
+       * This may be called only before the tables are in use.
+       */
+      void setChannelMapTables(
+        geo::WireToChannelTable wireToChannel,
+        geo::ChannelToWireTable channelToWires,
+        std::shared_ptr<void const> data = {}
+        );
+
+        private:
+
+      /// A table and the flag of its filling.
+      template <typename Table>
+      struct OnDemand_t {
+        mutable Table table; ///< The table (empty until filled).
+        mutable std::once_flag filled; ///< Guards the filling of `table`.
+      }; // OnDemand_t
+
+      /// Returns the table in `onDemand`, filling it with `fill()` if needed.
+      template <typename Table, typename Fill>
+      static Table const& get(OnDemand_t<Table> const& onDemand, Fill fill);
+
+      geo::GeometryCore const* fGeom; ///< Geometry described by the tables.
+      bool fLazyPlanes; ///< Whether wire-level tables are filled by plane.
+      double fPositionWiggle; ///< Tolerance of the point location queries.
+
+      /// Storage of channel mapping tables not owned by them (shared memory
+      /// segment or memoized data), if any.
+      std::shared_ptr<void const> fChannelMapData;
+
+      OnDemand_t<geo::ChannelToWireTable> fChannelToWires;
+      OnDemand_t<geo::WireToChannelTable> fWireToChannel;
+      OnDemand_t<geo::WireArraysStore> fWireArrays;
+      OnDemand_t<geo::WireCoordinateTable> fWireCoordinates;
+      OnDemand_t<geo::TPCPositionIndex> fPositionIndex;
+      OnDemand_t<geo::OpDetChannelTable> fOpDetChannels;
+      OnDemand_t<geo::GeometryHashes> fHashes;
+
+    }; // LookupTables_t
+
+    /**
+     * @brief Returns the wires covered by the specified TPC channel.
+     * @param channel ID of the TPC channel
+     * @return a range of the IDs of all the wires covered by `channel`
+     * @see `geo::GeometryCore::ChannelToWire()`
+     *
+     * The content of the returned range is the same as the one of the vector
+     * returned by `ChannelToWire()`, but no memory is allocated: the range
+     * points into `ChannelToWireMap()`. That table is filled on its first
+     * use (right when the geometry is loaded if `SharedMemoryTables` or
+     * `MemoizeChannelMap` are enabled), and it may be a view of a shared
+     * memory segment or of a buffer read from a memo file rather than own
+     * its data. Either way, the table and its data live as long as the
+     * service does (the geometry is loaded only once), and so does the range.
+     * Invalid or unknown channels yield an empty range (no exception).
+     */
+    geo::ChannelToWireTable::WireIDs_t ChannelToWireSpan
+      (raw::ChannelID_t channel) const
+      { return ChannelToWireMap().wires(channel); }
+
+    /// Returns the table of wires covered by each channel.
+    geo::ChannelToWireTable const& ChannelToWireMap() const
+      { return Tables().channelToWires(); }
+
+    /**
+     * @brief Returns the table of the channel of each wire.
+     *
+     * The table answers queries of the channel of a wire with a single array
+     * access; for example:
+     * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+     * geo::WireToChannelTable const& wireToChannel
+     *   = art::ServiceHandle<geo::Geometry const>()->WireToChannelMap();
+     * raw::ChannelID_t const channel = wireToChannel.channel(wireID);
+     * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+     */
+    geo::WireToChannelTable const& WireToChannelMap() const
+      { return Tables().wireToChannel(); }
+
+    /// Returns the key of the channel mapping tables in the memo.
+    /// @see `geo::ChannelMapTablesMemo`
+    geo::ChannelMapTablesMemo::Key_t ChannelMapMemoKey() const
+      { return ChannelMapTablesKey(Tables()); }
+
+    using GeometryCore::PlaneWireToChannel;
+
+    /**
+     * @brief Fills the channels of all the specified wires.
+     * @param wireIDs the IDs of the wires to be queried
+     * @param channels (output) the channels of the wires
+     * @throw cet::exception (category: `"Geometry"`) if `channels` is shorter
+     *        than `wireIDs`
+     *
+     * For each wire in `wireIDs`, the channel is written in the element of
+     * `channels` at the same position. Wires not present in the detector are
+     * assigned `raw::InvalidChannelID`.
+     */
+    void PlaneWireToChannel(
+      util::span<geo::WireID const*> wireIDs,
+      util::span<raw::ChannelID_t*> channels
+      ) const;
+
+    /**
+     * @brief Returns the geometry of all the wires in the specified plane.
+     * @param planeID ID of the plane
+     * @return start, end and direction of each wire, as arrays of coordinates
+     *
+     * The arrays are indexed by wire number, and their data is aligned for
+     * vectorized access; for example:
+     * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+     * geo::PlaneWireArrays const& wires = geom->WireArrays(planeID);
+     * for (std::size_t iWire = 0; iWire < wires.size(); ++iWire) {
+     *   double const dx = wires.endX[iWire] - wires.startX[iWire];
+     *   // ...
+     * }
+     * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+     * Planes not present in the detector yield empty arrays.
+     */
+    geo::PlaneWireArrays const& WireArrays(geo::PlaneID const& planeID) const
+      { return Tables().wireArrays().plane(planeID); }
+
+    /**
+     * @brief Computes the wire coordinate of many points on a plane.
+     * @param points the points to be projected
+     * @param planeID the plane the points are projected on
+     * @param coords (output) the wire coordinate of each point
+     * @throw cet::exception (category: `"Geometry"`) if `planeID` is not
+     *        present in the detector or `coords` is shorter than `points`
+     *
+     * This is equivalent to calling `WireCoordinate()` for each point, but the
+     * plane is validated only once, and the coordinates are computed in a
+     * single loop which the compiler can vectorize.
+     */
+    void WireCoordinates(
+      util::span<geo::Point_t const*> points, geo::PlaneID const& planeID,
+      util::span<double*> coords
+      ) const;
+
+    /**
+     * @brief Finds the wire closest to each of many points on a plane.
+     * @param points the points to be projected
+     * @param planeID the plane the points are projected on
+     * @param wires (output) the number of the wire closest to each point
+     * @throw cet::exception (category: `"Geometry"`) if `planeID` is not
+     *        present in the detector or `wires` is shorter than `points`
+     *
+     * Points beyond the border wires of the plane are assigned the closest
+     * border wire, as `ClosestWireID()` does (no exception is thrown).
+     */
+    void NearestWires(
+      util::span<geo::Point_t const*> points, geo::PlaneID const& planeID,
+      util::span<geo::WireID::WireID_t*> wires
+      ) const;
+
+    /**
+     * @brief Finds the wire closest to each point, each on its own plane.
+     * @param points the points to be projected
+     * @param planeIDs the plane each point is projected on
+     * @param wireIDs (output) the ID of the wire closest to each point
+     * @throw cet::exception (category: `"Geometry"`) if `planeIDs` or
+     *        `wireIDs` are shorter than `points`
+     *
+     * Like `NearestWires()`, but each point is projected on the plane at the
+     * same position in `planeIDs`. Points on planes not present in the
+     * detector are assigned an invalid wire ID.
+     */
+    void NearestWireIDs(
+      util::span<geo::Point_t const*> points,
+      util::span<geo::PlaneID const*> planeIDs,
+      util::span<geo::WireID*> wireIDs
+      ) const;
+
+    using GeometryCore::PositionToCryostatID;
+    using GeometryCore::PositionToTPCID;
+
+    /**
+     * @brief Returns the ID of the cryostat at specified location.
+     * @param point the location [cm]
+     * @return ID of the cryostat including `point` (invalid if none)
+     *
+     * Same as `geo::GeometryCore::PositionToCryostatID()`, using a spatial
+     * index.
+     */
+    geo::CryostatID PositionToCryostatID(geo::Point_t const& point) const
+      { return Tables().positionIndex().cryostatAt(point); }
+
+    /**
+     * @brief Returns the ID of the TPC at specified location.
+     * @param point the location [cm]
+     * @return ID of the TPC including `point` (invalid if none)
+     *
+     * Same as `geo::GeometryCore::PositionToTPCID()`, using a spatial index.
+     */
+    geo::TPCID PositionToTPCID(geo::Point_t const& point) const
+      { return Tables().positionIndex().TPCat(point); }
+
+    /**
+     * @brief Finds the TPC containing each of the specified points.
+     * @param points the locations [cm]
+     * @param TPCIDs (output) the ID of the TPC containing each point
+     * @throw cet::exception (category: `"Geometry"`) if `TPCIDs` is shorter
+     *        than `points`
+     *
+     * Points not in any TPC are assigned an invalid ID.
+     */
+    void PositionToTPCIDs(
+      util::span<geo::Point_t const*> points,
+      util::span<geo::TPCID*> TPCIDs
+      ) const;
+
+    /// Returns the table of the optical detector of each optical channel.
+    geo::OpDetChannelTable const& OpDetChannelMap() const
+      { return Tables().opDetChannels(); }
+
+    /**
+     * @brief Returns the optical detector serving the specified channel.
+     * @param opChannel the optical channel number
+     * @return the optical detector, or `nullptr` if the channel is invalid
+     *
+     * Unlike `OpDetGeoFromOpChannel()`, this method does not throw: it's
+     * meant for loops where invalid channels are not exceptional.
+     */
+    geo::OpDetGeo const* OpDetGeoPtrFromOpChannel(unsigned int opChannel) const
+      { return Tables().opDetChannels().opDet(opChannel); }
+
+    /**
+     * @brief Fills the optical detectors of all the specified channels.
+     * @param opChannels the optical channels to be queried
+     * @param opDets (output) the optical detectors (`nullptr` if invalid)
+     * @throw cet::exception (category: `"Geometry"`) if `opDets` is shorter
+     *        than `opChannels`
+     */
+    void OpDetGeosFromOpChannels(
+      util::span<unsigned int const*> opChannels,
+      util::span<geo::OpDetGeo const**> opDets
+      ) const;
+
+    /// Returns the number of planes with filled wire-level lookup tables.
+    std::size_t NMaterializedPlanes() const
+      { return Tables().wireToChannel().nMaterializedPlanes(); }
+
+    /// Returns the number of planes with filled wire arrays.
+    std::size_t NMaterializedWireArrayPlanes() const
+      { return Tables().wireArrays().nMaterializedPlanes(); }
+
+    /// @}
+    // --- END -- Fast lookup queries ------------------------------------------
+
+
+    // --- BEGIN -- Geometry content hashes ------------------------------------
+    /// @name Geometry content hashes
+    /// @{
+
+    /**
+     * @brief Returns the content hashes of the current geometry.
+     * @see `geo::GeometryHashes`
+     *
+     * The hashes are computed on the first call. Comparing hashes
+     * is a cheap way to tell whether two geometries (or two cryostats, TPCs or
+     * planes) are the same, and which of their parts differ.
+     */
+    geo::GeometryHashes const& Hashes() const { return Tables().hashes(); }
+
+    /// Returns the content hash of the whole detector.
+    geo::GeometryHashes::Hash_t const& DetectorHash() const
+      { return Hashes().detectorHash(); }
+
+    /// Returns the content hash of cryostat `cid` (throws if not present).
+    geo::GeometryHashes::Hash_t const& CryostatHash
+      (geo::CryostatID const& cid) const
+      { return Hashes().cryostatHash(cid); }
+
+    /// Returns the content hash of TPC `tpcid` (throws if not present).
+    geo::GeometryHashes::Hash_t const& TPCHash(geo::TPCID const& tpcid) const
+      { return Hashes().TPCHash(tpcid); }
+
+    /// Returns the content hash of plane `planeid` (throws if not present).
+    geo::GeometryHashes::Hash_t const& PlaneHash
+      (geo::PlaneID const& planeid) const
+      { return Hashes().planeHash(planeid); }
+
+    /// @}
+    // --- END -- Geometry content hashes --------------------------------------
+
+
+    // --- BEGIN -- Alternative channel mappings -------------------------------
+    /// @name Alternative channel mappings
+    /// @{
+
+    /**
+     * @brief Creates a channel mapping with different sorting parameters.
+     * @param sortingParameters replacement for the `SortingParameters`
+     *        configuration of this service
+     * @return a new channel mapping algorithm, not yet applied to any geometry
+     * @throw cet::exception (category: `"ChannelMapLoadFail"`) on failure
+     *
+     * The mapping is created by the configured `geo::ExptGeoHelperInterface`
+     * service, in the same way as the one of this service.
+     */
+    std::unique_ptr<geo::ChannelMapAlg> MakeChannelMapAlg
+      (fhicl::ParameterSet const& sortingParameters) const;
+
+    /**
+     * @brief Creates a copy of this geometry with a different channel mapping.
+     * @param channelMap the channel mapping to be applied to the new geometry
+     * @return a new, independent geometry provider
+     *
+     * The new geometry describes the same detector as this service, and it
+     * shares the ROOT geometry description already loaded by it. It can be
+     * used to compare channel mappings (e.g. in `DumpChannelMapDiff` module).
+     * None of the lookup tables of this service is created for it.
+     */
+    std::unique_ptr<geo::GeometryCore> MakeGeometryWithChannelMap
+      (std::unique_ptr<geo::ChannelMapAlg> channelMap) const;
+
+    /// @}
+    // --- END -- Alternative channel mappings ---------------------------------
+
   private:
 
     /// Updates the geometry if needed at the beginning of each new run
     void preBeginRun(art::Run const& run);
 
+    /// Reports statistics at the end of the job.
+    void postEndJob();
+
     /// Expands the provided paths and loads the geometry description(s)
     void LoadNewGeometry(
       std::string gdmlfile, std::string rootfile,
       bool bForceReload = false
       );
 
+    // --- BEGIN -- Geometry description cache ---------------------------------
+    /// @name Geometry description cache
+    /// @{
+
+    /// Returns the key of the geometry with the specified description content
+    /// hash and this configuration.
+    std::string GeometryKey(cet::MD5Result const& descriptionHash) const;
+
+    /// Returns the path of the cache file for the current geometry.
+    std::string GeometryCacheFilePath() const;
+
+    /// Writes the currently loaded geometry description into `cacheFile`.
+    void WriteGeometryCache(std::string const& cacheFile) const;
+
+    /// Returns the MD5 hash of the content of the file at `path`.
+    static cet::MD5Result FileContentHash(std::string const& path);
+
+    /// @}
+    // --- END -- Geometry description cache -----------------------------------
+
     // --- BEGIN -- Configuration information checks ---------------------------
     /// @name Configuration information checks
     /// @{
@@ -227,6 +821,11 @@ namespace geo {
     /// Fills the service configuration information into `fConfInfo`.
     void FillGeometryConfigurationInfo(fhicl::ParameterSet const& config);
     
+    /// Returns if `other` is compatible with our current configuration,
+    /// reusing the result of a previous check of the same configuration.
+    bool CheckConfigurationInfoMemoized
+      (sumdata::GeometryConfigurationInfo const& other);
+    
     /// Returns if the `other` configuration is compatible with our current.
     bool CheckConfigurationInfo
       (sumdata::GeometryConfigurationInfo const& other) const;
@@ -246,16 +845,86 @@ namespace geo {
     
     void InitializeChannelMap();
 
+    /// Returns the lookup tables (prepared by `LoadNewGeometry()`).
+    LookupTables_t const& Tables() const
+      {
+        assert(fLookupTables);
+        return *fLookupTables;
+      }
+
+    /// Prepares the lookup tables of the current geometry and channel map.
+    void BuildLookupTables();
+
+    /// Fills the channel mapping tables, shared or memoized.
+    void PrepareChannelMapTables(LookupTables_t& tables) const;
+
+    /// Returns the name of the shared memory segment for the current geometry.
+    std::string SharedTablesSegmentName() const;
+
+    /// Uses the channel mapping tables from shared memory, if available.
+    /// @return whether the `tables` are now from shared memory
+    bool AttachSharedLookupTables(LookupTables_t& tables) const;
+
+    /// Copies the channel mapping `tables` into a new shared memory segment.
+    void PublishSharedLookupTables(LookupTables_t& tables) const;
+
+    /// Returns the memoization key of the channel mapping `tables`.
+    geo::ChannelMapTablesMemo::Key_t ChannelMapTablesKey
+      (LookupTables_t const& tables) const;
+
+    /// Uses the memoized channel mapping tables, if available.
+    /// @return whether the `tables` are now memoized ones
+    bool UseMemoizedChannelMapTables(LookupTables_t& tables) const;
+
+    /// Memoizes the channel mapping `tables` and switches them to the memo.
+    void MemoizeChannelMapTables(LookupTables_t& tables) const;
+
+    /// Throws an exception if `planeID` is not in the wire coordinate table.
+    void CheckWireCoordinatePlane
+      (geo::PlaneID const& planeID, const char* caller) const;
+
     std::string               fRelPath;          ///< Relative path added to FW_SEARCH_PATH to search for
                                                  ///< geometry file
     bool                      fDisableWiresInG4; ///< If set true, supply G4 with GDMLfileNoWires
                                                  ///< rather than GDMLfile
     bool                      fNonFatalConfCheck;///< Don't stop if configuration check fails.
+    bool                      fStoreFullConfiguration;///< Save the full configuration
+                                                 ///< text in the run records.
                                                  ///< files specified in the fcl file
     fhicl::ParameterSet       fSortingParameters;///< Parameter set to define the channel map sorting
     fhicl::ParameterSet       fBuilderParameters;///< Parameter set for geometry builder.
+    fhicl::ParameterSet       fCoreParameters;   ///< Configuration of the
+                                                 ///< geometry provider.
+    std::string               fCacheDirectory;   ///< Directory of the geometry description
+                                                 ///< cache (empty: no cache)
+    bool                      fLazyWireTables;   ///< Fill wire-level tables on demand.
+    bool                      fSharedMemoryTables;///< Share channel mapping tables
+                                                 ///< with other processes.
+    bool                      fMemoizeChannelMap;///< Memoize channel mapping
+                                                 ///< tables in the helper.
+    double                    fPositionWiggle;   ///< Tolerance factor of the
+                                                 ///< point location queries.
+    
+    std::string               fGeometryKey;      ///< Key of the current geometry
+                                                 ///< (if needed).
+    cet::MD5Result            fDescriptionHash;  ///< Hash of the content of the
+                                                 ///< geometry description file.
     
     sumdata::GeometryConfigurationInfo fConfInfo;///< Summary of service configuration.
+
+    /// A run configuration already checked, and the result of the check.
+    struct CheckedConfiguration_t {
+      sumdata::GeometryConfigurationInfo info; ///< The configuration checked.
+      bool compatible; ///< Whether it was found compatible.
+    }; // CheckedConfiguration_t
+
+    /// Run configurations already checked (typically, very few).
+    std::vector<CheckedConfiguration_t> fCheckedConfigurations;
+    std::atomic<unsigned int> fNConfigurationChecks { 0U }; ///< Checks performed.
+    std::atomic<unsigned int> fNCachedConfigurationChecks { 0U }; ///< Checks reused.
+
+    /// Lookup tables of the geometry (as long-lived as the service).
+    std::unique_ptr<LookupTables_t> fLookupTables;
     
   };
 
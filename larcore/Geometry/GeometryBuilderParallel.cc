@@ -0,0 +1,125 @@
+/**
+ * @file   larcore/Geometry/GeometryBuilderParallel.cc
+ * @brief  Geometry builder constructing cryostats and TPCs concurrently.
+ * @see    larcore/Geometry/GeometryBuilderParallel.h
+ */
+
+// library header
+#include "larcore/Geometry/GeometryBuilderParallel.h"
+
+// LArSoft libraries
+#include "larcorealg/Geometry/CryostatGeo.h"
+#include "larcorealg/Geometry/TPCGeo.h"
+
+// ROOT libraries
+#include "TGeoNode.h"
+#include "TGeoVolume.h"
+
+// TBB libraries
+#include "tbb/parallel_for.h"
+
+// C/C++ standard libraries
+#include <optional>
+#include <utility> // std::move()
+#include <cstddef> // std::size_t
+
+
+//------------------------------------------------------------------------------
+geo::GeometryBuilderParallel::GeometryBuilderParallel(Config const& config)
+  : geo::GeometryBuilderStandard(config)
+  , fParallel(config.parallel())
+  , fMaxPathDepth(config.maxDepth())
+  , fArena(
+      (config.maxThreads() == 0U)
+        ? int(tbb::task_arena::automatic): int(config.maxThreads())
+      )
+  {}
+
+
+//------------------------------------------------------------------------------
+auto geo::GeometryBuilderParallel::doExtractCryostats(Path_t& path)
+  -> Cryostats_t
+{
+  if (!fParallel) return geo::GeometryBuilderStandard::doExtractCryostats(path);
+
+  return buildConcurrently<geo::CryostatGeo>(
+    path,
+    [this](TGeoNode const& node){ return isCryostatNode(node); },
+    [this](Path_t& path){ return doMakeCryostat(path); }
+    );
+
+} // geo::GeometryBuilderParallel::doExtractCryostats()
+
+
+//------------------------------------------------------------------------------
+auto geo::GeometryBuilderParallel::doExtractTPCs(Path_t& path) -> TPCs_t {
+
+  if (!fParallel) return geo::GeometryBuilderStandard::doExtractTPCs(path);
+
+  return buildConcurrently<geo::TPCGeo>(
+    path,
+    [this](TGeoNode const& node){ return isTPCNode(node); },
+    [this](Path_t& path){ return doMakeTPC(path); }
+    );
+
+} // geo::GeometryBuilderParallel::doExtractTPCs()
+
+
+//------------------------------------------------------------------------------
+template <typename ObjGeo, typename IsObj, typename MakeObj>
+std::vector<ObjGeo> geo::GeometryBuilderParallel::buildConcurrently
+  (Path_t& path, IsObj isObj, MakeObj makeObj)
+{
+  /*
+   * 1. find all the nodes (serial)
+   * 2. build the objects (concurrent), each in its preassigned slot
+   * 3. move the objects into the result in the original order (serial)
+   */
+  std::vector<Path_t> objPaths;
+  collectPaths(path, isObj, objPaths);
+
+  std::vector<std::optional<ObjGeo>> objs(objPaths.size());
+  fArena.execute([&objPaths, &objs, &makeObj](){
+    tbb::parallel_for(std::size_t{ 0 }, objPaths.size(),
+      [&objPaths, &objs, &makeObj](std::size_t iObj)
+        { objs[iObj].emplace(makeObj(objPaths[iObj])); }
+      );
+  });
+
+  std::vector<ObjGeo> result;
+  result.reserve(objs.size());
+  for (std::optional<ObjGeo>& obj: objs) result.push_back(std::move(*obj));
+  return result;
+
+} // geo::GeometryBuilderParallel::buildConcurrently()
+
+
+//------------------------------------------------------------------------------
+template <typename IsObj>
+void geo::GeometryBuilderParallel::collectPaths
+  (Path_t& path, IsObj const& isObj, std::vector<Path_t>& paths) const
+{
+  // this is the same visit order as in `GeometryBuilderStandard`
+  TGeoNode const& current = path.current();
+  if (isObj(current)) {
+    paths.push_back(path);
+    return;
+  }
+
+  TGeoVolume const* pCurrentVolume = current.GetVolume();
+  if (!pCurrentVolume) return;
+
+  // if this is a leaf or we are already too deep, we stop here
+  if (path.depth() >= fMaxPathDepth) return;
+
+  int const n = pCurrentVolume->GetNdaughters();
+  for (int i = 0; i < n; ++i) {
+    path.append(*(pCurrentVolume->GetNode(i)));
+    collectPaths(path, isObj, paths);
+    path.pop();
+  } // for
+
+} // geo::GeometryBuilderParallel::collectPaths()
+
+
+//------------------------------------------------------------------------------
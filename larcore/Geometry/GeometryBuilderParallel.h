@@ -0,0 +1,124 @@
+/**
+ * @file   larcore/Geometry/GeometryBuilderParallel.h
+ * @brief  Geometry builder constructing cryostats and TPCs concurrently.
+ * @see    larcore/Geometry/GeometryBuilderParallel.cc
+ */
+
+#ifndef LARCORE_GEOMETRY_GEOMETRYBUILDERPARALLEL_H
+#define LARCORE_GEOMETRY_GEOMETRYBUILDERPARALLEL_H
+
+// LArSoft libraries
+#include "larcorealg/Geometry/GeometryBuilderStandard.h"
+
+// framework libraries
+#include "fhiclcpp/types/Atom.h"
+
+// TBB libraries
+#include "tbb/task_arena.h"
+
+// C/C++ standard libraries
+#include <vector>
+
+
+namespace geo {
+
+  /**
+   * @brief Geometry builder which may build cryostats and TPCs concurrently.
+   *
+   * This builder extends `geo::GeometryBuilderStandard`. When the `parallel`
+   * option is set, the cryostats and, within each of them, the TPCs (with all
+   * their planes and wires) are constructed as independent tasks in a TBB
+   * task arena. Otherwise, the behaviour is exactly the one of the standard
+   * builder.
+   *
+   * The geometry tree is first walked serially to find the nodes of the
+   * objects to be built, in the same order as the standard builder would
+   * visit them; then the objects are built concurrently, and finally they are
+   * collected in the original order. The result is therefore identical to the
+   * one of the serial construction.
+   *
+   * The construction of each object only reads the ROOT geometry tree, which
+   * is not modified after it is loaded. ROOT thread safety must be enabled,
+   * as _art_ does.
+   *
+   * Configuration
+   * --------------
+   *
+   * In addition to the parameters of `geo::GeometryBuilderStandard`:
+   *
+   * * `parallel` (boolean, default: `false`): build concurrently;
+   * * `maxThreads` (integer, default: `0`): maximum number of threads used for
+   *   the concurrent construction; `0` lets TBB decide.
+   *
+   */
+  class GeometryBuilderParallel: public geo::GeometryBuilderStandard {
+
+      public:
+
+    /// Configuration of the builder.
+    struct Config: public geo::GeometryBuilderStandard::Config {
+
+      fhicl::Atom<bool> parallel {
+        Name("parallel"),
+        Comment("build cryostats and TPCs concurrently"),
+        false
+        };
+
+      fhicl::Atom<unsigned int> maxThreads {
+        Name("maxThreads"),
+        Comment
+          ("maximum number of threads for the concurrent build (0: automatic)"),
+        0U
+        };
+
+    }; // struct Config
+
+
+    /// Constructor: configures the builder.
+    GeometryBuilderParallel(Config const& config);
+
+
+      protected:
+
+    /// Builds all the cryostats in `path`, concurrently if so configured.
+    virtual Cryostats_t doExtractCryostats(Path_t& path) override;
+
+    /// Builds all the TPCs in `path`, concurrently if so configured.
+    virtual TPCs_t doExtractTPCs(Path_t& path) override;
+
+
+      private:
+
+    bool fParallel = false; ///< Whether to build concurrently.
+
+    Path_t::Depth_t fMaxPathDepth; ///< Maximum depth of the search for nodes.
+
+    tbb::task_arena fArena; ///< Arena where the construction tasks run.
+
+
+    /**
+     * @brief Builds all objects under `path` concurrently.
+     * @tparam ObjGeo type of the geometry object to be built
+     * @tparam IsObj type of predicate identifying a node of the object
+     * @tparam MakeObj type of callable building an object from its path
+     * @param path path to the node where to start searching for the objects
+     * @param isObj predicate: `isObj(node)` is `true` if `node` is an object
+     * @param makeObj callable: `makeObj(path)` returns the object at `path`
+     * @return the objects, in the order they were found
+     */
+    template <typename ObjGeo, typename IsObj, typename MakeObj>
+    std::vector<ObjGeo> buildConcurrently
+      (Path_t& path, IsObj isObj, MakeObj makeObj);
+
+    /// Adds to `paths` the paths of all nodes satisfying `isObj`.
+    template <typename IsObj>
+    void collectPaths
+      (Path_t& path, IsObj const& isObj, std::vector<Path_t>& paths) const;
+
+  }; // class GeometryBuilderParallel
+
+
+} // namespace geo
+
+
+#endif // LARCORE_GEOMETRY_GEOMETRYBUILDERPARALLEL_H
@@ -14,13 +14,17 @@
 
 // framework libraries
 #include "art/Framework/Services/Registry/ServiceHandle.h"
+#include "art/Framework/Services/Registry/ActivityRegistry.h"
 #include "art/Framework/Core/ProducingService.h"
 #include "art/Framework/Principal/Run.h"
 #include "art/Framework/Principal/Handle.h"
+#include "canvas/Persistency/Provenance/RunID.h"
 #include "canvas/Utilities/InputTag.h"
 #include "messagefacility/MessageLogger/MessageLogger.h"
 
 // C/C++ standard libraries
+#include <map>
+#include <string>
 #include <memory> // std::make_unique()
 
 
@@ -68,6 +72,27 @@ namespace geo { class GeometryConfigurationWriter; }
  *   configuration of the `Geometry` service.
  * 
  * 
+ * Reuse of configuration information
+ * -----------------------------------
+ * 
+ * The data products which are not read from the input are built only once
+ * per configuration and copied into each following run:
+ * 
+ * * the information from the `Geometry` service is extracted for the first
+ *   run which needs it and reused for the rest of the job;
+ * * the information from legacy `sumdata::RunData` is reused for all the runs
+ *   with the same detector name.
+ * 
+ * The service also remembers where the information came from for each run of
+ * the current input file: when the same run is read again (e.g. a further
+ * fragment of it), the lookups which found nothing the first time are not
+ * repeated. Different runs are always searched in full, since each of them
+ * may carry information in a different form.
+ * This memory is cleared at each new input file.
+ * At the end of the job, the number of runs which reused an existing product
+ * is reported (`INFO` level, category `GeometryConfigurationWriter`).
+ * 
+ * 
  * Service dependencies
  * ---------------------
  * 
@@ -87,7 +112,7 @@ class geo::GeometryConfigurationWriter: public art::ProducingService {
   using Parameters = art::ServiceTable<Config>;
   
   /// Constructor: gets its configuration and does nothing with it.
-  GeometryConfigurationWriter(Parameters const&);
+  GeometryConfigurationWriter(Parameters const&, art::ActivityRegistry& reg);
   
   
     private:
@@ -95,15 +120,47 @@ class geo::GeometryConfigurationWriter: public art::ProducingService {
   /// Writes the information from the service configuration into the `run`.
   virtual void postReadRun(art::Run& run) override;
   
+  /// Forgets where the information of the previous input file came from.
+  void postOpenFile(std::string const& fileName);
+  
+  /// Reports how many runs reused an existing product.
+  void postEndJob();
+  
   
     private:
   
   /// Alias for the pointer to the data product object to be put into the run.
   using InfoPtr_t = std::unique_ptr<sumdata::GeometryConfigurationInfo>;
   
+  /// Where the information of a run of the current input comes from.
+  enum class InfoSource_t {
+    Unknown, ///< Run not read yet.
+    Stored,  ///< `sumdata::GeometryConfigurationInfo` in the input.
+    Legacy,  ///< `sumdata::RunData` in the input.
+    Service  ///< Neither: the `Geometry` service.
+  }; // InfoSource_t
+  
+  
+  // --- BEGIN -- Cached information -------------------------------------------
+  /// Source of the information for each run of the current input file.
+  std::map<art::RunID, InfoSource_t> fInputSources;
+  
+  /// Information from the `Geometry` service (built on first use).
+  InfoPtr_t fServiceInfo;
+  
+  /// Information upgraded from legacy `sumdata::RunData`, by detector name.
+  std::map<std::string, sumdata::GeometryConfigurationInfo> fLegacyInfo;
+  
+  unsigned int fNRuns = 0U; ///< Number of runs processed.
+  unsigned int fNCachedRuns = 0U; ///< Number of runs reusing a product.
+  // --- END -- Cached information ---------------------------------------------
+  
   
   /// Loads the geometry information from the `run` (either directly or legacy).
-  InfoPtr_t loadInfo(art::Run& run) const;
+  InfoPtr_t loadInfo(art::Run& run);
+  
+  /// Returns a copy of the configuration of the `Geometry` service.
+  InfoPtr_t serviceInfo();
   
   /// Creates configuration information based on the current `Geometry` service.
   static InfoPtr_t extractInfoFromGeometry();
@@ -113,7 +170,7 @@ class geo::GeometryConfigurationWriter: public art::ProducingService {
   
   /// Upgrades legacy `sumdata::RunData` in `run` to geometry information
   /// (returns null pointer if no legacy information is present).
-  InfoPtr_t makeInfoFromRunData(art::Run& run) const;
+  InfoPtr_t makeInfoFromRunData(art::Run& run);
   
   /// Returns a pointer to the `sumdata::RunData` in `run` (nullptr if none).
   sumdata::RunData const* readRunData(art::Run& run) const;
@@ -133,18 +190,24 @@ class geo::GeometryConfigurationWriter: public art::ProducingService {
 // -----------------------------------------------------------------------------
 // --- implementation
 // -----------------------------------------------------------------------------
-geo::GeometryConfigurationWriter::GeometryConfigurationWriter(Parameters const&)
+geo::GeometryConfigurationWriter::GeometryConfigurationWriter
+  (Parameters const&, art::ActivityRegistry& reg)
 {
   produces<sumdata::GeometryConfigurationInfo, art::InRun>();
+  
+  reg.sPostOpenFile.watch(this, &GeometryConfigurationWriter::postOpenFile);
+  reg.sPostEndJob.watch(this, &GeometryConfigurationWriter::postEndJob);
 }
 
 
 // -----------------------------------------------------------------------------
 void geo::GeometryConfigurationWriter::postReadRun(art::Run& run) {
   
+  ++fNRuns;
+  
   InfoPtr_t confInfo = geo::GeometryConfigurationWriter::loadInfo(run);
   
-  if (!confInfo) confInfo = extractInfoFromGeometry();
+  if (!confInfo) confInfo = serviceInfo();
   
   run.put(std::move(confInfo), art::fullRun());
   
@@ -152,9 +215,21 @@ void geo::GeometryConfigurationWriter::postReadRun(art::Run& run) {
 
 
 // -----------------------------------------------------------------------------
-auto geo::GeometryConfigurationWriter::loadInfo(art::Run& run) const
-  -> InfoPtr_t
-{
+void geo::GeometryConfigurationWriter::postOpenFile(std::string const&) {
+  fInputSources.clear();
+} // geo::GeometryConfigurationWriter::postOpenFile()
+
+
+// -----------------------------------------------------------------------------
+void geo::GeometryConfigurationWriter::postEndJob() {
+  mf::LogInfo("GeometryConfigurationWriter")
+    << "Geometry configuration information reused in " << fNCachedRuns
+    << "/" << fNRuns << " runs.";
+} // geo::GeometryConfigurationWriter::postEndJob()
+
+
+// -----------------------------------------------------------------------------
+auto geo::GeometryConfigurationWriter::loadInfo(art::Run& run) -> InfoPtr_t {
   
   /*
    * Read geometry configuration information from the run:
@@ -164,24 +239,51 @@ auto geo::GeometryConfigurationWriter::loadInfo(art::Run& run) const
    * 2. if none is found, attempt reading legacy information and upgrade it
    * 3. if no legacy information is found either, return a null pointer
    * 
+   * Steps which found nothing when the same run of the same input file was
+   * read before are skipped.
    */
-  InfoPtr_t info = readGeometryInformation(run);
+  InfoSource_t& source = fInputSources[run.id()];
+  if (source == InfoSource_t::Service) return {};
+  
+  if (source != InfoSource_t::Legacy) {
+    InfoPtr_t info = readGeometryInformation(run);
+    if (info) {
+      source = InfoSource_t::Stored;
+      return info;
+    }
+  }
   
-  return info? std::move(info): makeInfoFromRunData(run);
+  InfoPtr_t info = makeInfoFromRunData(run);
+  source = info? InfoSource_t::Legacy: InfoSource_t::Service;
+  return info;
   
 } // geo::GeometryConfigurationWriter::loadInfo()
 
 
+// -----------------------------------------------------------------------------
+auto geo::GeometryConfigurationWriter::serviceInfo() -> InfoPtr_t {
+  
+  if (fServiceInfo) {
+    ++fNCachedRuns;
+    return makeInfoPtr(*fServiceInfo);
+  }
+  
+  fServiceInfo = extractInfoFromGeometry();
+  return makeInfoPtr(*fServiceInfo);
+  
+} // geo::GeometryConfigurationWriter::serviceInfo()
+
+
 // -----------------------------------------------------------------------------
 auto geo::GeometryConfigurationWriter::extractInfoFromGeometry() -> InfoPtr_t {
   
-  sumdata::GeometryConfigurationInfo confInfo
-    = art::ServiceHandle<geo::Geometry>()->configurationInfo();
+  sumdata::GeometryConfigurationInfo const& confInfo
+    = art::ServiceHandle<geo::Geometry const>()->configurationInfo();
   
   MF_LOG_DEBUG("GeometryConfigurationWriter")
     << "Geometry configuration information from service:\n" << confInfo;
   
-  return makeInfoPtr(std::move(confInfo));
+  return makeInfoPtr(confInfo);
   
 } // geo::GeometryConfigurationWriter::extractInfoFromGeometry()
 
@@ -200,13 +302,22 @@ auto geo::GeometryConfigurationWriter::readGeometryInformation
 
 
 // -----------------------------------------------------------------------------
-auto geo::GeometryConfigurationWriter::makeInfoFromRunData(art::Run& run) const
+auto geo::GeometryConfigurationWriter::makeInfoFromRunData(art::Run& run)
   -> InfoPtr_t
 {
   
   sumdata::RunData const* runData = readRunData(run);
+  if (!runData) return {};
+  
+  auto const iInfo = fLegacyInfo.find(runData->DetName());
+  if (iInfo != fLegacyInfo.end()) {
+    ++fNCachedRuns;
+    return makeInfoPtr(iInfo->second);
+  }
   
-  return runData? convertRunDataToGeometryInformation(*runData): InfoPtr_t{};
+  InfoPtr_t info = convertRunDataToGeometryInformation(*runData);
+  fLegacyInfo.emplace(runData->DetName(), *info);
+  return info;
   
 } // geo::GeometryConfigurationWriter::makeInfoFromRunData()
 
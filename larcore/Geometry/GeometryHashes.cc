@@ -0,0 +1,199 @@
+/**
+ * @file   larcore/Geometry/GeometryHashes.cc
+ * @brief  Content hashes of the detector geometry, per cryostat, TPC and plane.
+ * @see    larcore/Geometry/GeometryHashes.h
+ */
+
+// library header
+#include "larcore/Geometry/GeometryHashes.h"
+
+// LArSoft libraries
+#include "larcorealg/Geometry/GeometryCore.h"
+#include "larcorealg/Geometry/CryostatGeo.h"
+#include "larcorealg/Geometry/TPCGeo.h"
+#include "larcorealg/Geometry/PlaneGeo.h"
+#include "larcorealg/Geometry/WireGeo.h"
+#include "larcorealg/Geometry/OpDetGeo.h"
+#include "larcorealg/Geometry/BoxBoundedGeo.h"
+
+// framework libraries
+#include "cetlib_except/exception.h"
+
+// C/C++ standard libraries
+#include <string>
+#include <algorithm> // std::equal()
+#include <type_traits> // std::is_floating_point_v
+
+
+//------------------------------------------------------------------------------
+namespace {
+
+  /// Accumulates the content of geometry elements into an MD5 digest.
+  class HashBuilder {
+      public:
+
+    /// Adds the binary representation of `value` (`-0.0` added as `0.0`).
+    template <typename T>
+    HashBuilder& add(T const& value)
+      {
+        if constexpr(std::is_floating_point_v<T>) {
+          // signed zeroes compare equal but have different representations
+          T const normalized = (value == T{ 0 })? T{ 0 }: value;
+          return addBytes(normalized);
+        }
+        else return addBytes(value);
+      }
+
+    /// Adds the size and content of the string `s`.
+    HashBuilder& addString(std::string const& s)
+      { add(s.size()); fData.append(s); return *this; }
+
+    /// Adds the coordinates of `point` (or vector).
+    template <typename Point>
+    HashBuilder& addPoint(Point const& point)
+      { return add(point.X()).add(point.Y()).add(point.Z()); }
+
+    /// Adds the extremes of `box`.
+    HashBuilder& addBox(geo::BoxBoundedGeo const& box)
+      { return addPoint(box.Min()).addPoint(box.Max()); }
+
+    /// Adds another hash.
+    HashBuilder& addHash(geo::GeometryHashes::Hash_t const& hash)
+      { return add(hash.bytes); }
+
+    /// Returns the digest of all the content added so far.
+    geo::GeometryHashes::Hash_t digest() const
+      { return cet::MD5Digest{ fData }.digest(); }
+
+      private:
+    std::string fData; ///< All the content.
+
+    /// Adds the binary representation of `value` as it is.
+    template <typename T>
+    HashBuilder& addBytes(T const& value)
+      {
+        fData.append(reinterpret_cast<char const*>(&value), sizeof(value));
+        return *this;
+      }
+
+  }; // class HashBuilder
+
+
+  //----------------------------------------------------------------------------
+  geo::GeometryHashes::Hash_t computePlaneHash(geo::PlaneGeo const& plane) {
+    HashBuilder hash;
+    geo::PlaneID const& pid = plane.ID();
+    hash.add(pid.Cryostat).add(pid.TPC).add(pid.Plane)
+      .add(plane.View()).add(plane.Orientation())
+      .addPoint(plane.GetCenter()).addPoint(plane.GetNormalDirection())
+      .add(plane.Nwires());
+    for (unsigned int w = 0; w < plane.Nwires(); ++w) {
+      geo::WireGeo const& wire = plane.Wire(w);
+      hash.addPoint(wire.GetStart()).addPoint(wire.GetEnd());
+    }
+    return hash.digest();
+  } // computePlaneHash()
+
+} // local namespace
+
+
+//------------------------------------------------------------------------------
+geo::GeometryHashes::GeometryHashes(geo::GeometryCore const& geom) {
+
+  HashBuilder detector;
+  detector.addString(geom.DetectorName()).add(geom.Ncryostats());
+
+  fCryostats.resize(geom.Ncryostats());
+  for (unsigned int c = 0; c < geom.Ncryostats(); ++c) {
+    geo::CryostatGeo const& cryo = geom.Cryostat(geo::CryostatID(c));
+    CryostatHashes_t& cryoHashes = fCryostats[c];
+
+    HashBuilder cryostat;
+    cryostat.add(c).addBox(cryo.Boundaries()).add(cryo.NOpDet());
+    for (unsigned int o = 0; o < cryo.NOpDet(); ++o)
+      cryostat.addPoint(cryo.OpDet(o).GetCenter());
+    cryostat.add(cryo.NTPC());
+
+    cryoHashes.TPCs.resize(cryo.NTPC());
+    for (unsigned int t = 0; t < cryo.NTPC(); ++t) {
+      geo::TPCGeo const& tpc = cryo.TPC(t);
+      TPCHashes_t& TPCHashes = cryoHashes.TPCs[t];
+
+      HashBuilder TPC;
+      TPC.add(c).add(t).add(tpc.DriftDirection())
+        .addBox(tpc.BoundingBox()).addBox(tpc.ActiveBoundingBox())
+        .add(tpc.Nplanes());
+
+      TPCHashes.planes.reserve(tpc.Nplanes());
+      for (unsigned int p = 0; p < tpc.Nplanes(); ++p) {
+        TPCHashes.planes.push_back(computePlaneHash(tpc.Plane(p)));
+        TPC.addHash(TPCHashes.planes.back());
+      } // for planes
+
+      TPCHashes.hash = TPC.digest();
+      cryostat.addHash(TPCHashes.hash);
+    } // for TPCs
+
+    cryoHashes.hash = cryostat.digest();
+    detector.addHash(cryoHashes.hash);
+  } // for cryostats
+
+  fDetector = detector.digest();
+
+} // geo::GeometryHashes::GeometryHashes()
+
+
+//------------------------------------------------------------------------------
+auto geo::GeometryHashes::cryostatHash(geo::CryostatID const& cid) const
+  -> Hash_t const&
+{
+  if (!hasCryostat(cid)) {
+    throw cet::exception("GeometryHashes")
+      << "No hash for cryostat " << cid << ".\n";
+  }
+  return fCryostats[cid.Cryostat].hash;
+} // geo::GeometryHashes::cryostatHash()
+
+
+//------------------------------------------------------------------------------
+auto geo::GeometryHashes::TPCHash(geo::TPCID const& tpcid) const
+  -> Hash_t const&
+{
+  if (!hasTPC(tpcid)) {
+    throw cet::exception("GeometryHashes")
+      << "No hash for TPC " << tpcid << ".\n";
+  }
+  return TPCentry(tpcid).hash;
+} // geo::GeometryHashes::TPCHash()
+
+
+//------------------------------------------------------------------------------
+auto geo::GeometryHashes::planeHash(geo::PlaneID const& planeid) const
+  -> Hash_t const&
+{
+  if (!hasPlane(planeid)) {
+    throw cet::exception("GeometryHashes")
+      << "No hash for plane " << planeid << ".\n";
+  }
+  return TPCentry(planeid).planes[planeid.Plane];
+} // geo::GeometryHashes::planeHash()
+
+
+//------------------------------------------------------------------------------
+bool geo::GeometryHashes::sameStructure(GeometryHashes const& other) const {
+
+  auto const sameTPC = [](TPCHashes_t const& a, TPCHashes_t const& b)
+    { return a.planes.size() == b.planes.size(); };
+  auto const sameCryostat
+    = [&sameTPC](CryostatHashes_t const& a, CryostatHashes_t const& b)
+    {
+      return std::equal
+        (a.TPCs.begin(), a.TPCs.end(), b.TPCs.begin(), b.TPCs.end(), sameTPC);
+    };
+  return std::equal(fCryostats.begin(), fCryostats.end(),
+    other.fCryostats.begin(), other.fCryostats.end(), sameCryostat);
+
+} // geo::GeometryHashes::sameStructure()
+
+
+//------------------------------------------------------------------------------
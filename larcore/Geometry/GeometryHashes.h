@@ -0,0 +1,130 @@
+/**
+ * @file   larcore/Geometry/GeometryHashes.h
+ * @brief  Content hashes of the detector geometry, per cryostat, TPC and plane.
+ * @see    larcore/Geometry/GeometryHashes.cc
+ */
+
+#ifndef LARCORE_GEOMETRY_GEOMETRYHASHES_H
+#define LARCORE_GEOMETRY_GEOMETRYHASHES_H
+
+// LArSoft libraries
+#include "larcoreobj/SimpleTypesAndConstants/geo_types.h"
+
+// framework libraries
+#include "cetlib/MD5Digest.h"
+
+// C/C++ standard libraries
+#include <vector>
+
+
+namespace geo {
+
+  class GeometryCore;
+
+  /**
+   * @brief Content hashes of the geometry elements, in a hierarchy.
+   *
+   * The hashes are MD5 digests of the geometric description of each element,
+   * built bottom-up ("Merkle tree"):
+   *
+   * * the hash of a plane covers its ID, view, orientation, position and
+   *   the end points of all its wires;
+   * * the hash of a TPC covers its ID, drift direction, volume, active volume
+   *   and the hashes of all its planes;
+   * * the hash of a cryostat covers its ID, volume, the centers of its optical
+   *   detectors and the hashes of all its TPCs;
+   * * the hash of the detector covers its name and the hashes of all its
+   *   cryostats.
+   *
+   * Two elements with the same hash have (to all practical purposes) the same
+   * description, including all their daughters, so that comparing hashes is a
+   * cheap way to check geometry identity, and to find which parts of two
+   * geometries differ. The channel mapping is not included.
+   * Coordinates are hashed by their binary representation, except that
+   * `-0.0` is hashed as `0.0`, so that equal coordinates give the same hash.
+   *
+   * Queries about elements which are not present throw `cet::exception`
+   * (category: `"GeometryHashes"`); `hasCryostat()`, `hasTPC()` and
+   * `hasPlane()` can be used to check first.
+   */
+  class GeometryHashes {
+
+      public:
+
+    /// Type of the hash of each element.
+    using Hash_t = cet::MD5Result;
+
+
+    /// Constructor: no hash at all.
+    GeometryHashes() = default;
+
+    /// Constructor: computes all the hashes of `geom`.
+    explicit GeometryHashes(geo::GeometryCore const& geom);
+
+
+    /// Returns the hash of the whole detector.
+    Hash_t const& detectorHash() const { return fDetector; }
+
+    /// Returns the hash of the cryostat `cid`.
+    Hash_t const& cryostatHash(geo::CryostatID const& cid) const;
+
+    /// Returns the hash of the TPC `tpcid`.
+    Hash_t const& TPCHash(geo::TPCID const& tpcid) const;
+
+    /// Returns the hash of the plane `planeid`.
+    Hash_t const& planeHash(geo::PlaneID const& planeid) const;
+
+
+    /// Returns the number of cryostats.
+    unsigned int nCryostats() const { return fCryostats.size(); }
+
+    /// Returns whether there is a cryostat `cid`.
+    bool hasCryostat(geo::CryostatID const& cid) const
+      { return cid.isValid && (cid.Cryostat < fCryostats.size()); }
+
+    /// Returns whether there is a TPC `tpcid`.
+    bool hasTPC(geo::TPCID const& tpcid) const
+      {
+        return hasCryostat(tpcid)
+          && (tpcid.TPC < fCryostats[tpcid.Cryostat].TPCs.size());
+      }
+
+    /// Returns whether there is a plane `planeid`.
+    bool hasPlane(geo::PlaneID const& planeid) const
+      {
+        return hasTPC(planeid)
+          && (planeid.Plane < TPCentry(planeid).planes.size());
+      }
+
+    /// Returns whether `other` has the same elements (but not content) as us.
+    bool sameStructure(GeometryHashes const& other) const;
+
+
+      private:
+
+    /// Hashes of a TPC and its planes.
+    struct TPCHashes_t {
+      Hash_t hash; ///< Hash of the TPC.
+      std::vector<Hash_t> planes; ///< Hash of each plane.
+    }; // TPCHashes_t
+
+    /// Hashes of a cryostat and its TPCs.
+    struct CryostatHashes_t {
+      Hash_t hash; ///< Hash of the cryostat.
+      std::vector<TPCHashes_t> TPCs; ///< Hashes of each TPC.
+    }; // CryostatHashes_t
+
+    Hash_t fDetector; ///< Hash of the whole detector.
+    std::vector<CryostatHashes_t> fCryostats; ///< Hashes of each cryostat.
+
+    /// Returns the hashes of TPC `tpcid` (no check).
+    TPCHashes_t const& TPCentry(geo::TPCID const& tpcid) const
+      { return fCryostats[tpcid.Cryostat].TPCs[tpcid.TPC]; }
+
+  }; // class GeometryHashes
+
+
+} // namespace geo
+
+
+#endif // LARCORE_GEOMETRY_GEOMETRYHASHES_H
@@ -9,8 +9,9 @@
 #include "larcore/Geometry/Geometry.h"
 
 // lar includes
-#include "larcorealg/Geometry/GeometryBuilderStandard.h"
+#include "larcore/Geometry/GeometryBuilderParallel.h"
 #include "larcore/Geometry/ExptGeoHelperInterface.h"
+#include "larcore/Geometry/SharedMemorySegment.h"
 
 // Framework includes
 #include "art/Framework/Principal/Run.h"
@@ -19,17 +20,129 @@
 #include "canvas/Utilities/Exception.h"
 #include "fhiclcpp/types/Table.h"
 #include "cetlib_except/exception.h"
+#include "cetlib_except/demangle.h"
 #include "cetlib/search_path.h"
 #include "messagefacility/MessageLogger/MessageLogger.h"
 
+// ROOT libraries
+#include "TGeoManager.h"
+#include "RVersion.h" // ROOT_VERSION_CODE
+
 // C/C++ standard libraries
 #include <string>
-#include <algorithm> // std::min()
+#include <fstream>
+#include <sstream>
+#include <iterator> // std::istreambuf_iterator
+#include <algorithm> // std::min(), std::transform(), std::find_if()
+#include <chrono>
+#include <cstdio> // std::rename(), std::remove()
+#include <cstring> // std::memcpy()
+#include <cstdint> // std::uint64_t
+#include <typeinfo>
 #include <cassert>
+#include <unistd.h> // ::getpid(), ::gethostname()
 
 // check that the requirements for geo::Geometry are satisfied
 template struct lar::details::ServiceRequirementsChecker<geo::Geometry>;
 
+namespace {
+
+  /// Space at the start of the shared tables segment for its own header.
+  constexpr std::size_t SharedTablesHeaderSize = 64U;
+
+  /// How long to wait for another process to publish the shared tables.
+  constexpr std::chrono::seconds SharedTablesTimeout { 60 };
+
+  /// Version of the geometry key: to be increased whenever the content of
+  /// the cache files or of the shared tables changes for the same key.
+  constexpr unsigned int GeometryKeyVersion = 1U;
+
+
+  /// Returns a tag unique to this process among all the ones which may share
+  /// a directory, even from different nodes: `<host name>.<process ID>`.
+  std::string processTag() {
+    char hostName[256] = "";
+    if (::gethostname(hostName, sizeof(hostName) - 1U) != 0) hostName[0] = 0;
+    return std::string{ hostName } + "." + std::to_string(::getpid());
+  } // processTag()
+
+
+  /// Tag starting the line of the configuration hashes (version 3+).
+  constexpr char const* ConfigurationHashesTag = "geometry hashes:";
+
+  /// Configuration parameters not affecting the geometry description.
+  constexpr char const* NonGeometryParameters[] = {
+    "SkipConfigurationCheck", "CacheDirectory", "LazyWireTables",
+    "SharedMemoryTables", "PositionEpsilon", "StoreFullConfiguration",
+    "MemoizeChannelMap",
+    "DisableWiresInG4" // Geant4 only; the geometry description is the same
+  };
+
+  /// Builder parameters only affecting how the geometry is built.
+  constexpr char const* NonGeometryBuilderParameters[] = {
+    "parallel", "maxThreads"
+  };
+
+  /// The hashes in a version 3 configuration information.
+  struct ConfigurationHashes_t {
+    std::string configuration; ///< Hash of the canonical configuration.
+    std::string GDML; ///< Hash of the content of the GDML file.
+  }; // ConfigurationHashes_t
+
+
+  /// Returns the builder configuration without the execution-only settings.
+  fhicl::ParameterSet CanonicalBuilderParameters
+    (fhicl::ParameterSet builderConfig)
+  {
+    for (char const* key: NonGeometryBuilderParameters)
+      builderConfig.erase(key);
+    return builderConfig;
+  } // CanonicalBuilderParameters()
+
+
+  /// Returns the hash of the geometry-relevant part of `config`.
+  std::string ConfigurationHash(fhicl::ParameterSet config) {
+    for (char const* key: NonGeometryParameters) config.erase(key);
+    fhicl::ParameterSet builderConfig;
+    if (config.get_if_present("Builder", builderConfig)) {
+      config.put_or_replace
+        ("Builder", CanonicalBuilderParameters(std::move(builderConfig)));
+    }
+    // `to_string()` is canonical: keys are always written in the same order
+    return cet::MD5Digest{ config.to_string() }.digest().toString();
+  } // ConfigurationHash()
+
+
+  /// Returns the line describing the configuration hashes.
+  std::string ConfigurationHashesLine(ConfigurationHashes_t const& hashes) {
+    return std::string(ConfigurationHashesTag)
+      + " configuration=" + hashes.configuration + " gdml=" + hashes.GDML;
+  } // ConfigurationHashesLine()
+
+
+  /// Extracts the hashes from a version 3 configuration information.
+  /// @return whether the hashes were found
+  bool ParseConfigurationHashes
+    (std::string const& text, ConfigurationHashes_t& hashes)
+  {
+    std::istringstream line { text.substr(0, text.find('\n')) };
+    std::string tag1, tag2, configuration, GDML;
+    line >> tag1 >> tag2 >> configuration >> GDML;
+    if (tag1 + " " + tag2 != ConfigurationHashesTag) return false;
+
+    std::string const configurationKey = "configuration=";
+    std::string const GDMLkey = "gdml=";
+    if (configuration.compare(0, configurationKey.length(), configurationKey))
+      return false;
+    if (GDML.compare(0, GDMLkey.length(), GDMLkey)) return false;
+
+    hashes.configuration = configuration.substr(configurationKey.length());
+    hashes.GDML = GDML.substr(GDMLkey.length());
+    return true;
+  } // ParseConfigurationHashes()
+
+} // local namespace
+
 namespace geo {
 
   //......................................................................
@@ -39,8 +152,15 @@ namespace geo {
     , fRelPath          (pset.get< std::string       >("RelativePath",     ""   ))
     , fDisableWiresInG4 (pset.get< bool              >("DisableWiresInG4", false))
     , fNonFatalConfCheck(pset.get< bool              >("SkipConfigurationCheck", false))
+    , fStoreFullConfiguration(pset.get< bool         >("StoreFullConfiguration", false))
     , fSortingParameters(pset.get<fhicl::ParameterSet>("SortingParameters", fhicl::ParameterSet() ))
     , fBuilderParameters(pset.get<fhicl::ParameterSet>("Builder",          fhicl::ParameterSet() ))
+    , fCoreParameters   (pset)
+    , fCacheDirectory   (pset.get< std::string       >("CacheDirectory",   ""   ))
+    , fLazyWireTables   (pset.get< bool              >("LazyWireTables",   false))
+    , fSharedMemoryTables(pset.get< bool             >("SharedMemoryTables", false))
+    , fMemoizeChannelMap(pset.get< bool              >("MemoizeChannelMap", false))
+    , fPositionWiggle   (1.0 + pset.get< double      >("PositionEpsilon",  1.e-4))
   {
     
     if (pset.has_key("ForceUseFCLOnly")) {
@@ -50,9 +170,12 @@ namespace geo {
     
     // add a final directory separator ("/") to fRelPath if not already there
     if (!fRelPath.empty() && (fRelPath.back() != '/')) fRelPath += '/';
+    if (!fCacheDirectory.empty() && (fCacheDirectory.back() != '/'))
+      fCacheDirectory += '/';
 
     // register a callback to be executed when a new run starts
     reg.sPreBeginRun.watch(this, &Geometry::preBeginRun);
+    reg.sPostEndJob.watch(this, &Geometry::postEndJob);
 
     //......................................................................
     // 5.15.12 BJR: use the gdml file for both the fGDMLFile and fROOTFile
@@ -68,15 +191,17 @@ namespace geo {
     
     FillGeometryConfigurationInfo(pset);
 
+    // this is a new provider: providers cached from a previous one are stale
+    lar::invalidateCachedProviders();
+
   } // Geometry::Geometry()
 
 
   void Geometry::preBeginRun(art::Run const& run)
   {
-    
-    sumdata::GeometryConfigurationInfo const inputGeomInfo
+    sumdata::GeometryConfigurationInfo const& inputGeomInfo
       = ReadConfigurationInfo(run);
-    if (!CheckConfigurationInfo(inputGeomInfo)) {
+    if (!CheckConfigurationInfoMemoized(inputGeomInfo)) {
       if (fNonFatalConfCheck) {
         // disable the non-fatal option if you need the details
         mf::LogWarning("Geometry") << "Geometry used for " << run.id()
@@ -98,20 +223,431 @@ namespace geo {
   } // Geometry::preBeginRun()
 
 
+  void Geometry::postEndJob()
+  {
+    // the provider (this service) is going away
+    lar::invalidateCachedProviders();
+
+    ConfigurationCheckCounts_t const checks = ConfigurationCheckCounts();
+    mf::LogDebug("Geometry")
+      << "Run configuration checks: " << checks.performed << " performed, "
+      << checks.cached << " reused.";
+
+    if (!fLazyWireTables) return;
+
+    mf::LogInfo("Geometry")
+      << "Wire-level lookup tables were filled for " << NMaterializedPlanes()
+      << "/" << Tables().wireToChannel().nPlanes() << " wire planes"
+      << "; wire arrays were filled for " << NMaterializedWireArrayPlanes()
+      << "/" << Tables().wireArrays().nPlanes() << " wire planes.";
+
+  } // Geometry::postEndJob()
+
+
   //......................................................................
   void Geometry::InitializeChannelMap()
   {
     // the channel map is responsible of calling the channel map configuration
     // of the geometry
+    ApplyChannelMap(MakeChannelMapAlg(fSortingParameters));
+  } // Geometry::InitializeChannelMap()
+
+  //......................................................................
+  std::unique_ptr<geo::ChannelMapAlg> Geometry::MakeChannelMapAlg
+    (fhicl::ParameterSet const& sortingParameters) const
+  {
     art::ServiceHandle<geo::ExptGeoHelperInterface const> helper{};
-    auto channelMapAlg = helper->ConfigureChannelMapAlg(fSortingParameters,
+    auto channelMapAlg = helper->ConfigureChannelMapAlg(sortingParameters,
                                                         DetectorName());
     if (!channelMapAlg) {
       throw cet::exception("ChannelMapLoadFail")
         << " failed to load new channel map";
     }
-    ApplyChannelMap(move(channelMapAlg));
-  } // Geometry::InitializeChannelMap()
+    return channelMapAlg;
+  } // Geometry::MakeChannelMapAlg()
+
+  //......................................................................
+  std::unique_ptr<geo::GeometryCore> Geometry::MakeGeometryWithChannelMap
+    (std::unique_ptr<geo::ChannelMapAlg> channelMap) const
+  {
+    auto geom = std::make_unique<geo::GeometryCore>(fCoreParameters);
+
+    fhicl::Table<geo::GeometryBuilderParallel::Config> const config{fBuilderParameters, {"tool_type"}};
+    geo::GeometryBuilderParallel builder{config()};
+
+    // without forced reload, the ROOT geometry already loaded is reused
+    geom->LoadGeometryFile(GDMLFile(), ROOTFile(), builder, false);
+    geom->ApplyChannelMap(std::move(channelMap));
+    return geom;
+  } // Geometry::MakeGeometryWithChannelMap()
+
+  //......................................................................
+  Geometry::LookupTables_t::LookupTables_t
+    (geo::GeometryCore const& geom, bool lazyPlanes, double positionWiggle)
+    : fGeom(&geom)
+    , fLazyPlanes(lazyPlanes)
+    , fPositionWiggle(positionWiggle)
+    {}
+
+  //......................................................................
+  template <typename Table, typename Fill>
+  Table const& Geometry::LookupTables_t::get
+    (OnDemand_t<Table> const& onDemand, Fill fill)
+  {
+    std::call_once(onDemand.filled, [&onDemand, &fill]()
+      { onDemand.table = fill(); });
+    return onDemand.table;
+  } // Geometry::LookupTables_t::get()
+
+  //......................................................................
+  geo::ChannelToWireTable const&
+  Geometry::LookupTables_t::channelToWires() const
+  {
+    return get(fChannelToWires,
+      [this](){ return geo::ChannelToWireTable{ *fGeom }; });
+  } // Geometry::LookupTables_t::channelToWires()
+
+  //......................................................................
+  geo::WireToChannelTable const&
+  Geometry::LookupTables_t::wireToChannel() const
+  {
+    return get(fWireToChannel,
+      [this](){ return geo::WireToChannelTable{ *fGeom, fLazyPlanes }; });
+  } // Geometry::LookupTables_t::wireToChannel()
+
+  //......................................................................
+  geo::WireArraysStore const& Geometry::LookupTables_t::wireArrays() const
+  {
+    return get(fWireArrays,
+      [this](){ return geo::WireArraysStore{ *fGeom, fLazyPlanes }; });
+  } // Geometry::LookupTables_t::wireArrays()
+
+  //......................................................................
+  geo::WireCoordinateTable const&
+  Geometry::LookupTables_t::wireCoordinates() const
+  {
+    return get(fWireCoordinates,
+      [this](){ return geo::WireCoordinateTable{ *fGeom }; });
+  } // Geometry::LookupTables_t::wireCoordinates()
+
+  //......................................................................
+  geo::TPCPositionIndex const& Geometry::LookupTables_t::positionIndex() const
+  {
+    return get(fPositionIndex,
+      [this](){ return geo::TPCPositionIndex{ *fGeom, fPositionWiggle }; });
+  } // Geometry::LookupTables_t::positionIndex()
+
+  //......................................................................
+  geo::OpDetChannelTable const&
+  Geometry::LookupTables_t::opDetChannels() const
+  {
+    return get(fOpDetChannels,
+      [this](){ return geo::OpDetChannelTable{ *fGeom }; });
+  } // Geometry::LookupTables_t::opDetChannels()
+
+  //......................................................................
+  geo::GeometryHashes const& Geometry::LookupTables_t::hashes() const
+  {
+    return get(fHashes, [this](){ return geo::GeometryHashes{ *fGeom }; });
+  } // Geometry::LookupTables_t::hashes()
+
+  //......................................................................
+  void Geometry::LookupTables_t::setChannelMapTables(
+    geo::WireToChannelTable wireToChannel,
+    geo::ChannelToWireTable channelToWires,
+    std::shared_ptr<void const> data /* = {} */
+  ) {
+    // the tables are not in use yet, so no query can be filling them:
+    // the flags are just marked, and the tables may be replaced again
+    std::call_once(fWireToChannel.filled, [](){});
+    std::call_once(fChannelToWires.filled, [](){});
+    fWireToChannel.table = std::move(wireToChannel);
+    fChannelToWires.table = std::move(channelToWires);
+    fChannelMapData = std::move(data);
+  } // Geometry::LookupTables_t::setChannelMapTables()
+
+  //......................................................................
+  void Geometry::BuildLookupTables()
+  {
+    // most tables are filled only on their first query
+    auto tables = std::make_unique<LookupTables_t>
+      (*this, fLazyWireTables, fPositionWiggle);
+
+    if (fSharedMemoryTables || (fMemoizeChannelMap && !fCacheDirectory.empty()))
+      PrepareChannelMapTables(*tables);
+
+    fLookupTables = std::move(tables);
+
+  } // Geometry::BuildLookupTables()
+
+  //......................................................................
+  void Geometry::PrepareChannelMapTables(LookupTables_t& tables) const
+  {
+    // tables shared with other processes or memoized are always completely
+    // filled, and right away
+    if (fSharedMemoryTables && AttachSharedLookupTables(tables)) return;
+    // the memo lives only in files
+    bool const memoize = fMemoizeChannelMap && !fCacheDirectory.empty();
+    if (!memoize || !UseMemoizedChannelMapTables(tables)) {
+      tables.setChannelMapTables(
+        geo::WireToChannelTable{ *this, false },
+        geo::ChannelToWireTable{ *this }
+        );
+      if (memoize) MemoizeChannelMapTables(tables);
+    }
+    if (fSharedMemoryTables) PublishSharedLookupTables(tables);
+
+    MF_LOG_DEBUG("Geometry")
+      << "Channel to wire table: " << tables.channelToWires().nWires()
+      << " wires on " << tables.channelToWires().nChannels() << " channels"
+      << "\nWire to channel table: " << tables.wireToChannel().nWires()
+      << " wires";
+
+  } // Geometry::PrepareChannelMapTables()
+
+  //......................................................................
+  std::string Geometry::SharedTablesSegmentName() const
+  {
+    // the version tag must change whenever the layout of the tables does
+    return "/larcore_geometry_v2_" + fGeometryKey;
+  } // Geometry::SharedTablesSegmentName()
+
+  //......................................................................
+  geo::ChannelMapTablesMemo::Key_t Geometry::ChannelMapTablesKey
+    (LookupTables_t const& tables) const
+  {
+    // the channel mapping algorithm is chosen by the helper service
+    geo::ExptGeoHelperInterface const& helper
+      = *(art::ServiceHandle<geo::ExptGeoHelperInterface const>{});
+    return geo::ChannelMapTablesMemo::makeKey(
+      DetectorName(), cet::demangle_symbol(typeid(helper).name()),
+      fSortingParameters, tables.hashes().detectorHash()
+      );
+  } // Geometry::ChannelMapTablesKey()
+
+  //......................................................................
+  bool Geometry::UseMemoizedChannelMapTables(LookupTables_t& tables) const
+  {
+    art::ServiceHandle<geo::ExptGeoHelperInterface const> helper{};
+    auto memoized = helper->ChannelMapMemo().find
+      (ChannelMapTablesKey(tables), fCacheDirectory);
+    if (!memoized) return false;
+
+    tables.setChannelMapTables(std::move(memoized->wireToChannel),
+      std::move(memoized->channelToWires), std::move(memoized->data));
+
+    mf::LogInfo("Geometry") << "Using memoized channel mapping tables.";
+    return true;
+  } // Geometry::UseMemoizedChannelMapTables()
+
+  //......................................................................
+  void Geometry::MemoizeChannelMapTables(LookupTables_t& tables) const
+  {
+    art::ServiceHandle<geo::ExptGeoHelperInterface const> helper{};
+    auto memoized = helper->ChannelMapMemo().store(ChannelMapTablesKey(tables),
+      tables.wireToChannel(), tables.channelToWires(), fCacheDirectory);
+
+    // replace our own copy of the tables with the memoized one
+    tables.setChannelMapTables(std::move(memoized.wireToChannel),
+      std::move(memoized.channelToWires), std::move(memoized.data));
+  } // Geometry::MemoizeChannelMapTables()
+
+  //......................................................................
+  bool Geometry::AttachSharedLookupTables(LookupTables_t& tables) const
+  {
+    std::string const name = SharedTablesSegmentName();
+    geo::SharedMemorySegment segment
+      = geo::SharedMemorySegment::attach(name, SharedTablesTimeout);
+    if (!segment.isValid()) return false;
+
+    // the segment header holds the offset of the channel-to-wire table;
+    // the wire-to-channel table follows the header
+    std::byte const* const data = segment.data();
+    std::size_t const size = segment.size();
+    std::uint64_t channelToWireOffset = 0U;
+    if (size >= SharedTablesHeaderSize)
+      std::memcpy(&channelToWireOffset, data, sizeof(channelToWireOffset));
+
+    // a segment from an incompatible or misbehaving job is not trusted:
+    // the tables must fit between the header and the end of the segment
+    if ((channelToWireOffset < SharedTablesHeaderSize)
+      || (channelToWireOffset > size)
+      || (channelToWireOffset % sizeof(std::uint64_t) != 0U)
+      || !geo::WireToChannelTable::validView(data + SharedTablesHeaderSize,
+        channelToWireOffset - SharedTablesHeaderSize)
+      || !geo::ChannelToWireTable::validView
+        (data + channelToWireOffset, size - channelToWireOffset)
+    ) {
+      mf::LogWarning("Geometry")
+        << "Shared memory segment '" << name << "' (" << size
+        << " bytes) does not hold valid channel mapping tables:"
+        " this process will use its own.";
+      return false;
+    }
+
+    tables.setChannelMapTables(
+      geo::WireToChannelTable::view(data + SharedTablesHeaderSize),
+      geo::ChannelToWireTable::view(data + channelToWireOffset),
+      std::make_shared<geo::SharedMemorySegment>(std::move(segment))
+      );
+
+    mf::LogInfo("Geometry")
+      << "Using the channel mapping tables in shared memory segment '"
+      << name << "' (" << size << " bytes)";
+    return true;
+  } // Geometry::AttachSharedLookupTables()
+
+  //......................................................................
+  void Geometry::PublishSharedLookupTables(LookupTables_t& tables) const
+  {
+    auto const aligned = [](std::size_t n){ return (n + 63U) / 64U * 64U; };
+    std::size_t const channelToWireOffset
+      = SharedTablesHeaderSize
+      + aligned(tables.wireToChannel().serializedSize());
+    std::size_t const size
+      = channelToWireOffset + tables.channelToWires().serializedSize();
+
+    std::string const name = SharedTablesSegmentName();
+    geo::SharedMemorySegment segment
+      = geo::SharedMemorySegment::create(name, size);
+    if (!segment.isValid()) {
+      // another process has created the segment since we looked for it
+      if (AttachSharedLookupTables(tables)) return;
+      mf::LogWarning("Geometry")
+        << "Shared memory segment '" << name << "' is not available:"
+        " this process will use its own channel mapping tables.";
+      return;
+    }
+
+    std::byte* const data = segment.writableData();
+    std::uint64_t const offset = channelToWireOffset;
+    std::memcpy(data, &offset, sizeof(offset));
+    tables.wireToChannel().serialize(data + SharedTablesHeaderSize);
+    tables.channelToWires().serialize(data + channelToWireOffset);
+    segment.markReady();
+
+    // replace our own copy of the tables with the shared one
+    tables.setChannelMapTables(
+      geo::WireToChannelTable::view(segment.data() + SharedTablesHeaderSize),
+      geo::ChannelToWireTable::view(segment.data() + channelToWireOffset),
+      std::make_shared<geo::SharedMemorySegment>(std::move(segment))
+      );
+
+    mf::LogInfo("Geometry")
+      << "Channel mapping tables published in shared memory segment '"
+      << name << "' (" << size << " bytes)";
+  } // Geometry::PublishSharedLookupTables()
+
+  //......................................................................
+  void Geometry::PlaneWireToChannel(
+    util::span<geo::WireID const*> wireIDs,
+    util::span<raw::ChannelID_t*> channels
+  ) const {
+    if (channels.size() < wireIDs.size()) {
+      throw cet::exception("Geometry")
+        << "PlaneWireToChannel(): room for only " << channels.size()
+        << " channels for " << wireIDs.size() << " wires.\n";
+    }
+    std::transform(wireIDs.begin(), wireIDs.end(), channels.begin(),
+      [&table=Tables().wireToChannel()](geo::WireID const& wireID)
+        { return table.channel(wireID); }
+      );
+  } // Geometry::PlaneWireToChannel(span)
+
+  //......................................................................
+  void Geometry::WireCoordinates(
+    util::span<geo::Point_t const*> points, geo::PlaneID const& planeID,
+    util::span<double*> coords
+  ) const {
+    CheckWireCoordinatePlane(planeID, "WireCoordinates");
+    if (coords.size() < points.size()) {
+      throw cet::exception("Geometry")
+        << "WireCoordinates(): room for only " << coords.size()
+        << " coordinates for " << points.size() << " points.\n";
+    }
+    Tables().wireCoordinates().wireCoordinates(points, planeID, coords);
+  } // Geometry::WireCoordinates()
+
+  //......................................................................
+  void Geometry::NearestWires(
+    util::span<geo::Point_t const*> points, geo::PlaneID const& planeID,
+    util::span<geo::WireID::WireID_t*> wires
+  ) const {
+    CheckWireCoordinatePlane(planeID, "NearestWires");
+    if (wires.size() < points.size()) {
+      throw cet::exception("Geometry")
+        << "NearestWires(): room for only " << wires.size()
+        << " wires for " << points.size() << " points.\n";
+    }
+    Tables().wireCoordinates().nearestWires(points, planeID, wires);
+  } // Geometry::NearestWires()
+
+  //......................................................................
+  void Geometry::NearestWireIDs(
+    util::span<geo::Point_t const*> points,
+    util::span<geo::PlaneID const*> planeIDs,
+    util::span<geo::WireID*> wireIDs
+  ) const {
+    std::size_t const n = points.size();
+    if ((planeIDs.size() < n) || (wireIDs.size() < n)) {
+      throw cet::exception("Geometry")
+        << "NearestWireIDs(): " << n << " points, but " << planeIDs.size()
+        << " planes and room for " << wireIDs.size() << " wires.\n";
+    }
+
+    geo::WireCoordinateTable const& wireCoordinates
+      = Tables().wireCoordinates();
+    auto iPlane = planeIDs.begin();
+    auto iWire = wireIDs.begin();
+    for (geo::Point_t const& point: points) {
+      geo::PlaneID const& planeID = *(iPlane++);
+      geo::WireID& wireID = *(iWire++);
+      if (wireCoordinates.hasPlane(planeID)) {
+        wireID
+          = { planeID, wireCoordinates.nearestWire(point, planeID) };
+      }
+      else wireID = {}; // invalid
+    } // for
+  } // Geometry::NearestWireIDs()
+
+  //......................................................................
+  void Geometry::PositionToTPCIDs(
+    util::span<geo::Point_t const*> points,
+    util::span<geo::TPCID*> TPCIDs
+  ) const {
+    if (TPCIDs.size() < points.size()) {
+      throw cet::exception("Geometry")
+        << "PositionToTPCIDs(): room for only " << TPCIDs.size()
+        << " TPC IDs for " << points.size() << " points.\n";
+    }
+    std::transform(points.begin(), points.end(), TPCIDs.begin(),
+      [&index=Tables().positionIndex()](geo::Point_t const& point)
+        { return index.TPCat(point); }
+      );
+  } // Geometry::PositionToTPCIDs()
+
+  //......................................................................
+  void Geometry::OpDetGeosFromOpChannels(
+    util::span<unsigned int const*> opChannels,
+    util::span<geo::OpDetGeo const**> opDets
+  ) const {
+    if (opDets.size() < opChannels.size()) {
+      throw cet::exception("Geometry")
+        << "OpDetGeosFromOpChannels(): room for only " << opDets.size()
+        << " optical detectors for " << opChannels.size() << " channels.\n";
+    }
+    Tables().opDetChannels().opDets(opChannels, opDets);
+  } // Geometry::OpDetGeosFromOpChannels()
+
+  //......................................................................
+  void Geometry::CheckWireCoordinatePlane
+    (geo::PlaneID const& planeID, const char* caller) const
+  {
+    if (Tables().wireCoordinates().hasPlane(planeID)) return;
+    throw cet::exception("Geometry")
+      << caller << "(): plane " << std::string(planeID)
+      << " is not present in the detector.\n";
+  } // Geometry::CheckWireCoordinatePlane()
 
   //......................................................................
   void Geometry::LoadNewGeometry(
@@ -151,32 +687,134 @@ namespace geo {
         << "\nbail ungracefully.\n";
     }
 
+    // key of this geometry configuration, for the cache and the shared tables
+    // (the hash of the description is also part of the configuration check)
+    fDescriptionHash = FileContentHash(ROOTfile);
+    fGeometryKey = (fCacheDirectory.empty() && !fSharedMemoryTables)
+      ? std::string{}: GeometryKey(fDescriptionHash);
+
+    // if there is already a cached description of this geometry, ROOT will
+    // load that one instead; otherwise, we'll write one after loading
+    std::string newCacheFile;
+    if (!fCacheDirectory.empty()) {
+      std::string const cacheFile = GeometryCacheFilePath();
+      if (std::ifstream{cacheFile}.good()) {
+        mf::LogInfo("Geometry")
+          << "Loading geometry description from cache file '" << cacheFile
+          << "' (instead of '" << ROOTfile << "')";
+        ROOTfile = cacheFile;
+      }
+      else newCacheFile = cacheFile;
+    }
+
     {
-      fhicl::Table<geo::GeometryBuilderStandard::Config> const config{fBuilderParameters, {"tool_type"}};
-      geo::GeometryBuilderStandard builder{config()};
+      fhicl::Table<geo::GeometryBuilderParallel::Config> const config{fBuilderParameters, {"tool_type"}};
+      geo::GeometryBuilderParallel builder{config()};
 
       // initialize the geometry with the files we have found
       LoadGeometryFile(GDMLfile, ROOTfile, builder, bForceReload);
     }
 
+    if (!newCacheFile.empty()) WriteGeometryCache(newCacheFile);
+
     // now update the channel map
     InitializeChannelMap();
 
+    BuildLookupTables();
+
   } // Geometry::LoadNewGeometry()
 
+  //......................................................................
+  std::string Geometry::GeometryKey
+    (cet::MD5Result const& descriptionHash) const
+  {
+    // the channel mapping (hence the sorting of the geometry) depends on the
+    // helper service, and the cached description on the ROOT version
+    geo::ExptGeoHelperInterface const& helper
+      = *(art::ServiceHandle<geo::ExptGeoHelperInterface const>{});
+    cet::MD5Digest key;
+    key.append("version=" + std::to_string(GeometryKeyVersion)
+      + " ROOT=" + std::to_string(ROOT_VERSION_CODE));
+    key.append(cet::demangle_symbol(typeid(helper).name()));
+    key.append(descriptionHash.toString());
+    key.append(CanonicalBuilderParameters(fBuilderParameters).to_string());
+    key.append(fSortingParameters.to_string());
+    return key.digest().toString();
+  } // Geometry::GeometryKey()
+
+  //......................................................................
+  std::string Geometry::GeometryCacheFilePath() const
+  {
+    return fCacheDirectory + fGeometryKey + ".root";
+  } // Geometry::GeometryCacheFilePath()
+
+  //......................................................................
+  void Geometry::WriteGeometryCache(std::string const& cacheFile) const
+  {
+    // write under a unique name first, so that no other job may read a partial
+    // file; the final renaming is atomic; the name keeps the ".root" suffix,
+    // which ROOT uses to choose the output format; the cache directory may be
+    // shared by jobs on different nodes, whose process IDs may coincide
+    std::string const tempFile
+      = cacheFile.substr(0, cacheFile.rfind(".root")) // "<hash>"
+      + "." + processTag() + ".tmp.root";
+
+    if (!gGeoManager || (gGeoManager->Export(tempFile.c_str()) == 0)) {
+      std::remove(tempFile.c_str());
+      mf::LogWarning("Geometry")
+        << "Failed to write the geometry description cache file '"
+        << tempFile << "'.";
+      return;
+    }
+    if (std::rename(tempFile.c_str(), cacheFile.c_str()) != 0) {
+      std::remove(tempFile.c_str());
+      mf::LogWarning("Geometry")
+        << "Failed to move the geometry description cache into '"
+        << cacheFile << "'.";
+      return;
+    }
+
+    mf::LogInfo("Geometry")
+      << "Geometry description cached into '" << cacheFile << "'";
+
+  } // Geometry::WriteGeometryCache()
+
+  //......................................................................
+  cet::MD5Result Geometry::FileContentHash(std::string const& path)
+  {
+    std::ifstream file{ path, std::ios::binary };
+    if (!file) {
+      throw cet::exception("Geometry")
+        << "cannot read the geometry file '" << path << "' for hashing.\n";
+    }
+    std::string const content{
+      std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{}
+      };
+    return cet::MD5Digest{ content }.digest();
+  } // Geometry::FileContentHash()
+
   //......................................................................
   void Geometry::FillGeometryConfigurationInfo
     (fhicl::ParameterSet const& config)
   {
     
     sumdata::GeometryConfigurationInfo confInfo;
-    confInfo.dataVersion = sumdata::GeometryConfigurationInfo::DataVersion_t{2};
+    confInfo.dataVersion = sumdata::GeometryConfigurationInfo::DataVersion_t{3};
     
     // version 1+:
     confInfo.detectorName = DetectorName();
     
-    // version 2+:
-    confInfo.geometryServiceConfiguration = config.to_indented_string();
+    // version 2+: service configuration;
+    // version 3+: hashes line, then the full configuration only if requested
+    ConfigurationHashes_t const hashes {
+      ConfigurationHash(config),     // configuration
+      fDescriptionHash.toString()    // GDML
+      };
+    confInfo.geometryServiceConfiguration = ConfigurationHashesLine(hashes);
+    if (fStoreFullConfiguration) {
+      confInfo.geometryServiceConfiguration
+        += "\n" + config.to_indented_string();
+    }
     fConfInfo = std::move(confInfo);
     
     MF_LOG_TRACE("Geometry")
@@ -184,6 +822,32 @@ namespace geo {
     
   } // Geometry::FillGeometryConfigurationInfo()
 
+  //......................................................................
+  bool Geometry::CheckConfigurationInfoMemoized
+    (sumdata::GeometryConfigurationInfo const& other)
+  {
+    // configurations are compared by content, without copies; from version 3
+    // on the content is short (unless the full configuration is stored)
+    auto const sameContent = [&other](CheckedConfiguration_t const& checked)
+      {
+        return (checked.info.dataVersion == other.dataVersion)
+          && (checked.info.detectorName == other.detectorName)
+          && (checked.info.geometryServiceConfiguration
+            == other.geometryServiceConfiguration);
+      };
+    auto const iCheck = std::find_if(fCheckedConfigurations.begin(),
+      fCheckedConfigurations.end(), sameContent);
+    if (iCheck != fCheckedConfigurations.end()) {
+      ++fNCachedConfigurationChecks;
+      return iCheck->compatible;
+    }
+
+    ++fNConfigurationChecks;
+    bool const compatible = CheckConfigurationInfo(other);
+    fCheckedConfigurations.push_back({ other, compatible });
+    return compatible;
+  } // Geometry::CheckConfigurationInfoMemoized()
+  
   //......................................................................
   bool Geometry::CheckConfigurationInfo
     (sumdata::GeometryConfigurationInfo const& other) const
@@ -227,6 +891,8 @@ namespace geo {
      * 
      * * both informations must be valid
      * * the detector names must exactly match
+     * * if both are version 3 or newer, the configuration and GDML hashes
+     *   must exactly match
      * 
      */
     
@@ -241,8 +907,7 @@ namespace geo {
       return false;
     }
     
-    // currently used only in debug mode (assert())
-    [[maybe_unused]] auto const commonVersion = std::min(A.dataVersion, B.dataVersion);
+    auto const commonVersion = std::min(A.dataVersion, B.dataVersion);
     
     assert(commonVersion >= 1);
     
@@ -253,6 +918,28 @@ namespace geo {
       return false;
     }
     
+    if (commonVersion < 3) return true;
+    
+    ConfigurationHashes_t hashesA, hashesB;
+    if (!ParseConfigurationHashes(A.geometryServiceConfiguration, hashesA)
+      || !ParseConfigurationHashes(B.geometryServiceConfiguration, hashesB)
+    ) {
+      mf::LogWarning("Geometry") << "Geometry::CompareConfigurationInfo(): "
+        "configuration hashes not found";
+      return false;
+    }
+    if (hashesA.GDML != hashesB.GDML) {
+      mf::LogWarning("Geometry") << "Geometry::CompareConfigurationInfo(): "
+        "GDML content mismatch: " << hashesA.GDML << " vs. " << hashesB.GDML;
+      return false;
+    }
+    if (hashesA.configuration != hashesB.configuration) {
+      mf::LogWarning("Geometry") << "Geometry::CompareConfigurationInfo(): "
+        "configuration mismatch: " << hashesA.configuration << " vs. "
+        << hashesB.configuration;
+      return false;
+    }
+    
     return true;
   } // CompareConfigurationInfo()
 
@@ -0,0 +1,116 @@
+/**
+ * @file   larcore/Geometry/LazyPlaneInitializer.h
+ * @brief  Thread-safe, on-demand initialization of per-plane data.
+ * @see    larcore/Geometry/WireToChannelTable.h
+ *
+ * This library is header-only.
+ */
+
+#ifndef LARCORE_GEOMETRY_LAZYPLANEINITIALIZER_H
+#define LARCORE_GEOMETRY_LAZYPLANEINITIALIZER_H
+
+// C/C++ standard libraries
+#include <mutex> // std::call_once(), std::once_flag
+#include <atomic>
+#include <memory> // std::unique_ptr
+#include <utility> // std::forward()
+#include <cstddef> // std::size_t
+
+
+namespace geo {
+
+  /**
+   * @brief Keeps track of the initialization of data of each wire plane.
+   *
+   * Objects holding data per wire plane may use this class to fill the data of
+   * each plane only when it is needed for the first time.
+   * The data of each plane is initialized exactly once, even if the first
+   * requests come concurrently from different threads (the other threads wait
+   * for the initialization to complete).
+   * After the initialization, checking the state of a plane costs a single
+   * atomic load.
+   *
+   * Example:
+   * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+   * initializer.ensure(iPlane, [this, iPlane](){ fillPlane(iPlane); });
+   * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+   * Planes are identified by an index, which is usually the one from
+   * `geo::PlaneIndexShape`.
+   *
+   * The object can be moved, but not while it's being used.
+   */
+  class LazyPlaneInitializer {
+
+      public:
+
+    /// Constructor: no planes.
+    LazyPlaneInitializer() = default;
+
+    /// Constructor: `nPlanes` planes, all uninitialized.
+    explicit LazyPlaneInitializer(std::size_t nPlanes)
+      : fState(std::make_unique<State_t>(nPlanes))
+      {}
+
+
+    /// Returns the number of tracked planes.
+    std::size_t nPlanes() const { return fState? fState->nPlanes: 0U; }
+
+    /// Returns the number of planes whose data has been initialized.
+    std::size_t nInitialized() const
+      { return fState? fState->nInitialized.load(): 0U; }
+
+    /// Returns whether the data of the plane `iPlane` is initialized.
+    bool isInitialized(std::size_t iPlane) const
+      { return fState->planes[iPlane].ready.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Makes sure the data of plane `iPlane` is initialized.
+     * @tparam Init type of the callable performing the initialization
+     * @param iPlane index of the plane
+     * @param init callable initializing the data of the plane
+     *
+     * If the plane is not initialized yet, `init()` is called, and the plane
+     * is declared initialized after it returns.
+     * If `init()` throws an exception, the plane is left uninitialized.
+     */
+    template <typename Init>
+    void ensure(std::size_t iPlane, Init&& init) const
+      {
+        PlaneState_t& plane = fState->planes[iPlane];
+        if (plane.ready.load(std::memory_order_acquire)) return;
+        std::call_once(plane.flag, [&plane, &init, &state=*fState](){
+            std::forward<Init>(init)();
+            plane.ready.store(true, std::memory_order_release);
+            ++state.nInitialized;
+          });
+      }
+
+
+      private:
+
+    /// Initialization state of a single plane.
+    struct PlaneState_t {
+      std::once_flag flag; ///< Ensures a single initialization.
+      std::atomic<bool> ready { false }; ///< Whether initialization is done.
+    }; // PlaneState_t
+
+    /// The full state (not movable, hence allocated).
+    struct State_t {
+      std::size_t nPlanes; ///< Number of planes.
+      std::unique_ptr<PlaneState_t[]> planes; ///< State of each plane.
+      std::atomic<std::size_t> nInitialized { 0U }; ///< Initialized planes.
+
+      State_t(std::size_t nPlanes)
+        : nPlanes(nPlanes), planes(std::make_unique<PlaneState_t[]>(nPlanes))
+        {}
+    }; // State_t
+
+    std::unique_ptr<State_t> fState; ///< Initialization state.
+
+  }; // class LazyPlaneInitializer
+
+
+} // namespace geo
+
+
+#endif // LARCORE_GEOMETRY_LAZYPLANEINITIALIZER_H
@@ -0,0 +1,116 @@
+/**
+ * @file   larcore/Geometry/OpDetChannelTable.h
+ * @brief  Dense table of the optical detector of each optical channel.
+ * @see    larcore/Geometry/Geometry.h
+ *
+ * This library is header-only.
+ */
+
+#ifndef LARCORE_GEOMETRY_OPDETCHANNELTABLE_H
+#define LARCORE_GEOMETRY_OPDETCHANNELTABLE_H
+
+// LArSoft libraries
+#include "larcorealg/Geometry/GeometryCore.h"
+#include "larcorealg/Geometry/OpDetGeo.h"
+#include "larcorealg/CoreUtils/span.h"
+
+// framework libraries
+#include "cetlib_except/exception.h"
+
+// C/C++ standard libraries
+#include <vector>
+#include <algorithm> // std::max(), std::transform()
+#include <cstddef> // std::size_t
+
+
+namespace geo {
+
+  /**
+   * @brief Table of the optical detector of each optical channel.
+   *
+   * The table has one entry for each optical channel number, from `0` to the
+   * largest channel in the detector, pointing to the geometry object of the
+   * optical detector the channel belongs to, or `nullptr` if the channel is
+   * not valid.
+   *
+   * The table is filled once from the geometry (where the channel mapping
+   * may throw an exception for invalid channels); queries are plain array
+   * accesses, never throw and can be performed concurrently.
+   * The pointers refer to the geometry the table was built from.
+   */
+  class OpDetChannelTable {
+
+      public:
+
+    /// Type of optical channel number.
+    using OpChannel_t = unsigned int;
+
+
+    /// Constructor: an empty table.
+    OpDetChannelTable() = default;
+
+    /// Constructor: fills the table from the specified `geom`.
+    explicit OpDetChannelTable(geo::GeometryCore const& geom);
+
+
+    /// Returns the number of entries in the table.
+    std::size_t size() const { return fOpDets.size(); }
+
+    /// Returns the optical detector of `opChannel` (`nullptr` if invalid).
+    geo::OpDetGeo const* opDet(OpChannel_t opChannel) const
+      { return (opChannel < fOpDets.size())? fOpDets[opChannel]: nullptr; }
+
+    /**
+     * @brief Fills the optical detectors of all the specified channels.
+     * @param opChannels the optical channels to be queried
+     * @param opDets (output) the optical detectors; at least as long as
+     *               `opChannels`
+     *
+     * Invalid channels are assigned `nullptr`.
+     */
+    void opDets(
+      util::span<OpChannel_t const*> opChannels,
+      util::span<geo::OpDetGeo const**> opDets
+      ) const
+      {
+        std::transform(opChannels.begin(), opChannels.end(), opDets.begin(),
+          [this](OpChannel_t opChannel){ return opDet(opChannel); });
+      }
+
+
+      private:
+
+    /// Optical detector of each channel (`nullptr` for invalid ones).
+    std::vector<geo::OpDetGeo const*> fOpDets;
+
+  }; // class OpDetChannelTable
+
+
+} // namespace geo
+
+
+//------------------------------------------------------------------------------
+//--- inline implementation
+//------------------------------------------------------------------------------
+inline geo::OpDetChannelTable::OpDetChannelTable
+  (geo::GeometryCore const& geom)
+{
+  unsigned int const nChannels = geom.NOpChannels();
+  if (nChannels == 0U) return;
+
+  fOpDets.resize(std::max(nChannels, geom.MaxOpChannel() + 1U), nullptr);
+  for (OpChannel_t opChannel = 0; opChannel < fOpDets.size(); ++opChannel) {
+    if (!geom.IsValidOpChannel(opChannel)) continue;
+    try {
+      fOpDets[opChannel] = &(geom.OpDetGeoFromOpChannel(opChannel));
+    }
+    catch (cet::exception const&) {} // invalid channel: leave it null
+  } // for
+
+} // geo::OpDetChannelTable::OpDetChannelTable()
+
+
+//------------------------------------------------------------------------------
+
+
+#endif // LARCORE_GEOMETRY_OPDETCHANNELTABLE_H
@@ -0,0 +1,306 @@
+/**
+ * @file   larcore/Geometry/SharedMemorySegment.cc
+ * @brief  Named POSIX shared memory segment, written once and then read-only.
+ * @see    larcore/Geometry/SharedMemorySegment.h
+ */
+
+// library header
+#include "larcore/Geometry/SharedMemorySegment.h"
+
+// framework libraries
+#include "cetlib_except/exception.h"
+
+// POSIX libraries
+#include <sys/mman.h> // shm_open(), mmap()...
+#include <sys/stat.h> // fstat()
+#include <fcntl.h> // O_* constants
+#include <signal.h> // kill()
+#include <unistd.h> // ftruncate(), close(), getpid()
+
+// C/C++ standard libraries
+#include <atomic>
+#include <thread> // std::this_thread::sleep_for()
+#include <new> // placement new
+#include <utility> // std::exchange()
+#include <cstring> // std::strerror()
+#include <cerrno>
+#include <cstdint> // std::uint64_t, std::uint32_t, std::int64_t
+
+
+//------------------------------------------------------------------------------
+namespace {
+
+  /// Header at the start of each segment.
+  struct SegmentHeader_t {
+
+    /// Tag identifying our segments ("LARGEOSM").
+    static constexpr std::uint64_t Magic = 0x4c415247454f534dULL;
+
+    std::uint64_t magic = Magic; ///< Always `Magic`.
+    std::uint64_t size = 0U; ///< Size of the content [bytes].
+    std::atomic<std::uint32_t> ready { 0U }; ///< Whether content is complete.
+    /// Creation time of the segment [s since the epoch].
+    std::int64_t creationTime = 0;
+    /// Process ID of the creator (`0` until the header is complete).
+    std::atomic<std::int64_t> creatorPID { 0 };
+
+  }; // SegmentHeader_t
+
+  /// Space reserved for the header; keeps the content aligned to 64 bytes.
+  constexpr std::size_t HeaderSize = 64U;
+
+  static_assert(sizeof(SegmentHeader_t) <= HeaderSize,
+    "Segment header does not fit its reserved space");
+  static_assert(std::atomic<std::uint32_t>::is_always_lock_free,
+    "Lock-free atomics are required for the interprocess ready flag");
+  static_assert(std::atomic<std::int64_t>::is_always_lock_free,
+    "Lock-free atomics are required for the interprocess creator ID");
+
+
+  /// Polling interval while waiting for a segment to become ready.
+  constexpr std::chrono::milliseconds PollInterval { 10 };
+
+
+  /// Throws an exception describing the failure of a system call.
+  [[noreturn]] void throwSystemError
+    (std::string const& what, std::string const& name)
+  {
+    int const error = errno;
+    throw cet::exception("SharedMemorySegment")
+      << what << " failed for shared memory segment '" << name << "': "
+      << std::strerror(error) << "\n";
+  } // throwSystemError()
+
+
+  /// Returns the header of the segment mapped at `mapping`.
+  SegmentHeader_t* header(void* mapping)
+    { return static_cast<SegmentHeader_t*>(mapping); }
+
+
+  /// Returns the current time in seconds since the epoch.
+  std::int64_t now() {
+    return std::chrono::duration_cast<std::chrono::seconds>
+      (std::chrono::system_clock::now().time_since_epoch()).count();
+  } // now()
+
+
+  /// Returns whether the process with ID `pid` is still running.
+  bool isRunning(std::int64_t pid)
+    { return (::kill(static_cast<pid_t>(pid), 0) == 0) || (errno == EPERM); }
+
+
+  /// Returns whether the segment with `head` header will never become ready.
+  bool isStale(SegmentHeader_t const& head) {
+    std::int64_t const creator
+      = head.creatorPID.load(std::memory_order_acquire);
+    if (creator == 0) return false; // the creator is still writing the header
+    return !isRunning(creator) || (now() - head.creationTime
+      > geo::SharedMemorySegment::MaxSetupTime.count());
+  } // isStale()
+
+
+  /// Removes the segment `name` if it is still the one described by `info`.
+  void removeStale(std::string const& name, struct stat const& info) {
+
+    // another process may have removed the stale segment and created a new
+    // one with the same name in the meanwhile: that one must stay
+    int const fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) return;
+    struct stat current;
+    bool const same = (::fstat(fd, &current) == 0)
+      && (current.st_dev == info.st_dev) && (current.st_ino == info.st_ino);
+    ::close(fd);
+    if (same) ::shm_unlink(name.c_str());
+
+  } // removeStale()
+
+} // local namespace
+
+
+//------------------------------------------------------------------------------
+geo::SharedMemorySegment::SharedMemorySegment
+  (SharedMemorySegment&& from) noexcept
+  : fName(std::move(from.fName))
+  , fMapping(std::exchange(from.fMapping, nullptr))
+  , fMappedSize(std::exchange(from.fMappedSize, 0U))
+  , fSize(std::exchange(from.fSize, 0U))
+  , fWritable(std::exchange(from.fWritable, false))
+  {}
+
+
+//------------------------------------------------------------------------------
+auto geo::SharedMemorySegment::operator= (SharedMemorySegment&& from) noexcept
+  -> SharedMemorySegment&
+{
+  if (&from == this) return *this;
+  unmap();
+  fName = std::move(from.fName);
+  fMapping = std::exchange(from.fMapping, nullptr);
+  fMappedSize = std::exchange(from.fMappedSize, 0U);
+  fSize = std::exchange(from.fSize, 0U);
+  fWritable = std::exchange(from.fWritable, false);
+  return *this;
+} // geo::SharedMemorySegment::operator=
+
+
+//------------------------------------------------------------------------------
+geo::SharedMemorySegment::~SharedMemorySegment() { unmap(); }
+
+
+//------------------------------------------------------------------------------
+auto geo::SharedMemorySegment::create
+  (std::string const& name, std::size_t size) -> SharedMemorySegment
+{
+  int const fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+  if (fd < 0) {
+    if (errno == EEXIST) return {}; // somebody else got there first
+    throwSystemError("shm_open()", name);
+  }
+
+  std::size_t const mappedSize = HeaderSize + size;
+  if (::ftruncate(fd, mappedSize) != 0) {
+    ::close(fd);
+    ::shm_unlink(name.c_str());
+    throwSystemError("ftruncate()", name);
+  }
+
+  void* const mapping
+    = ::mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd); // the mapping stays valid
+  if (mapping == MAP_FAILED) {
+    ::shm_unlink(name.c_str());
+    throwSystemError("mmap()", name);
+  }
+
+  SegmentHeader_t* const head = new (mapping) SegmentHeader_t{}; // not ready
+  head->size = size;
+  head->creationTime = now();
+  head->creatorPID.store(::getpid(), std::memory_order_release);
+
+  SharedMemorySegment segment;
+  segment.fName = name;
+  segment.fMapping = mapping;
+  segment.fMappedSize = mappedSize;
+  segment.fSize = size;
+  segment.fWritable = true;
+  return segment;
+
+} // geo::SharedMemorySegment::create()
+
+
+//------------------------------------------------------------------------------
+auto geo::SharedMemorySegment::attach
+  (std::string const& name, std::chrono::milliseconds timeout)
+  -> SharedMemorySegment
+{
+  auto const deadline = std::chrono::steady_clock::now() + timeout;
+
+  int const fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+  if (fd < 0) {
+    if (errno == ENOENT) return {};
+    throwSystemError("shm_open()", name);
+  }
+
+  // the creator may not have set the size yet
+  struct stat info;
+  while (true) {
+    if (::fstat(fd, &info) != 0) {
+      ::close(fd);
+      throwSystemError("fstat()", name);
+    }
+    if (std::size_t(info.st_size) >= HeaderSize) break;
+    // the creator sets the size right after creating the segment:
+    // if it has not done it for this long, it never will
+    if (now() - info.st_ctime > MaxSetupTime.count()) {
+      ::close(fd);
+      removeStale(name, info);
+      return {};
+    }
+    if (std::chrono::steady_clock::now() >= deadline) {
+      ::close(fd);
+      return {};
+    }
+    std::this_thread::sleep_for(PollInterval);
+  } // while
+
+  std::size_t const mappedSize = info.st_size;
+  void* const mapping
+    = ::mmap(nullptr, mappedSize, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (mapping == MAP_FAILED) throwSystemError("mmap()", name);
+
+  SharedMemorySegment segment;
+  segment.fName = name;
+  segment.fMapping = mapping;
+  segment.fMappedSize = mappedSize;
+
+  SegmentHeader_t const* const head = header(segment.fMapping);
+  while (head->ready.load(std::memory_order_acquire) == 0U) {
+    if (isStale(*head)) { // the creator is gone: nobody will complete it
+      removeStale(name, info);
+      return {};
+    }
+    if (std::chrono::steady_clock::now() >= deadline) return {};
+    std::this_thread::sleep_for(PollInterval);
+  }
+
+  if ((head->magic != SegmentHeader_t::Magic)
+    || (HeaderSize + head->size > mappedSize))
+  {
+    throw cet::exception("SharedMemorySegment")
+      << "Shared memory segment '" << name << "' has unexpected content.\n";
+  }
+
+  segment.fSize = head->size;
+  return segment;
+
+} // geo::SharedMemorySegment::attach()
+
+
+//------------------------------------------------------------------------------
+void geo::SharedMemorySegment::remove(std::string const& name) {
+  if ((::shm_unlink(name.c_str()) != 0) && (errno != ENOENT))
+    throwSystemError("shm_unlink()", name);
+} // geo::SharedMemorySegment::remove()
+
+
+//------------------------------------------------------------------------------
+std::byte const* geo::SharedMemorySegment::data() const {
+  return isValid()
+    ? static_cast<std::byte const*>(fMapping) + HeaderSize: nullptr;
+} // geo::SharedMemorySegment::data()
+
+
+//------------------------------------------------------------------------------
+std::byte* geo::SharedMemorySegment::writableData() {
+  if (!fWritable) {
+    throw cet::exception("SharedMemorySegment")
+      << "Shared memory segment '" << fName << "' is read-only.\n";
+  }
+  return static_cast<std::byte*>(fMapping) + HeaderSize;
+} // geo::SharedMemorySegment::writableData()
+
+
+//------------------------------------------------------------------------------
+void geo::SharedMemorySegment::markReady() {
+  if (!fWritable) {
+    throw cet::exception("SharedMemorySegment")
+      << "Shared memory segment '" << fName << "' is read-only.\n";
+  }
+  header(fMapping)->ready.store(1U, std::memory_order_release);
+  if (::mprotect(fMapping, fMappedSize, PROT_READ) == 0) fWritable = false;
+} // geo::SharedMemorySegment::markReady()
+
+
+//------------------------------------------------------------------------------
+void geo::SharedMemorySegment::unmap() noexcept {
+  if (!fMapping) return;
+  ::munmap(fMapping, fMappedSize);
+  fMapping = nullptr;
+  fMappedSize = 0U;
+  fSize = 0U;
+  fWritable = false;
+} // geo::SharedMemorySegment::unmap()
+
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,126 @@
+/**
+ * @file   larcore/Geometry/SharedMemorySegment.h
+ * @brief  Named POSIX shared memory segment, written once and then read-only.
+ * @see    larcore/Geometry/SharedMemorySegment.cc
+ */
+
+#ifndef LARCORE_GEOMETRY_SHAREDMEMORYSEGMENT_H
+#define LARCORE_GEOMETRY_SHAREDMEMORYSEGMENT_H
+
+// C/C++ standard libraries
+#include <string>
+#include <chrono>
+#include <cstddef> // std::size_t, std::byte
+
+
+namespace geo {
+
+  /**
+   * @brief A named POSIX shared memory segment, shared by processes on a node.
+   *
+   * The segment has a single writer: the process which creates it (`create()`)
+   * fills its content and then declares it ready (`markReady()`). All the
+   * other processes attach to it (`attach()`) read-only, after it is ready.
+   * The creation is exclusive: if two processes try to create the same
+   * segment, only one succeeds, and the other should attach instead.
+   *
+   * A segment persists in the system (typically, as a file in `/dev/shm`)
+   * until it is explicitly removed (`remove()`), even after all the processes
+   * using it have ended. Unmapping happens on destruction.
+   *
+   * The segment records the process ID of its creator and its creation time.
+   * A segment which is not ready is _stale_ if its creator is not running any
+   * more, or if it was created more than `MaxSetupTime` ago: such a segment
+   * will never become ready, and `attach()` removes it and returns
+   * immediately, so that the caller can create it anew. The creator is
+   * looked for in the process ID namespace of the caller, so processes
+   * sharing a segment should also share that namespace.
+   *
+   * Failures in the system calls are reported by throwing `cet::exception`
+   * (category: `"SharedMemorySegment"`), except for the expected failures of
+   * `create()` (segment already exists) and `attach()` (segment not existing
+   * or not ready in time), which yield an invalid segment.
+   */
+  class SharedMemorySegment {
+
+      public:
+
+    /// Time after which a segment still not ready is considered stale.
+    static constexpr std::chrono::seconds MaxSetupTime { 300 };
+
+
+    /// Constructor: an invalid segment.
+    SharedMemorySegment() = default;
+
+    SharedMemorySegment(SharedMemorySegment&& from) noexcept;
+    SharedMemorySegment& operator= (SharedMemorySegment&& from) noexcept;
+    SharedMemorySegment(SharedMemorySegment const&) = delete;
+    SharedMemorySegment& operator= (SharedMemorySegment const&) = delete;
+
+    /// Destructor: unmaps the segment (which is not removed).
+    ~SharedMemorySegment();
+
+
+    /**
+     * @brief Creates a new segment.
+     * @param name name of the segment (e.g. `/myjob_data`)
+     * @param size size of the content [bytes]
+     * @return the new segment, writable, or an invalid one if it exists already
+     */
+    static SharedMemorySegment create(std::string const& name, std::size_t size);
+
+    /**
+     * @brief Attaches read-only to an existing segment.
+     * @param name name of the segment
+     * @param timeout how long to wait for the segment to become ready
+     * @return the segment, or an invalid one if missing or not ready in time
+     *
+     * A stale segment is removed, and an invalid segment is returned.
+     */
+    static SharedMemorySegment attach
+      (std::string const& name, std::chrono::milliseconds timeout);
+
+    /// Removes the segment with the specified `name` from the system.
+    static void remove(std::string const& name);
+
+
+    /// Returns whether this object is mapped to a segment.
+    bool isValid() const { return fMapping != nullptr; }
+
+    /// Returns whether this object has created (and may write) the segment.
+    bool isWritable() const { return fWritable; }
+
+    /// Returns the name of the segment.
+    std::string const& name() const { return fName; }
+
+    /// Returns the size of the content of the segment [bytes].
+    std::size_t size() const { return fSize; }
+
+    /// Returns a pointer to the content of the segment.
+    std::byte const* data() const;
+
+    /// Returns a pointer to the content of the segment (writable segments only).
+    std::byte* writableData();
+
+    /// Declares the content complete, allowing other processes to attach.
+    void markReady();
+
+
+      private:
+
+    std::string fName; ///< Name of the segment.
+    void* fMapping = nullptr; ///< Start of the memory mapping (with header).
+    std::size_t fMappedSize = 0U; ///< Size of the mapping [bytes].
+    std::size_t fSize = 0U; ///< Size of the content [bytes].
+    bool fWritable = false; ///< Whether we created the segment.
+
+    /// Unmaps the segment, if mapped.
+    void unmap() noexcept;
+
+  }; // class SharedMemorySegment
+
+
+} // namespace geo
+
+
+#endif // LARCORE_GEOMETRY_SHAREDMEMORYSEGMENT_H
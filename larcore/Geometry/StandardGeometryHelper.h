@@ -24,6 +24,15 @@ namespace geo
    *
    * This ExptGeoHelperInterface implementation serves a ChannelMapStandardAlg
    * for experiments that are known to work well with it.
+   *
+   * Configuration parameters
+   * -------------------------
+   *
+   * - *TabulatedChannelMap* (boolean, default: `false`): if set, the
+   *   `geo::ChannelMapStandardAlg` is wrapped in a
+   *   `geo::TabulatedChannelMapAlg`, which enumerates it once at
+   *   initialization and then answers the channel, wire, TPC set and readout
+   *   plane queries from precomputed tables
    */
   class StandardGeometryHelper : public ExptGeoHelperInterface {
   public:
@@ -33,6 +42,8 @@ namespace geo
     ChannelMapAlgPtr_t
     doConfigureChannelMapAlg(fhicl::ParameterSet const& sortingParameters,
                              std::string const& detectorName) const override;
+
+    bool fTabulatedChannelMap; ///< Whether to tabulate the channel mapping.
   };
 
 }
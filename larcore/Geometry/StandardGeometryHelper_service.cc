@@ -8,6 +8,7 @@
 #include "larcore/Geometry/StandardGeometryHelper.h"
 
 // LArSoft libraries
+#include "larcore/Geometry/TabulatedChannelMapAlg.h"
 #include "larcorealg/Geometry/ChannelMapStandardAlg.h"
 #include "larcorealg/Geometry/GeometryCore.h"
 
@@ -18,7 +19,9 @@ namespace geo
 {
 
   //----------------------------------------------------------------------------
-  StandardGeometryHelper::StandardGeometryHelper(fhicl::ParameterSet const&)
+  StandardGeometryHelper::StandardGeometryHelper
+    (fhicl::ParameterSet const& pset)
+    : fTabulatedChannelMap(pset.get<bool>("TabulatedChannelMap", false))
   {}
 
   //----------------------------------------------------------------------------
@@ -26,9 +29,17 @@ namespace geo
   StandardGeometryHelper::doConfigureChannelMapAlg(fhicl::ParameterSet const& sortingParameters,
                                                    std::string const& /*detectorName*/) const
   {
+    auto channelMap
+      = std::make_unique<geo::ChannelMapStandardAlg>(sortingParameters);
+    if (fTabulatedChannelMap) {
+      mf::LogInfo("StandardGeometryHelper")
+        << "Loading channel mapping: ChannelMapStandardAlg (tabulated)";
+      return std::make_unique<geo::TabulatedChannelMapAlg>
+        (std::move(channelMap));
+    }
     mf::LogInfo("StandardGeometryHelper")
       << "Loading channel mapping: ChannelMapStandardAlg";
-    return std::make_unique<geo::ChannelMapStandardAlg>(sortingParameters);
+    return channelMap;
   }
 
 } // namespace geo
@@ -0,0 +1,335 @@
+/**
+ * @file   larcore/Geometry/TPCPositionIndex.h
+ * @brief  Spatial index of cryostats and TPCs for point location queries.
+ * @see    larcore/Geometry/Geometry.h
+ *
+ * This library is header-only.
+ */
+
+#ifndef LARCORE_GEOMETRY_TPCPOSITIONINDEX_H
+#define LARCORE_GEOMETRY_TPCPOSITIONINDEX_H
+
+// LArSoft libraries
+#include "larcorealg/Geometry/GeometryCore.h"
+#include "larcorealg/Geometry/CryostatGeo.h"
+#include "larcorealg/Geometry/TPCGeo.h"
+#include "larcorealg/Geometry/BoxBoundedGeo.h"
+#include "larcoreobj/SimpleTypesAndConstants/geo_types.h"
+
+// C/C++ standard libraries
+#include <vector>
+#include <array>
+#include <algorithm> // std::min(), std::max(), std::clamp()
+#include <limits>
+#include <cmath> // std::cbrt(), std::ceil(), std::floor()
+#include <cstddef> // std::size_t
+
+
+namespace geo {
+
+  /**
+   * @brief Uniform grid of boxes, for fast search of the boxes containing a
+   *        point.
+   *
+   * The grid covers the union of all the boxes, and each of its cells lists
+   * the boxes overlapping it, in their original order. Finding the boxes which
+   * may contain a point takes constant time, after which only those few boxes
+   * need to be checked.
+   *
+   * The boxes are enlarged by the `wiggle` factor used by
+   * `geo::BoxBoundedGeo::ContainsPosition()`, so that the candidates include
+   * all the boxes which that method would accept.
+   */
+  class BoxGridIndex {
+
+      public:
+
+    /// Constructor: an empty index.
+    BoxGridIndex() = default;
+
+    /**
+     * @brief Constructor: indexes the specified boxes.
+     * @param boxes the boxes to be indexed
+     * @param wiggle the enlargement factor used for the containment checks
+     */
+    BoxGridIndex
+      (std::vector<geo::BoxBoundedGeo const*> const& boxes, double wiggle);
+
+    /**
+     * @brief Returns the index of the first box satisfying `test`.
+     * @param point the point to be located
+     * @param test predicate: `test(i)` is `true` if box `i` is a good match
+     * @return the index of the box, or `NoBox` if none matches
+     *
+     * Only the boxes in the grid cell of `point` are tested, in their original
+     * order.
+     */
+    template <typename Test>
+    std::size_t find(geo::Point_t const& point, Test test) const;
+
+    /// Value returned by `find()` when no box matches.
+    static constexpr std::size_t NoBox = std::numeric_limits<std::size_t>::max();
+
+
+      private:
+
+    std::array<double, 3U> fMin; ///< Lower corner of the grid.
+    std::array<double, 3U> fCellSize; ///< Size of the cells.
+    std::array<std::size_t, 3U> fNCells { 0U, 0U, 0U }; ///< Cells per axis.
+
+    /// Index of the first entry of each cell in `fBoxes`, plus the total.
+    std::vector<std::size_t> fCellOffsets;
+
+    std::vector<std::size_t> fBoxes; ///< Indices of the boxes in each cell.
+
+
+    /// Returns the cell number on `axis` of coordinate `c` (no range check).
+    long cellOnAxis(std::size_t axis, double c) const
+      {
+        return
+          static_cast<long>(std::floor((c - fMin[axis]) / fCellSize[axis]));
+      }
+
+    /// Returns the flat index of the cell (`i`, `j`, `k`).
+    std::size_t cellIndex(std::size_t i, std::size_t j, std::size_t k) const
+      { return (i * fNCells[1] + j) * fNCells[2] + k; }
+
+    /// Returns the range along an axis `[ lower, upper ]` enlarged by `wiggle`
+    /// as in `geo::BoxBoundedGeo::ContainsPosition()`.
+    static std::array<double, 2U> enlarged
+      (double lower, double upper, double wiggle)
+      {
+        return {
+          (lower > 0.0)? lower / wiggle: lower * wiggle,
+          (upper < 0.0)? upper / wiggle: upper * wiggle
+        };
+      }
+
+  }; // class BoxGridIndex
+
+
+  /**
+   * @brief Fast location of the cryostat and TPC containing a point.
+   *
+   * The results are the same as the ones of
+   * `geo::GeometryCore::PositionToCryostatID()` and
+   * `geo::GeometryCore::PositionToTPCID()`: the first cryostat containing the
+   * point is chosen, and then the first TPC in that cryostat which contains
+   * the point. Instead of checking all the cryostats and TPCs, only the ones
+   * in the cell of the point in a uniform grid (`geo::BoxGridIndex`) are.
+   *
+   * The index points to the geometry objects it was built from, and it must
+   * be rebuilt when they change.
+   */
+  class TPCPositionIndex {
+
+      public:
+
+    /// Constructor: an empty index.
+    TPCPositionIndex() = default;
+
+    /**
+     * @brief Constructor: indexes all the cryostats and TPCs in `geom`.
+     * @param geom the geometry to be indexed
+     * @param wiggle the tolerance factor of the containment checks
+     *
+     * The `wiggle` value should be `1 + PositionEpsilon`, where
+     * `PositionEpsilon` is the one configured in `geom`.
+     */
+    TPCPositionIndex(geo::GeometryCore const& geom, double wiggle);
+
+    /// Returns the ID of the cryostat containing `point` (invalid if none).
+    geo::CryostatID cryostatAt(geo::Point_t const& point) const
+      {
+        std::size_t const iCryo = findCryostat(point);
+        return (iCryo == BoxGridIndex::NoBox)
+          ? geo::CryostatID{}: fCryostats[iCryo]->ID();
+      }
+
+    /// Returns the ID of the TPC containing `point` (invalid if none).
+    geo::TPCID TPCat(geo::Point_t const& point) const;
+
+    /// Returns the number of indexed TPCs.
+    std::size_t nTPCs() const { return fTPCs.size(); }
+
+
+      private:
+
+    double fWiggle = 1.0; ///< Tolerance factor of the containment checks.
+
+    std::vector<geo::CryostatGeo const*> fCryostats; ///< All the cryostats.
+    std::vector<geo::TPCGeo const*> fTPCs; ///< All the TPCs.
+    std::vector<std::size_t> fTPCcryostat; ///< Cryostat index of each TPC.
+
+    geo::BoxGridIndex fCryostatGrid; ///< Spatial index of the cryostats.
+    geo::BoxGridIndex fTPCGrid; ///< Spatial index of the TPCs.
+
+
+    /// Returns the index of the cryostat containing `point` (or `NoBox`).
+    std::size_t findCryostat(geo::Point_t const& point) const
+      {
+        return fCryostatGrid.find(point, [this, &point](std::size_t i)
+          { return fCryostats[i]->ContainsPosition(point, fWiggle); });
+      }
+
+  }; // class TPCPositionIndex
+
+
+} // namespace geo
+
+
+//------------------------------------------------------------------------------
+//--- inline implementation
+//------------------------------------------------------------------------------
+inline geo::BoxGridIndex::BoxGridIndex
+  (std::vector<geo::BoxBoundedGeo const*> const& boxes, double wiggle)
+{
+  if (boxes.empty()) return;
+
+  //
+  // extent of each box and of the whole grid
+  //
+  using Range_t = std::array<double, 2U>;
+  std::vector<std::array<Range_t, 3U>> ranges;
+  ranges.reserve(boxes.size());
+  std::array<double, 3U> gridMax;
+  fMin.fill(std::numeric_limits<double>::max());
+  gridMax.fill(std::numeric_limits<double>::lowest());
+  for (geo::BoxBoundedGeo const* box: boxes) {
+    std::array<Range_t, 3U> const range {
+      enlarged(box->MinX(), box->MaxX(), wiggle),
+      enlarged(box->MinY(), box->MaxY(), wiggle),
+      enlarged(box->MinZ(), box->MaxZ(), wiggle)
+    };
+    for (std::size_t axis = 0; axis < 3U; ++axis) {
+      fMin[axis] = std::min(fMin[axis], range[axis][0]);
+      gridMax[axis] = std::max(gridMax[axis], range[axis][1]);
+    }
+    ranges.push_back(range);
+  } // for boxes
+
+  //
+  // grid size: about four cells per box
+  //
+  std::size_t const nCellsPerAxis = static_cast<std::size_t>
+    (std::ceil(std::cbrt(4.0 * boxes.size())));
+  for (std::size_t axis = 0; axis < 3U; ++axis) {
+    double const size = gridMax[axis] - fMin[axis];
+    fNCells[axis] = (size > 0.0)? nCellsPerAxis: 1U;
+    fCellSize[axis] = (size > 0.0)? size / fNCells[axis]: 1.0;
+  }
+
+  //
+  // assign the boxes to all the cells they overlap (two passes: count, fill)
+  //
+  auto const cellRange = [this](std::size_t axis, Range_t const& range)
+    {
+      long const last = static_cast<long>(fNCells[axis]) - 1;
+      return std::array<std::size_t, 2U>{
+        std::size_t(std::clamp(cellOnAxis(axis, range[0]), 0L, last)),
+        std::size_t(std::clamp(cellOnAxis(axis, range[1]), 0L, last))
+        };
+    };
+  auto const forEachCell = [&](auto const& range, auto action)
+    {
+      auto const [ iMin, iMax ] = cellRange(0, range[0]);
+      auto const [ jMin, jMax ] = cellRange(1, range[1]);
+      auto const [ kMin, kMax ] = cellRange(2, range[2]);
+      for (std::size_t i = iMin; i <= iMax; ++i)
+        for (std::size_t j = jMin; j <= jMax; ++j)
+          for (std::size_t k = kMin; k <= kMax; ++k)
+            action(cellIndex(i, j, k));
+    };
+
+  std::size_t const nCells = fNCells[0] * fNCells[1] * fNCells[2];
+  std::vector<std::size_t> counts(nCells, 0U);
+  for (auto const& range: ranges)
+    forEachCell(range, [&counts](std::size_t cell){ ++counts[cell]; });
+
+  fCellOffsets.resize(nCells + 1U, 0U);
+  for (std::size_t cell = 0; cell < nCells; ++cell)
+    fCellOffsets[cell + 1] = fCellOffsets[cell] + counts[cell];
+
+  fBoxes.resize(fCellOffsets.back());
+  std::vector<std::size_t> next(fCellOffsets.begin(), fCellOffsets.end() - 1);
+  for (std::size_t iBox = 0; iBox < ranges.size(); ++iBox) {
+    forEachCell(ranges[iBox],
+      [this, &next, iBox](std::size_t cell){ fBoxes[next[cell]++] = iBox; });
+  }
+
+} // geo::BoxGridIndex::BoxGridIndex()
+
+
+//------------------------------------------------------------------------------
+template <typename Test>
+std::size_t geo::BoxGridIndex::find
+  (geo::Point_t const& point, Test test) const
+{
+  if (fCellOffsets.empty()) return NoBox;
+
+  std::array<double, 3U> const coords { point.X(), point.Y(), point.Z() };
+  std::array<std::size_t, 3U> cell;
+  for (std::size_t axis = 0; axis < 3U; ++axis) {
+    if (!(coords[axis] >= fMin[axis])) return NoBox; // also catches NaN
+    long const c = cellOnAxis(axis, coords[axis]);
+    // points on the upper border belong to the last cell
+    if (c == static_cast<long>(fNCells[axis])) cell[axis] = c - 1;
+    else if ((c < 0) || (c > static_cast<long>(fNCells[axis]))) return NoBox;
+    else cell[axis] = c;
+  } // for axes
+
+  std::size_t const iCell = cellIndex(cell[0], cell[1], cell[2]);
+  for (std::size_t i = fCellOffsets[iCell]; i < fCellOffsets[iCell + 1]; ++i)
+    if (test(fBoxes[i])) return fBoxes[i];
+  return NoBox;
+
+} // geo::BoxGridIndex::find()
+
+
+//------------------------------------------------------------------------------
+inline geo::TPCPositionIndex::TPCPositionIndex
+  (geo::GeometryCore const& geom, double wiggle)
+  : fWiggle(wiggle)
+{
+  std::vector<geo::BoxBoundedGeo const*> cryoBoxes, TPCboxes;
+  for (geo::CryostatGeo const& cryo: geom.IterateCryostats()) {
+    fCryostats.push_back(&cryo);
+    cryoBoxes.push_back(&cryo);
+    for (unsigned int t = 0; t < cryo.NTPC(); ++t) {
+      geo::TPCGeo const& tpc = cryo.TPC(t);
+      fTPCs.push_back(&tpc);
+      fTPCcryostat.push_back(fCryostats.size() - 1U);
+      TPCboxes.push_back(&tpc);
+    } // for TPCs
+  } // for cryostats
+
+  fCryostatGrid = geo::BoxGridIndex{ cryoBoxes, fWiggle };
+  fTPCGrid = geo::BoxGridIndex{ TPCboxes, fWiggle };
+
+} // geo::TPCPositionIndex::TPCPositionIndex()
+
+
+//------------------------------------------------------------------------------
+inline geo::TPCID geo::TPCPositionIndex::TPCat
+  (geo::Point_t const& point) const
+{
+  // like `GeometryCore`, we look for TPCs only in the first cryostat
+  // containing the point
+  std::size_t const iCryo = findCryostat(point);
+  if (iCryo == BoxGridIndex::NoBox) return {};
+
+  std::size_t const iTPC = fTPCGrid.find(point, [this, &point, iCryo]
+    (std::size_t i)
+    {
+      return (fTPCcryostat[i] == iCryo)
+        && fTPCs[i]->ContainsPosition(point, fWiggle);
+    });
+  return (iTPC == BoxGridIndex::NoBox)? geo::TPCID{}: fTPCs[iTPC]->ID();
+
+} // geo::TPCPositionIndex::TPCat()
+
+
+//------------------------------------------------------------------------------
+
+
+#endif // LARCORE_GEOMETRY_TPCPOSITIONINDEX_H
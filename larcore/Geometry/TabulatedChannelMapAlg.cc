@@ -0,0 +1,399 @@
+/**
+ * @file   larcore/Geometry/TabulatedChannelMapAlg.cc
+ * @brief  Channel mapping serving the answers of another one from tables.
+ * @see    larcore/Geometry/TabulatedChannelMapAlg.h
+ */
+
+// library header
+#include "larcore/Geometry/TabulatedChannelMapAlg.h"
+
+// LArSoft libraries
+#include "larcorealg/Geometry/CryostatGeo.h"
+#include "larcorealg/Geometry/TPCGeo.h"
+#include "larcorealg/Geometry/PlaneGeo.h"
+
+// framework libraries
+#include "cetlib_except/exception.h"
+
+// C/C++ standard libraries
+#include <algorithm> // std::max()
+#include <utility> // std::move()
+
+
+//------------------------------------------------------------------------------
+geo::TabulatedChannelMapAlg::TabulatedChannelMapAlg
+  (std::unique_ptr<geo::ChannelMapAlg> channelMap)
+  : fChannelMap(std::move(channelMap))
+{
+  if (!fChannelMap) {
+    throw cet::exception("TabulatedChannelMapAlg")
+      << "No channel mapping to be tabulated.\n";
+  }
+} // geo::TabulatedChannelMapAlg::TabulatedChannelMapAlg()
+
+
+//------------------------------------------------------------------------------
+void geo::TabulatedChannelMapAlg::Initialize
+  (geo::GeometryData_t const& geodata)
+{
+  fChannelMap->Initialize(geodata);
+  fillWireTables(geodata);
+  fillReadoutTables();
+} // geo::TabulatedChannelMapAlg::Initialize()
+
+
+//------------------------------------------------------------------------------
+void geo::TabulatedChannelMapAlg::Uninitialize() {
+
+  fPlaneShape = {};
+  fNTPCs.clear();
+  fNPlanes.clear();
+  fPlaneWireOffsets.clear();
+  fWireChannels.clear();
+  fPlaneROPs.clear();
+
+  fNChannels = 0U;
+  fChannelWireOffsets.clear();
+  fChannelWires.clear();
+  fChannelSigTypes.clear();
+  fChannelROPs.clear();
+
+  fMaxTPCsets = 0U;
+  fMaxROPs = 0U;
+  fNTPCsets.clear();
+  fTPCsets.clear();
+  fTPCsetInfo.clear();
+  fNROPs.clear();
+  fROPs.clear();
+
+  fChannelMap->Uninitialize();
+
+} // geo::TabulatedChannelMapAlg::Uninitialize()
+
+
+//------------------------------------------------------------------------------
+std::vector<geo::WireID> geo::TabulatedChannelMapAlg::ChannelToWire
+  (raw::ChannelID_t channel) const
+{
+  if (!hasChannel(channel)) return fChannelMap->ChannelToWire(channel);
+  WireIDs_t const wires = ChannelWires(channel);
+  return { wires.begin(), wires.end() }; // the only allocation
+} // geo::TabulatedChannelMapAlg::ChannelToWire()
+
+
+//------------------------------------------------------------------------------
+auto geo::TabulatedChannelMapAlg::ChannelWires(raw::ChannelID_t channel) const
+  -> WireIDs_t
+{
+  if (!hasChannel(channel)) return { nullptr, nullptr };
+  geo::WireID const* const wires = fChannelWires.data();
+  return {
+    wires + fChannelWireOffsets[channel],
+    wires + fChannelWireOffsets[channel + 1]
+    };
+} // geo::TabulatedChannelMapAlg::ChannelWires()
+
+
+//------------------------------------------------------------------------------
+unsigned int geo::TabulatedChannelMapAlg::Nchannels
+  (readout::ROPID const& ropid) const
+{
+  return hasROP(ropid)
+    ? fROPs[ROPindex(ropid)].nChannels: fChannelMap->Nchannels(ropid);
+} // geo::TabulatedChannelMapAlg::Nchannels(ROPID)
+
+
+//------------------------------------------------------------------------------
+raw::ChannelID_t geo::TabulatedChannelMapAlg::PlaneWireToChannel
+  (geo::WireID const& wireID) const
+{
+  if (!hasWire(wireID)) return fChannelMap->PlaneWireToChannel(wireID);
+  return fWireChannels
+    [fPlaneWireOffsets[fPlaneShape.index(wireID)] + wireID.Wire];
+} // geo::TabulatedChannelMapAlg::PlaneWireToChannel()
+
+
+//------------------------------------------------------------------------------
+unsigned int geo::TabulatedChannelMapAlg::NTPCsets
+  (readout::CryostatID const& cryoid) const
+{
+  return (cryoid.isValid && (cryoid.Cryostat < fNTPCsets.size()))
+    ? fNTPCsets[cryoid.Cryostat]: fChannelMap->NTPCsets(cryoid);
+} // geo::TabulatedChannelMapAlg::NTPCsets()
+
+
+//------------------------------------------------------------------------------
+bool geo::TabulatedChannelMapAlg::HasTPCset
+  (readout::TPCsetID const& tpcsetid) const
+{
+  return hasTPCset(tpcsetid) || fChannelMap->HasTPCset(tpcsetid);
+} // geo::TabulatedChannelMapAlg::HasTPCset()
+
+
+//------------------------------------------------------------------------------
+readout::TPCsetID geo::TabulatedChannelMapAlg::TPCtoTPCset
+  (geo::TPCID const& tpcid) const
+{
+  return hasTPC(tpcid)
+    ? fTPCsets[TPCindex(tpcid)]: fChannelMap->TPCtoTPCset(tpcid);
+} // geo::TabulatedChannelMapAlg::TPCtoTPCset()
+
+
+//------------------------------------------------------------------------------
+std::vector<geo::TPCID> geo::TabulatedChannelMapAlg::TPCsetToTPCs
+  (readout::TPCsetID const& tpcsetid) const
+{
+  return hasTPCset(tpcsetid)
+    ? fTPCsetInfo[TPCsetIndex(tpcsetid)].TPCs
+    : fChannelMap->TPCsetToTPCs(tpcsetid);
+} // geo::TabulatedChannelMapAlg::TPCsetToTPCs()
+
+
+//------------------------------------------------------------------------------
+geo::TPCID geo::TabulatedChannelMapAlg::FirstTPCinTPCset
+  (readout::TPCsetID const& tpcsetid) const
+{
+  return hasTPCset(tpcsetid)
+    ? fTPCsetInfo[TPCsetIndex(tpcsetid)].firstTPC
+    : fChannelMap->FirstTPCinTPCset(tpcsetid);
+} // geo::TabulatedChannelMapAlg::FirstTPCinTPCset()
+
+
+//------------------------------------------------------------------------------
+unsigned int geo::TabulatedChannelMapAlg::NROPs
+  (readout::TPCsetID const& tpcsetid) const
+{
+  return hasTPCset(tpcsetid)
+    ? fNROPs[TPCsetIndex(tpcsetid)]: fChannelMap->NROPs(tpcsetid);
+} // geo::TabulatedChannelMapAlg::NROPs()
+
+
+//------------------------------------------------------------------------------
+bool geo::TabulatedChannelMapAlg::HasROP(readout::ROPID const& ropid) const {
+  return hasROP(ropid) || fChannelMap->HasROP(ropid);
+} // geo::TabulatedChannelMapAlg::HasROP()
+
+
+//------------------------------------------------------------------------------
+readout::ROPID geo::TabulatedChannelMapAlg::WirePlaneToROP
+  (geo::PlaneID const& planeid) const
+{
+  return hasPlane(planeid)
+    ? fPlaneROPs[fPlaneShape.index(planeid)]
+    : fChannelMap->WirePlaneToROP(planeid);
+} // geo::TabulatedChannelMapAlg::WirePlaneToROP()
+
+
+//------------------------------------------------------------------------------
+std::vector<geo::PlaneID> geo::TabulatedChannelMapAlg::ROPtoWirePlanes
+  (readout::ROPID const& ropid) const
+{
+  return hasROP(ropid)
+    ? fROPs[ROPindex(ropid)].planes: fChannelMap->ROPtoWirePlanes(ropid);
+} // geo::TabulatedChannelMapAlg::ROPtoWirePlanes()
+
+
+//------------------------------------------------------------------------------
+std::vector<geo::TPCID> geo::TabulatedChannelMapAlg::ROPtoTPCs
+  (readout::ROPID const& ropid) const
+{
+  return hasROP(ropid)
+    ? fROPs[ROPindex(ropid)].TPCs: fChannelMap->ROPtoTPCs(ropid);
+} // geo::TabulatedChannelMapAlg::ROPtoTPCs()
+
+
+//------------------------------------------------------------------------------
+readout::ROPID geo::TabulatedChannelMapAlg::ChannelToROP
+  (raw::ChannelID_t channel) const
+{
+  return hasChannel(channel)
+    ? fChannelROPs[channel]: fChannelMap->ChannelToROP(channel);
+} // geo::TabulatedChannelMapAlg::ChannelToROP()
+
+
+//------------------------------------------------------------------------------
+raw::ChannelID_t geo::TabulatedChannelMapAlg::FirstChannelInROP
+  (readout::ROPID const& ropid) const
+{
+  return hasROP(ropid)
+    ? fROPs[ROPindex(ropid)].firstChannel
+    : fChannelMap->FirstChannelInROP(ropid);
+} // geo::TabulatedChannelMapAlg::FirstChannelInROP()
+
+
+//------------------------------------------------------------------------------
+geo::PlaneID geo::TabulatedChannelMapAlg::FirstWirePlaneInROP
+  (readout::ROPID const& ropid) const
+{
+  return hasROP(ropid)
+    ? fROPs[ROPindex(ropid)].firstPlane
+    : fChannelMap->FirstWirePlaneInROP(ropid);
+} // geo::TabulatedChannelMapAlg::FirstWirePlaneInROP()
+
+
+//------------------------------------------------------------------------------
+geo::SigType_t geo::TabulatedChannelMapAlg::SignalTypeForChannelImpl
+  (raw::ChannelID_t const channel) const
+{
+  return hasChannel(channel)
+    ? fChannelSigTypes[channel]: fChannelMap->SignalTypeForChannel(channel);
+} // geo::TabulatedChannelMapAlg::SignalTypeForChannelImpl()
+
+
+//------------------------------------------------------------------------------
+void geo::TabulatedChannelMapAlg::fillWireTables
+  (geo::GeometryData_t const& geodata)
+{
+  auto const& cryostats = geodata.cryostats;
+
+  //
+  // shape of the detector
+  //
+  unsigned int maxTPCs = 0U;
+  unsigned int maxPlanes = 0U;
+  fNTPCs.clear();
+  for (geo::CryostatGeo const& cryo: cryostats) {
+    fNTPCs.push_back(cryo.NTPC());
+    maxTPCs = std::max(maxTPCs, cryo.NTPC());
+    for (unsigned int t = 0; t < cryo.NTPC(); ++t)
+      maxPlanes = std::max(maxPlanes, cryo.TPC(t).Nplanes());
+  } // for cryostats
+  fPlaneShape = geo::PlaneIndexShape
+    { static_cast<unsigned int>(cryostats.size()), maxTPCs, maxPlanes };
+
+  fNPlanes.assign(cryostats.size() * maxTPCs, 0U);
+  for (unsigned int c = 0; c < cryostats.size(); ++c) {
+    for (unsigned int t = 0; t < fNTPCs[c]; ++t) {
+      fNPlanes[TPCindex(geo::TPCID{ c, t })]
+        = cryostats[c].TPC(t).Nplanes();
+    }
+  } // for cryostats
+
+  //
+  // wire to channel
+  //
+  std::size_t const nPlanes = fPlaneShape.size();
+  fPlaneWireOffsets.clear();
+  fPlaneWireOffsets.reserve(nPlanes + 1U);
+  fPlaneWireOffsets.push_back(0U);
+  for (std::size_t iPlane = 0; iPlane < nPlanes; ++iPlane) {
+    geo::PlaneID const planeID = fPlaneShape.planeID(iPlane);
+    unsigned int const nWires = hasPlane(planeID)
+      ? cryostats[planeID.Cryostat].TPC(planeID.TPC).Plane(planeID.Plane)
+        .Nwires()
+      : 0U;
+    fPlaneWireOffsets.push_back(fPlaneWireOffsets.back() + nWires);
+  } // for planes
+
+  fWireChannels.resize(fPlaneWireOffsets.back());
+  for (std::size_t iPlane = 0; iPlane < nPlanes; ++iPlane) {
+    geo::PlaneID const planeID = fPlaneShape.planeID(iPlane);
+    std::size_t const offset = fPlaneWireOffsets[iPlane];
+    unsigned int const nWires = fPlaneWireOffsets[iPlane + 1] - offset;
+    for (unsigned int wire = 0; wire < nWires; ++wire) {
+      fWireChannels[offset + wire]
+        = fChannelMap->PlaneWireToChannel(geo::WireID{ planeID, wire });
+    }
+  } // for planes
+
+  //
+  // channel to wires
+  //
+  fNChannels = fChannelMap->Nchannels();
+  fChannelWireOffsets.clear();
+  fChannelWireOffsets.reserve(fNChannels + 1U);
+  fChannelWireOffsets.push_back(0U);
+  fChannelWires.clear();
+  fChannelWires.reserve(fWireChannels.size());
+  fChannelSigTypes.clear();
+  fChannelSigTypes.reserve(fNChannels);
+  for (raw::ChannelID_t channel = 0; channel < fNChannels; ++channel) {
+    std::vector<geo::WireID> const wires = fChannelMap->ChannelToWire(channel);
+    fChannelWires.insert(fChannelWires.end(), wires.begin(), wires.end());
+    fChannelWireOffsets.push_back(fChannelWires.size());
+    fChannelSigTypes.push_back(fChannelMap->SignalTypeForChannel(channel));
+  } // for channels
+
+} // geo::TabulatedChannelMapAlg::fillWireTables()
+
+
+//------------------------------------------------------------------------------
+void geo::TabulatedChannelMapAlg::fillReadoutTables() {
+
+  unsigned int const nCryostats = fPlaneShape.nCryostats();
+
+  fMaxTPCsets = fChannelMap->MaxTPCsets();
+  fMaxROPs = fChannelMap->MaxROPs();
+
+  //
+  // TPC sets
+  //
+  fNTPCsets.assign(nCryostats, 0U);
+  fTPCsetInfo.assign(std::size_t(nCryostats) * fMaxTPCsets, {});
+  fNROPs.assign(fTPCsetInfo.size(), 0U);
+  fROPs.assign(fTPCsetInfo.size() * fMaxROPs, {});
+  for (unsigned int c = 0; c < nCryostats; ++c) {
+    readout::CryostatID const cryoid { c };
+    unsigned int const nTPCsets = fChannelMap->NTPCsets(cryoid);
+    if (nTPCsets > fMaxTPCsets) {
+      throw cet::exception("TabulatedChannelMapAlg")
+        << "Channel mapping reports " << nTPCsets << " TPC sets in "
+        << cryoid << ", but at most " << fMaxTPCsets << " overall.\n";
+    }
+    fNTPCsets[c] = nTPCsets;
+
+    for (readout::TPCsetID::TPCsetID_t s = 0; s < nTPCsets; ++s) {
+      readout::TPCsetID const tpcsetid { cryoid, s };
+      std::size_t const iTPCset = TPCsetIndex(tpcsetid);
+      fTPCsetInfo[iTPCset].firstTPC = fChannelMap->FirstTPCinTPCset(tpcsetid);
+      fTPCsetInfo[iTPCset].TPCs = fChannelMap->TPCsetToTPCs(tpcsetid);
+
+      //
+      // readout planes
+      //
+      unsigned int const nROPs = fChannelMap->NROPs(tpcsetid);
+      if (nROPs > fMaxROPs) {
+        throw cet::exception("TabulatedChannelMapAlg")
+          << "Channel mapping reports " << nROPs << " readout planes in "
+          << tpcsetid << ", but at most " << fMaxROPs << " overall.\n";
+      }
+      fNROPs[iTPCset] = nROPs;
+
+      for (unsigned int r = 0; r < nROPs; ++r) {
+        readout::ROPID const ropid { tpcsetid, r };
+        ROPInfo_t& info = fROPs[ROPindex(ropid)];
+        info.firstChannel = fChannelMap->FirstChannelInROP(ropid);
+        info.nChannels = fChannelMap->Nchannels(ropid);
+        info.firstPlane = fChannelMap->FirstWirePlaneInROP(ropid);
+        info.planes = fChannelMap->ROPtoWirePlanes(ropid);
+        info.TPCs = fChannelMap->ROPtoTPCs(ropid);
+      } // for readout planes
+    } // for TPC sets
+  } // for cryostats
+
+  //
+  // TPC set of each TPC, readout plane of each wire plane and channel
+  //
+  fTPCsets.assign(std::size_t(nCryostats) * fPlaneShape.maxTPCs(), {});
+  fPlaneROPs.assign(fPlaneShape.size(), {});
+  for (unsigned int c = 0; c < nCryostats; ++c) {
+    for (unsigned int t = 0; t < fNTPCs[c]; ++t) {
+      geo::TPCID const tpcid { c, t };
+      fTPCsets[TPCindex(tpcid)] = fChannelMap->TPCtoTPCset(tpcid);
+      for (unsigned int p = 0; p < fNPlanes[TPCindex(tpcid)]; ++p) {
+        geo::PlaneID const planeid { tpcid, p };
+        fPlaneROPs[fPlaneShape.index(planeid)]
+          = fChannelMap->WirePlaneToROP(planeid);
+      } // for planes
+    } // for TPCs
+  } // for cryostats
+
+  fChannelROPs.clear();
+  fChannelROPs.reserve(fNChannels);
+  for (raw::ChannelID_t channel = 0; channel < fNChannels; ++channel)
+    fChannelROPs.push_back(fChannelMap->ChannelToROP(channel));
+
+} // geo::TabulatedChannelMapAlg::fillReadoutTables()
+
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,342 @@
+/**
+ * @file   larcore/Geometry/TabulatedChannelMapAlg.h
+ * @brief  Channel mapping serving the answers of another one from tables.
+ * @see    larcore/Geometry/TabulatedChannelMapAlg.cc
+ */
+
+#ifndef LARCORE_GEOMETRY_TABULATEDCHANNELMAPALG_H
+#define LARCORE_GEOMETRY_TABULATEDCHANNELMAPALG_H
+
+// LArSoft libraries
+#include "larcore/Geometry/WireToChannelTable.h" // geo::PlaneIndexShape
+#include "larcorealg/Geometry/ChannelMapAlg.h"
+#include "larcorealg/CoreUtils/span.h"
+#include "larcoreobj/SimpleTypesAndConstants/readout_types.h"
+#include "larcoreobj/SimpleTypesAndConstants/geo_types.h"
+#include "larcoreobj/SimpleTypesAndConstants/RawTypes.h" // raw::ChannelID_t
+
+// C/C++ standard libraries
+#include <memory> // std::unique_ptr<>
+#include <vector>
+#include <set>
+#include <cstddef> // std::size_t
+
+
+namespace geo {
+
+  /**
+   * @brief Channel mapping answering from tables filled by another mapping.
+   *
+   * This `geo::ChannelMapAlg` wraps another one (any implementation) and,
+   * when initialized, asks it once for the channel of each wire, the wires,
+   * signal type and readout plane of each channel, and the description of
+   * each TPC set and readout plane. All the channel, wire, TPC set and
+   * readout plane queries are then answered by looking up flat arrays,
+   * rather than by running the algorithm of the wrapped mapping.
+   *
+   * Queries about elements not in the tables (e.g. an invalid channel, or a
+   * wire past the end of its plane) are forwarded to the wrapped mapping, so
+   * that the answers, including the errors, are always the same as the
+   * wrapped mapping would give. The geometric queries (`WireCoordinate()`,
+   * `NearestWireID()`), the optical channel queries and the sorting of the
+   * geometry (`Sorter()`) are always forwarded.
+   *
+   * After initialization, the tables are never modified, and the queries can
+   * be performed concurrently as long as the wrapped mapping supports that
+   * for the forwarded ones.
+   *
+   * `ChannelToWire()` must return a new vector, as required by the
+   * `geo::ChannelMapAlg` interface; `ChannelWires()` returns the same wires
+   * as a range into the tables, without allocating any memory.
+   */
+  class TabulatedChannelMapAlg: public geo::ChannelMapAlg {
+
+      public:
+
+    /// Range of wire IDs, pointing into the tables.
+    using WireIDs_t = util::span<geo::WireID const*>;
+
+    /// Constructor: wraps the channel mapping `channelMap` (not initialized).
+    explicit TabulatedChannelMapAlg
+      (std::unique_ptr<geo::ChannelMapAlg> channelMap);
+
+    /// Returns the wrapped channel mapping.
+    geo::ChannelMapAlg const& wrapped() const { return *fChannelMap; }
+
+
+    // --- BEGIN -- Initialization ---------------------------------------------
+    /// Initializes the wrapped mapping, and fills the tables from it.
+    virtual void Initialize(geo::GeometryData_t const& geodata) override;
+
+    /// Removes the tables and uninitializes the wrapped mapping.
+    virtual void Uninitialize() override;
+    // --- END -- Initialization -----------------------------------------------
+
+
+    // --- BEGIN -- TPC channel mapping ----------------------------------------
+    using geo::ChannelMapAlg::PlaneWireToChannel;
+    using geo::ChannelMapAlg::WireCoordinate;
+    using geo::ChannelMapAlg::NearestWireID;
+
+    virtual std::vector<geo::WireID> ChannelToWire
+      (raw::ChannelID_t channel) const override;
+
+    /**
+     * @brief Returns the wires covered by `channel`, without copying them.
+     * @param channel ID of the TPC channel
+     * @return a range of the IDs of all the wires covered by `channel`
+     *
+     * The range is the content of `ChannelToWire(channel)`, and it stays
+     * valid until the mapping is uninitialized.
+     * Channels not in the tables (e.g. invalid ones) yield an empty range,
+     * and they are not forwarded to the wrapped mapping.
+     */
+    WireIDs_t ChannelWires(raw::ChannelID_t channel) const;
+
+    virtual unsigned int Nchannels() const override { return fNChannels; }
+
+    virtual unsigned int Nchannels
+      (readout::ROPID const& ropid) const override;
+
+    virtual raw::ChannelID_t PlaneWireToChannel
+      (geo::WireID const& wireID) const override;
+
+    virtual double WireCoordinate
+      (double YPos, double ZPos, geo::PlaneID const& planeID) const override
+      { return fChannelMap->WireCoordinate(YPos, ZPos, planeID); }
+
+    virtual geo::WireID NearestWireID
+      (TVector3 const& worldPos, geo::PlaneID const& planeID) const override
+      { return fChannelMap->NearestWireID(worldPos, planeID); }
+
+    virtual std::set<geo::PlaneID> const& PlaneIDs() const override
+      { return fChannelMap->PlaneIDs(); }
+    // --- END -- TPC channel mapping ------------------------------------------
+
+
+    // --- BEGIN -- TPC set mapping --------------------------------------------
+    virtual unsigned int NTPCsets
+      (readout::CryostatID const& cryoid) const override;
+
+    virtual unsigned int MaxTPCsets() const override { return fMaxTPCsets; }
+
+    virtual bool HasTPCset(readout::TPCsetID const& tpcsetid) const override;
+
+    virtual readout::TPCsetID TPCtoTPCset
+      (geo::TPCID const& tpcid) const override;
+
+    virtual std::vector<geo::TPCID> TPCsetToTPCs
+      (readout::TPCsetID const& tpcsetid) const override;
+
+    virtual geo::TPCID FirstTPCinTPCset
+      (readout::TPCsetID const& tpcsetid) const override;
+    // --- END -- TPC set mapping ----------------------------------------------
+
+
+    // --- BEGIN -- Readout plane mapping --------------------------------------
+    virtual unsigned int NROPs
+      (readout::TPCsetID const& tpcsetid) const override;
+
+    virtual unsigned int MaxROPs() const override { return fMaxROPs; }
+
+    virtual bool HasROP(readout::ROPID const& ropid) const override;
+
+    virtual readout::ROPID WirePlaneToROP
+      (geo::PlaneID const& planeid) const override;
+
+    virtual std::vector<geo::PlaneID> ROPtoWirePlanes
+      (readout::ROPID const& ropid) const override;
+
+    virtual std::vector<geo::TPCID> ROPtoTPCs
+      (readout::ROPID const& ropid) const override;
+
+    virtual readout::ROPID ChannelToROP
+      (raw::ChannelID_t channel) const override;
+
+    virtual raw::ChannelID_t FirstChannelInROP
+      (readout::ROPID const& ropid) const override;
+
+    virtual geo::PlaneID FirstWirePlaneInROP
+      (readout::ROPID const& ropid) const override;
+    // --- END -- Readout plane mapping ----------------------------------------
+
+
+    // --- BEGIN -- Optical channel mapping (forwarded) ------------------------
+    virtual unsigned int NOpChannels(unsigned int NOpDets) const override
+      { return fChannelMap->NOpChannels(NOpDets); }
+
+    virtual unsigned int MaxOpChannel(unsigned int NOpDets) const override
+      { return fChannelMap->MaxOpChannel(NOpDets); }
+
+    virtual unsigned int NOpHardwareChannels(unsigned int opDet) const override
+      { return fChannelMap->NOpHardwareChannels(opDet); }
+
+    virtual bool IsValidOpChannel
+      (unsigned int opChannel, unsigned int NOpDets) const override
+      { return fChannelMap->IsValidOpChannel(opChannel, NOpDets); }
+
+    virtual unsigned int OpChannel
+      (unsigned int detNum, unsigned int hwchannel = 0) const override
+      { return fChannelMap->OpChannel(detNum, hwchannel); }
+
+    virtual unsigned int OpDetFromOpChannel
+      (unsigned int opChannel) const override
+      { return fChannelMap->OpDetFromOpChannel(opChannel); }
+
+    virtual unsigned int HardwareChannelFromOpChannel
+      (unsigned int opChannel) const override
+      { return fChannelMap->HardwareChannelFromOpChannel(opChannel); }
+    // --- END -- Optical channel mapping (forwarded) --------------------------
+
+
+    /// Returns the sorter of the wrapped mapping.
+    virtual geo::GeoObjectSorter const& Sorter() const override
+      { return fChannelMap->Sorter(); }
+
+
+      private:
+
+    /// Description of a TPC set.
+    struct TPCsetInfo_t {
+      geo::TPCID firstTPC; ///< First TPC.
+      std::vector<geo::TPCID> TPCs; ///< All TPCs.
+    }; // TPCsetInfo_t
+
+    /// Description of a readout plane.
+    struct ROPInfo_t {
+      raw::ChannelID_t firstChannel = raw::InvalidChannelID; ///< First channel.
+      unsigned int nChannels = 0U; ///< Number of channels.
+      geo::PlaneID firstPlane; ///< First wire plane.
+      std::vector<geo::PlaneID> planes; ///< All wire planes.
+      std::vector<geo::TPCID> TPCs; ///< All TPCs.
+    }; // ROPInfo_t
+
+
+    /// The wrapped channel mapping.
+    std::unique_ptr<geo::ChannelMapAlg> fChannelMap;
+
+
+    // --- BEGIN -- Wire tables ------------------------------------------------
+    geo::PlaneIndexShape fPlaneShape; ///< Indexing of the wire planes.
+
+    std::vector<unsigned int> fNTPCs; ///< Number of TPCs in each cryostat.
+
+    std::vector<unsigned int> fNPlanes; ///< Number of planes in each TPC.
+
+    /// Flat index of the first wire of each plane (plus one past the last).
+    std::vector<std::size_t> fPlaneWireOffsets;
+
+    std::vector<raw::ChannelID_t> fWireChannels; ///< Channel of each wire.
+
+    std::vector<readout::ROPID> fPlaneROPs; ///< Readout plane of each plane.
+    // --- END -- Wire tables --------------------------------------------------
+
+
+    // --- BEGIN -- Channel tables ---------------------------------------------
+    unsigned int fNChannels = 0U; ///< Number of TPC channels.
+
+    /// Index of the first wire of each channel (plus one past the last).
+    std::vector<std::size_t> fChannelWireOffsets;
+
+    std::vector<geo::WireID> fChannelWires; ///< Wires of all the channels.
+
+    std::vector<geo::SigType_t> fChannelSigTypes; ///< Type of each channel.
+
+    std::vector<readout::ROPID> fChannelROPs; ///< Readout plane of channels.
+    // --- END -- Channel tables -----------------------------------------------
+
+
+    // --- BEGIN -- Readout tables ---------------------------------------------
+    unsigned int fMaxTPCsets = 0U; ///< Largest number of TPC sets.
+    unsigned int fMaxROPs = 0U; ///< Largest number of readout planes.
+
+    std::vector<unsigned int> fNTPCsets; ///< TPC sets in each cryostat.
+
+    std::vector<readout::TPCsetID> fTPCsets; ///< TPC set of each TPC.
+
+    std::vector<TPCsetInfo_t> fTPCsetInfo; ///< Description of each TPC set.
+
+    std::vector<unsigned int> fNROPs; ///< Readout planes in each TPC set.
+
+    std::vector<ROPInfo_t> fROPs; ///< Description of each readout plane.
+    // --- END -- Readout tables -----------------------------------------------
+
+
+    /// Returns the type of signal on `channel`.
+    virtual geo::SigType_t SignalTypeForChannelImpl
+      (raw::ChannelID_t const channel) const override;
+
+
+    /// Fills the tables of wires and channels.
+    void fillWireTables(geo::GeometryData_t const& geodata);
+
+    /// Fills the tables of TPC sets and readout planes.
+    void fillReadoutTables();
+
+
+    // --- BEGIN -- Indexing ---------------------------------------------------
+    /// Returns whether `tpcid` is in the tables.
+    bool hasTPC(geo::TPCID const& tpcid) const
+      {
+        return tpcid.isValid && (tpcid.Cryostat < fNTPCs.size())
+          && (tpcid.TPC < fNTPCs[tpcid.Cryostat]);
+      }
+
+    /// Returns whether `planeID` is in the tables.
+    bool hasPlane(geo::PlaneID const& planeID) const
+      {
+        return hasTPC(planeID)
+          && (planeID.Plane < fNPlanes[TPCindex(planeID)]);
+      }
+
+    /// Returns whether `wireID` is in the tables.
+    bool hasWire(geo::WireID const& wireID) const
+      {
+        if (!hasPlane(wireID)) return false;
+        std::size_t const iPlane = fPlaneShape.index(wireID);
+        return wireID.Wire
+          < (fPlaneWireOffsets[iPlane + 1] - fPlaneWireOffsets[iPlane]);
+      }
+
+    /// Returns whether `tpcsetid` is in the tables.
+    bool hasTPCset(readout::TPCsetID const& tpcsetid) const
+      {
+        return tpcsetid.isValid && (tpcsetid.Cryostat < fNTPCsets.size())
+          && (tpcsetid.TPCset < fNTPCsets[tpcsetid.Cryostat]);
+      }
+
+    /// Returns whether `ropid` is in the tables.
+    bool hasROP(readout::ROPID const& ropid) const
+      {
+        return hasTPCset(ropid) && (ropid.ROP < fNROPs[TPCsetIndex(ropid)]);
+      }
+
+    /// Returns whether `channel` is in the tables.
+    bool hasChannel(raw::ChannelID_t channel) const
+      { return channel < fNChannels; } // also excludes invalid channel
+
+    /// Returns the flat index of `tpcid` (no check performed).
+    std::size_t TPCindex(geo::TPCID const& tpcid) const
+      {
+        return std::size_t(tpcid.Cryostat) * fPlaneShape.maxTPCs()
+          + tpcid.TPC;
+      }
+
+    /// Returns the flat index of `tpcsetid` (no check performed).
+    std::size_t TPCsetIndex(readout::TPCsetID const& tpcsetid) const
+      {
+        return std::size_t(tpcsetid.Cryostat) * fMaxTPCsets
+          + tpcsetid.TPCset;
+      }
+
+    /// Returns the flat index of `ropid` (no check performed).
+    std::size_t ROPindex(readout::ROPID const& ropid) const
+      { return TPCsetIndex(ropid) * fMaxROPs + ropid.ROP; }
+    // --- END -- Indexing -----------------------------------------------------
+
+  }; // class TabulatedChannelMapAlg
+
+} // namespace geo
+
+
+#endif // LARCORE_GEOMETRY_TABULATEDCHANNELMAPALG_H
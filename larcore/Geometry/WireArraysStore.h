@@ -0,0 +1,267 @@
+/**
+ * @file   larcore/Geometry/WireArraysStore.h
+ * @brief  Structure-of-arrays store of the wire geometry of each plane.
+ * @see    larcore/Geometry/Geometry.h
+ *
+ * This library is header-only.
+ */
+
+#ifndef LARCORE_GEOMETRY_WIREARRAYSSTORE_H
+#define LARCORE_GEOMETRY_WIREARRAYSSTORE_H
+
+// LArSoft libraries
+#include "larcore/Geometry/LazyPlaneInitializer.h"
+#include "larcore/Geometry/WireToChannelTable.h" // geo::PlaneIndexShape
+#include "larcorealg/Geometry/GeometryCore.h"
+#include "larcorealg/Geometry/PlaneGeo.h"
+#include "larcorealg/Geometry/WireGeo.h"
+#include "larcoreobj/SimpleTypesAndConstants/geo_types.h" // geo::PlaneID
+
+// C/C++ standard libraries
+#include <vector>
+#include <new> // std::align_val_t
+#include <cstddef> // std::size_t
+
+
+namespace geo {
+
+  namespace details {
+
+    /// Allocator of memory aligned to `Align` bytes.
+    template <typename T, std::size_t Align>
+    struct AlignedAllocator {
+
+      using value_type = T;
+
+      template <typename U>
+      struct rebind { using other = AlignedAllocator<U, Align>; };
+
+      AlignedAllocator() noexcept = default;
+
+      template <typename U>
+      AlignedAllocator(AlignedAllocator<U, Align> const&) noexcept {}
+
+      T* allocate(std::size_t n)
+        {
+          return static_cast<T*>
+            (::operator new(n * sizeof(T), std::align_val_t{ Align }));
+        }
+
+      void deallocate(T* p, std::size_t) noexcept
+        { ::operator delete(p, std::align_val_t{ Align }); }
+
+    }; // AlignedAllocator
+
+    template <typename T, typename U, std::size_t Align>
+    bool operator==
+      (AlignedAllocator<T, Align> const&, AlignedAllocator<U, Align> const&)
+      { return true; }
+
+    template <typename T, typename U, std::size_t Align>
+    bool operator!=
+      (AlignedAllocator<T, Align> const&, AlignedAllocator<U, Align> const&)
+      { return false; }
+
+  } // namespace details
+
+
+  /**
+   * @brief Geometry of all the wires of a plane, as a structure of arrays.
+   *
+   * Each array has one entry per wire, with the wire number as index.
+   * The coordinates are in the world frame, in centimeters.
+   * The data of each array starts at an address aligned to `Alignment` bytes,
+   * suitable for aligned SIMD loads.
+   */
+  struct PlaneWireArrays {
+
+    using Coord_t = double; ///< Type of the coordinates.
+
+    /// Alignment of the start of the arrays [bytes].
+    static constexpr std::size_t Alignment = 64U;
+
+    /// Type of array of coordinates.
+    using Array_t
+      = std::vector<Coord_t, details::AlignedAllocator<Coord_t, Alignment>>;
+
+    Array_t startX; ///< _x_ coordinate of the start of each wire.
+    Array_t startY; ///< _y_ coordinate of the start of each wire.
+    Array_t startZ; ///< _z_ coordinate of the start of each wire.
+    Array_t endX; ///< _x_ coordinate of the end of each wire.
+    Array_t endY; ///< _y_ coordinate of the end of each wire.
+    Array_t endZ; ///< _z_ coordinate of the end of each wire.
+    Array_t dirX; ///< _x_ component of the direction of each wire.
+    Array_t dirY; ///< _y_ component of the direction of each wire.
+    Array_t dirZ; ///< _z_ component of the direction of each wire.
+
+    /// Returns the number of wires.
+    std::size_t size() const { return startX.size(); }
+
+    /// Returns whether there are no wires.
+    bool empty() const { return startX.empty(); }
+
+  }; // struct PlaneWireArrays
+
+
+  /**
+   * @brief Store of the wire geometry of all the planes as arrays.
+   *
+   * The store contains a `geo::PlaneWireArrays` for each wire plane in the
+   * detector, extracted from the geometry (`geo::PlaneGeo` and
+   * `geo::WireGeo`) after the channel mapping (and therefore the sorting of
+   * the wires) has been applied.
+   *
+   * In _lazy_ mode, the arrays of each plane are filled only when the plane
+   * is queried for the first time (thread-safely, see
+   * `geo::LazyPlaneInitializer`). In that mode, the geometry used to create
+   * the store must stay available for the whole lifetime of the store.
+   */
+  class WireArraysStore {
+
+      public:
+
+    /// Constructor: an empty store.
+    WireArraysStore() = default;
+
+    /**
+     * @brief Constructor: extracts the arrays from the specified `geom`.
+     * @param geom the geometry to extract the wires from
+     * @param lazy whether to fill the arrays of each plane only on demand
+     */
+    explicit WireArraysStore(geo::GeometryCore const& geom, bool lazy = false);
+
+
+    /// Returns the wire arrays of `planeID` (empty if plane is not present).
+    geo::PlaneWireArrays const& plane(geo::PlaneID const& planeID) const
+      {
+        if (!fShape.contains(planeID)) return fEmptyPlane;
+        std::size_t const iPlane = fShape.index(planeID);
+        if (!fPlaneExists[iPlane]) return fEmptyPlane;
+        materializePlane(iPlane);
+        return fPlanes[iPlane];
+      }
+
+    /// Returns the number of planes in the store.
+    std::size_t nPlanes() const { return fNPlanes; }
+
+    /// Returns the number of planes whose arrays have been filled.
+    std::size_t nMaterializedPlanes() const
+      { return fPlaneInit.nInitialized(); }
+
+    /// Fills the arrays of all planes not filled yet.
+    void materializeAll() const;
+
+
+      private:
+
+    geo::PlaneIndexShape fShape; ///< Indexing of the wire planes.
+
+    /// Arrays of each plane (filled lazily in lazy mode).
+    mutable std::vector<geo::PlaneWireArrays> fPlanes;
+
+    geo::PlaneWireArrays fEmptyPlane; ///< Returned for nonexisting planes.
+
+    /// Whether each plane index describes a plane of the detector.
+    std::vector<bool> fPlaneExists;
+
+    std::size_t fNPlanes = 0U; ///< Number of planes in the detector.
+
+    /// Geometry for the lazy filling (`nullptr` if filled at construction).
+    geo::GeometryCore const* fGeom = nullptr;
+
+    geo::LazyPlaneInitializer fPlaneInit; ///< Tracks which planes are filled.
+
+
+    /// Fills the arrays of the plane with index `iPlane` if not done yet.
+    void materializePlane(std::size_t iPlane) const
+      { fPlaneInit.ensure(iPlane, [this, iPlane](){ fillPlane(iPlane); }); }
+
+    /// Fills the arrays of the plane with index `iPlane`.
+    void fillPlane(std::size_t iPlane) const;
+
+  }; // class WireArraysStore
+
+
+} // namespace geo
+
+
+//------------------------------------------------------------------------------
+//--- inline implementation
+//------------------------------------------------------------------------------
+inline geo::WireArraysStore::WireArraysStore
+  (geo::GeometryCore const& geom, bool lazy /* = false */)
+  : fShape{ geom.Ncryostats(), geom.MaxTPCs(), geom.MaxPlanes() }
+  , fPlanes(fShape.size())
+  , fGeom(&geom)
+  , fPlaneInit(fShape.size())
+{
+  // nonexisting planes are never filled, and do not count as materialized
+  fPlaneExists.reserve(fShape.size());
+  for (std::size_t iPlane = 0; iPlane < fShape.size(); ++iPlane) {
+    bool const exists = geom.HasPlane(fShape.planeID(iPlane));
+    fPlaneExists.push_back(exists);
+    if (exists) ++fNPlanes;
+  } // for planes
+
+  if (lazy) return;
+
+  materializeAll();
+  fGeom = nullptr; // not needed any more
+
+} // geo::WireArraysStore::WireArraysStore()
+
+
+//------------------------------------------------------------------------------
+inline void geo::WireArraysStore::materializeAll() const {
+
+  for (std::size_t iPlane = 0; iPlane < fShape.size(); ++iPlane) {
+    if (!fPlaneExists[iPlane]) continue;
+    materializePlane(iPlane);
+  }
+
+} // geo::WireArraysStore::materializeAll()
+
+
+//------------------------------------------------------------------------------
+inline void geo::WireArraysStore::fillPlane(std::size_t iPlane) const {
+
+  geo::PlaneID const planeID = fShape.planeID(iPlane);
+  geo::PlaneGeo const& plane = fGeom->Plane(planeID);
+  unsigned int const nWires = plane.Nwires();
+
+  geo::PlaneWireArrays& arrays = fPlanes[iPlane];
+  for (auto* array: {
+    &arrays.startX, &arrays.startY, &arrays.startZ,
+    &arrays.endX, &arrays.endY, &arrays.endZ,
+    &arrays.dirX, &arrays.dirY, &arrays.dirZ
+    }
+  ) {
+    array->resize(nWires);
+  }
+
+  for (unsigned int iWire = 0; iWire < nWires; ++iWire) {
+    geo::WireGeo const& wire = plane.Wire(iWire);
+
+    auto const start = wire.GetStart();
+    arrays.startX[iWire] = start.X();
+    arrays.startY[iWire] = start.Y();
+    arrays.startZ[iWire] = start.Z();
+
+    auto const end = wire.GetEnd();
+    arrays.endX[iWire] = end.X();
+    arrays.endY[iWire] = end.Y();
+    arrays.endZ[iWire] = end.Z();
+
+    auto const dir = wire.Direction();
+    arrays.dirX[iWire] = dir.X();
+    arrays.dirY[iWire] = dir.Y();
+    arrays.dirZ[iWire] = dir.Z();
+  } // for wires
+
+} // geo::WireArraysStore::fillPlane()
+
+
+//------------------------------------------------------------------------------
+
+
+#endif // LARCORE_GEOMETRY_WIREARRAYSSTORE_H
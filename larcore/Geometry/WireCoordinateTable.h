@@ -0,0 +1,193 @@
+/**
+ * @file   larcore/Geometry/WireCoordinateTable.h
+ * @brief  Table of the wire coordinate projection of each wire plane.
+ * @see    larcore/Geometry/Geometry.h
+ *
+ * This library is header-only.
+ */
+
+#ifndef LARCORE_GEOMETRY_WIRECOORDINATETABLE_H
+#define LARCORE_GEOMETRY_WIRECOORDINATETABLE_H
+
+// LArSoft libraries
+#include "larcore/Geometry/WireToChannelTable.h" // geo::PlaneIndexShape
+#include "larcorealg/Geometry/GeometryCore.h"
+#include "larcorealg/Geometry/PlaneGeo.h"
+#include "larcorealg/CoreUtils/span.h"
+#include "larcoreobj/SimpleTypesAndConstants/geo_types.h" // geo::PlaneID
+
+// C/C++ standard libraries
+#include <vector>
+#include <algorithm> // std::min(), std::max()
+#include <cmath> // std::floor()
+#include <cstddef> // std::size_t
+
+
+namespace geo {
+
+  /**
+   * @brief Table of the wire coordinate of each wire plane, as a linear form.
+   *
+   * The wire coordinate of a point on a plane (as returned by
+   * `geo::PlaneGeo::WireCoordinate()`) is an affine function of the point
+   * position: @f$ w(p) = c_{0} + c_{x} p_{x} + c_{y} p_{y} + c_{z} p_{z} @f$.
+   * This table stores the four coefficients of each plane, so that the
+   * coordinate of many points can be computed in a tight loop, which the
+   * compiler is able to vectorize.
+   *
+   * The coefficients are extracted from the geometry at construction, and
+   * never changed afterwards.
+   */
+  class WireCoordinateTable {
+
+      public:
+
+    /// Type of wire number.
+    using WireNo_t = geo::WireID::WireID_t;
+
+    /// Span of positions to be processed.
+    using Points_t = util::span<geo::Point_t const*>;
+
+
+    /// Constructor: an empty table.
+    WireCoordinateTable() = default;
+
+    /// Constructor: extracts the coefficients of all planes from `geom`.
+    explicit WireCoordinateTable(geo::GeometryCore const& geom);
+
+
+    /// Returns whether `planeID` is present in the table.
+    bool hasPlane(geo::PlaneID const& planeID) const
+      {
+        return fShape.contains(planeID)
+          && (fPlanes[fShape.index(planeID)].nWires > 0U);
+      }
+
+    /// Returns the wire coordinate of `point` on `planeID` (no check).
+    double wireCoordinate
+      (geo::Point_t const& point, geo::PlaneID const& planeID) const
+      { return fPlanes[fShape.index(planeID)].coordinate(point); }
+
+    /// Returns the number of the wire closest to `point` on `planeID`
+    /// (no check).
+    WireNo_t nearestWire
+      (geo::Point_t const& point, geo::PlaneID const& planeID) const
+      { return fPlanes[fShape.index(planeID)].nearestWire(point); }
+
+    /**
+     * @brief Computes the wire coordinate of each point on `planeID`.
+     * @param points the points to be projected
+     * @param planeID ID of the plane (must be present: not checked)
+     * @param coords (output) the coordinates; at least as long as `points`
+     */
+    void wireCoordinates(
+      Points_t points, geo::PlaneID const& planeID,
+      util::span<double*> coords
+      ) const;
+
+    /**
+     * @brief Computes the number of the wire closest to each point on
+     *        `planeID`.
+     * @param points the points to be projected
+     * @param planeID ID of the plane (must be present: not checked)
+     * @param wires (output) the wire numbers; at least as long as `points`
+     *
+     * Points outside the plane are assigned the closest of its border wires,
+     * as in `geo::GeometryCore::ClosestWireID()`.
+     */
+    void nearestWires(
+      Points_t points, geo::PlaneID const& planeID,
+      util::span<WireNo_t*> wires
+      ) const;
+
+
+      private:
+
+    /// Coefficients of the wire coordinate of a plane.
+    struct PlaneProjection_t {
+      double c0 = 0.0; ///< Wire coordinate of the origin.
+      double cx = 0.0; ///< Coefficient of the _x_ coordinate.
+      double cy = 0.0; ///< Coefficient of the _y_ coordinate.
+      double cz = 0.0; ///< Coefficient of the _z_ coordinate.
+      unsigned int nWires = 0U; ///< Number of wires (`0`: no plane).
+
+      double coordinate(geo::Point_t const& point) const
+        { return c0 + cx * point.X() + cy * point.Y() + cz * point.Z(); }
+
+      WireNo_t nearestWire(geo::Point_t const& point) const
+        {
+          double const w = std::floor(coordinate(point) + 0.5);
+          return static_cast<WireNo_t>
+            (std::min(std::max(w, 0.0), double(nWires - 1U)));
+        }
+    }; // PlaneProjection_t
+
+    geo::PlaneIndexShape fShape; ///< Indexing of the wire planes.
+
+    std::vector<PlaneProjection_t> fPlanes; ///< Coefficients of each plane.
+
+  }; // class WireCoordinateTable
+
+
+} // namespace geo
+
+
+//------------------------------------------------------------------------------
+//--- inline implementation
+//------------------------------------------------------------------------------
+inline geo::WireCoordinateTable::WireCoordinateTable
+  (geo::GeometryCore const& geom)
+  : fShape{ geom.Ncryostats(), geom.MaxTPCs(), geom.MaxPlanes() }
+  , fPlanes(fShape.size())
+{
+  for (std::size_t iPlane = 0; iPlane < fShape.size(); ++iPlane) {
+    geo::PlaneID const planeID = fShape.planeID(iPlane);
+    if (!geom.HasPlane(planeID)) continue;
+
+    geo::PlaneGeo const& plane = geom.Plane(planeID);
+    PlaneProjection_t& proj = fPlanes[iPlane];
+    proj.c0 = plane.WireCoordinate(geo::Point_t{ 0.0, 0.0, 0.0 });
+    proj.cx = plane.WireCoordinate(geo::Point_t{ 1.0, 0.0, 0.0 }) - proj.c0;
+    proj.cy = plane.WireCoordinate(geo::Point_t{ 0.0, 1.0, 0.0 }) - proj.c0;
+    proj.cz = plane.WireCoordinate(geo::Point_t{ 0.0, 0.0, 1.0 }) - proj.c0;
+    proj.nWires = plane.Nwires();
+  } // for planes
+
+} // geo::WireCoordinateTable::WireCoordinateTable()
+
+
+//------------------------------------------------------------------------------
+inline void geo::WireCoordinateTable::wireCoordinates(
+  Points_t points, geo::PlaneID const& planeID,
+  util::span<double*> coords
+) const {
+
+  // copies in local variables help the compiler vectorize the loop
+  PlaneProjection_t const proj = fPlanes[fShape.index(planeID)];
+  std::size_t const n = points.size();
+  geo::Point_t const* const pts = points.begin();
+  double* const out = coords.begin();
+  for (std::size_t i = 0; i < n; ++i) out[i] = proj.coordinate(pts[i]);
+
+} // geo::WireCoordinateTable::wireCoordinates()
+
+
+//------------------------------------------------------------------------------
+inline void geo::WireCoordinateTable::nearestWires(
+  Points_t points, geo::PlaneID const& planeID,
+  util::span<WireNo_t*> wires
+) const {
+
+  PlaneProjection_t const proj = fPlanes[fShape.index(planeID)];
+  std::size_t const n = points.size();
+  geo::Point_t const* const pts = points.begin();
+  WireNo_t* const out = wires.begin();
+  for (std::size_t i = 0; i < n; ++i) out[i] = proj.nearestWire(pts[i]);
+
+} // geo::WireCoordinateTable::nearestWires()
+
+
+//------------------------------------------------------------------------------
+
+
+#endif // LARCORE_GEOMETRY_WIRECOORDINATETABLE_H
@@ -0,0 +1,417 @@
+/**
+ * @file   larcore/Geometry/WireToChannelTable.h
+ * @brief  Dense table of the TPC channel of each wire in the detector.
+ * @see    larcore/Geometry/Geometry.h
+ *
+ * This library is header-only.
+ */
+
+#ifndef LARCORE_GEOMETRY_WIRETOCHANNELTABLE_H
+#define LARCORE_GEOMETRY_WIRETOCHANNELTABLE_H
+
+// LArSoft libraries
+#include "larcore/Geometry/LazyPlaneInitializer.h"
+#include "larcorealg/Geometry/GeometryCore.h"
+#include "larcoreobj/SimpleTypesAndConstants/geo_types.h" // geo::WireID
+#include "larcoreobj/SimpleTypesAndConstants/RawTypes.h" // raw::ChannelID_t
+
+// C/C++ standard libraries
+#include <vector>
+#include <limits> // std::numeric_limits<>
+#include <cstring> // std::memcpy()
+#include <cstdint> // std::uint32_t, std::uint64_t
+#include <cstddef> // std::size_t, std::byte
+
+
+namespace geo {
+
+  /**
+   * @brief Linear index of the wire planes in a detector.
+   *
+   * The index of a plane is computed arithmetically from its cryostat, TPC and
+   * plane numbers, based on the number of cryostats and on the maximum number
+   * of TPCs per cryostat and of planes per TPC.
+   * Planes that do not exist in the detector still have an index.
+   * The index computation is `constexpr`.
+   */
+  class PlaneIndexShape {
+
+      public:
+
+    /// Constructor: an empty shape with no planes.
+    constexpr PlaneIndexShape() = default;
+
+    /// Constructor: shape with the specified dimensions.
+    constexpr PlaneIndexShape
+      (unsigned int nCryostats, unsigned int maxTPCs, unsigned int maxPlanes)
+      : fNCryostats(nCryostats), fMaxTPCs(maxTPCs), fMaxPlanes(maxPlanes)
+      {}
+
+    /// Returns the number of cryostats.
+    constexpr unsigned int nCryostats() const { return fNCryostats; }
+
+    /// Returns the maximum number of TPCs in a cryostat.
+    constexpr unsigned int maxTPCs() const { return fMaxTPCs; }
+
+    /// Returns the maximum number of planes in a TPC.
+    constexpr unsigned int maxPlanes() const { return fMaxPlanes; }
+
+    /// Returns the number of plane indices (including nonexisting planes).
+    constexpr std::size_t size() const
+      { return std::size_t(fNCryostats) * fMaxTPCs * fMaxPlanes; }
+
+    /// Returns whether `planeID` fits into this shape.
+    constexpr bool contains(geo::PlaneID const& planeID) const
+      {
+        return planeID.isValid && (planeID.Cryostat < fNCryostats)
+          && (planeID.TPC < fMaxTPCs) && (planeID.Plane < fMaxPlanes);
+      }
+
+    /// Returns the linear index of `planeID` (no check performed).
+    constexpr std::size_t index(geo::PlaneID const& planeID) const
+      {
+        return (std::size_t(planeID.Cryostat) * fMaxTPCs + planeID.TPC)
+          * fMaxPlanes + planeID.Plane;
+      }
+
+    /// Returns the ID of the plane with the specified linear `index`.
+    geo::PlaneID planeID(std::size_t index) const
+      {
+        return {
+          static_cast<unsigned int>(index / fMaxPlanes / fMaxTPCs),
+          static_cast<unsigned int>((index / fMaxPlanes) % fMaxTPCs),
+          static_cast<unsigned int>(index % fMaxPlanes)
+          };
+      }
+
+      private:
+    unsigned int fNCryostats = 0U; ///< Number of cryostats.
+    unsigned int fMaxTPCs = 0U; ///< Maximum number of TPCs in a cryostat.
+    unsigned int fMaxPlanes = 0U; ///< Maximum number of planes in a TPC.
+
+  }; // class PlaneIndexShape
+
+
+  /**
+   * @brief Table of the TPC channel of each wire.
+   *
+   * The table contains one entry for each wire in the detector, stored in a
+   * single array. The position of the entry of a wire in that array (the
+   * "flat wire index") is the sum of the offset of the wire plane and of the
+   * wire number, where the index of the wire plane is given by
+   * `geo::PlaneIndexShape`.
+   *
+   * The table is filled from a fully initialized geometry (that is, after
+   * the channel mapping has been applied) and never changed afterwards.
+   * Queries do not allocate memory and do not throw; they can be safely
+   * performed from multiple threads at once.
+   *
+   * In _lazy_ mode, the channels of each plane are filled only when a wire
+   * of that plane is queried for the first time (thread-safely, see
+   * `geo::LazyPlaneInitializer`). In that mode, the geometry used to create
+   * the table must stay available for the whole lifetime of the table.
+   *
+   * A fully filled table can be serialized into a memory buffer
+   * (`serialize()`), and a table can be created as a view of serialized data
+   * (`view()`), without copying it.
+   */
+  class WireToChannelTable {
+
+      public:
+
+    /// Type of the entries in the table.
+    using Channel_t = std::uint32_t;
+
+    static_assert(sizeof(Channel_t) == sizeof(raw::ChannelID_t),
+      "Channel ID type does not match the table entry type");
+
+
+    /// Constructor: an empty table.
+    WireToChannelTable() = default;
+
+    /**
+     * @brief Constructor: fills the table from the specified `geom`.
+     * @param geom the geometry with the channel mapping to be tabulated
+     * @param lazy whether to fill the channels of each plane only on demand
+     */
+    explicit WireToChannelTable
+      (geo::GeometryCore const& geom, bool lazy = false);
+
+    // the views would point to the data of the original table
+    WireToChannelTable(WireToChannelTable const&) = delete;
+    WireToChannelTable(WireToChannelTable&&) = default;
+    WireToChannelTable& operator= (WireToChannelTable const&) = delete;
+    WireToChannelTable& operator= (WireToChannelTable&&) = default;
+
+
+    /// Returns the number of wires in the table.
+    std::size_t nWires() const { return fNChannels; }
+
+    /// Returns the number of wires in the specified plane (`0` if not present).
+    unsigned int nWires(geo::PlaneID const& planeID) const
+      {
+        if (!fShape.contains(planeID)) return 0U;
+        std::size_t const iPlane = fShape.index(planeID);
+        return fPlaneOffsetData[iPlane + 1] - fPlaneOffsetData[iPlane];
+      }
+
+    /// Returns the shape of the plane index.
+    constexpr geo::PlaneIndexShape const& shape() const { return fShape; }
+
+    /// Returns the number of planes in the table which have wires.
+    std::size_t nPlanes() const { return fNPlanes; }
+
+    /// Returns the number of planes whose channels have been filled.
+    std::size_t nMaterializedPlanes() const
+      { return fPlaneInit.nInitialized(); }
+
+    /// Fills the channels of all planes not filled yet.
+    void materializeAll() const;
+
+    /// Returns whether `wireID` is described in the table.
+    bool hasWire(geo::WireID const& wireID) const
+      { return wireID.isValid && (wireID.Wire < nWires(wireID)); }
+
+    /// Returns the flat index of `wireID` (no check performed).
+    std::size_t flatIndex(geo::WireID const& wireID) const
+      { return fPlaneOffsetData[fShape.index(wireID)] + wireID.Wire; }
+
+    /// Returns the channel of `wireID` (`raw::InvalidChannelID` if unknown).
+    raw::ChannelID_t channel(geo::WireID const& wireID) const
+      {
+        if (!hasWire(wireID)) return raw::InvalidChannelID;
+        materializePlane(fShape.index(wireID));
+        return fChannelData[flatIndex(wireID)];
+      }
+
+
+    // --- BEGIN -- Serialization ----------------------------------------------
+    /// Returns the size of the serialized table [bytes].
+    std::size_t serializedSize() const
+      {
+        return 6U * Word + fShape.size() * Word + Word
+          + fNChannels * sizeof(Channel_t);
+      }
+
+    /// Writes the table into `buffer`, which must have `serializedSize()`
+    /// bytes and be aligned to 8 bytes; all planes are filled first.
+    void serialize(std::byte* buffer) const;
+
+    /// Returns a table using the data serialized at `buffer` (not copied),
+    /// which must stay available for the whole lifetime of the table.
+    static WireToChannelTable view(std::byte const* buffer);
+
+    /**
+     * @brief Returns whether `buffer` holds a consistent serialized table.
+     * @param buffer the serialized data (aligned to 8 bytes)
+     * @param size the number of bytes available in `buffer`
+     * @return whether `view(buffer)` is safe to use
+     *
+     * The table must fit in `size` bytes (`serializedSize()`), its plane
+     * offsets must match its shape, be sorted and end at its wire count.
+     * Only the `size` bytes of `buffer` are ever read.
+     */
+    static bool validView(std::byte const* buffer, std::size_t size);
+
+    // --- END -- Serialization ------------------------------------------------
+
+
+      private:
+
+    geo::PlaneIndexShape fShape; ///< Indexing of the wire planes.
+
+    /// Flat index of the first wire of each plane, plus the total wire count.
+    std::vector<std::size_t> fPlaneOffsets;
+
+    /// Channel of each wire (filled lazily in lazy mode).
+    mutable std::vector<Channel_t> fChannels;
+
+    std::size_t fNPlanes = 0U; ///< Number of planes with wires.
+
+    /// Geometry for the lazy filling (`nullptr` if filled at construction).
+    geo::GeometryCore const* fGeom = nullptr;
+
+    geo::LazyPlaneInitializer fPlaneInit; ///< Tracks which planes are filled.
+
+    // the queries use these, pointing either to the vectors above or to
+    // external (serialized) data
+    std::size_t const* fPlaneOffsetData = nullptr; ///< Offset of each plane.
+    Channel_t const* fChannelData = nullptr; ///< Channel of each wire.
+    std::size_t fNChannels = 0U; ///< Number of wires.
+
+    /// Size of a serialized integral number.
+    static constexpr std::size_t Word = sizeof(std::uint64_t);
+
+    static_assert(sizeof(std::size_t) == Word,
+      "Serialization requires 64-bit offsets");
+
+
+    /// Fills the channels of the plane with index `iPlane` if not done yet.
+    void materializePlane(std::size_t iPlane) const
+      { fPlaneInit.ensure(iPlane, [this, iPlane](){ fillPlane(iPlane); }); }
+
+    /// Fills the channels of the plane with index `iPlane`.
+    void fillPlane(std::size_t iPlane) const;
+
+  }; // class WireToChannelTable
+
+
+} // namespace geo
+
+
+//------------------------------------------------------------------------------
+//--- inline implementation
+//------------------------------------------------------------------------------
+inline geo::WireToChannelTable::WireToChannelTable
+  (geo::GeometryCore const& geom, bool lazy /* = false */)
+  : fShape{ geom.Ncryostats(), geom.MaxTPCs(), geom.MaxPlanes() }
+  , fGeom(&geom)
+  , fPlaneInit(fShape.size())
+{
+  std::size_t const nPlanes = fShape.size();
+
+  fPlaneOffsets.reserve(nPlanes + 1U);
+  fPlaneOffsets.push_back(0U);
+  for (std::size_t iPlane = 0; iPlane < nPlanes; ++iPlane) {
+    geo::PlaneID const planeID = fShape.planeID(iPlane);
+    unsigned int const nPlaneWires
+      = geom.HasPlane(planeID)? geom.Nwires(planeID): 0U;
+    fPlaneOffsets.push_back(fPlaneOffsets.back() + nPlaneWires);
+    if (nPlaneWires > 0U) ++fNPlanes;
+  } // for planes
+
+  fChannels.resize(fPlaneOffsets.back(), raw::InvalidChannelID);
+
+  fPlaneOffsetData = fPlaneOffsets.data();
+  fChannelData = fChannels.data();
+  fNChannels = fChannels.size();
+
+  if (!lazy) {
+    materializeAll();
+    fGeom = nullptr; // not needed any more
+  }
+
+} // geo::WireToChannelTable::WireToChannelTable()
+
+
+//------------------------------------------------------------------------------
+inline void geo::WireToChannelTable::materializeAll() const {
+
+  std::size_t const nPlanes = fShape.size();
+  for (std::size_t iPlane = 0; iPlane < nPlanes; ++iPlane) {
+    if (fPlaneOffsetData[iPlane + 1] == fPlaneOffsetData[iPlane]) continue;
+    materializePlane(iPlane);
+  }
+
+} // geo::WireToChannelTable::materializeAll()
+
+
+//------------------------------------------------------------------------------
+inline void geo::WireToChannelTable::fillPlane(std::size_t iPlane) const {
+
+  geo::PlaneID const planeID = fShape.planeID(iPlane);
+  unsigned int const nPlaneWires
+    = fPlaneOffsets[iPlane + 1] - fPlaneOffsets[iPlane];
+  Channel_t* const channels = fChannels.data() + fPlaneOffsets[iPlane];
+  for (unsigned int wire = 0; wire < nPlaneWires; ++wire)
+    channels[wire] = fGeom->PlaneWireToChannel(geo::WireID{ planeID, wire });
+
+} // geo::WireToChannelTable::fillPlane()
+
+
+//------------------------------------------------------------------------------
+inline void geo::WireToChannelTable::serialize(std::byte* buffer) const {
+
+  materializeAll();
+
+  std::uint64_t const header[6] = {
+    fShape.nCryostats(), fShape.maxTPCs(), fShape.maxPlanes(),
+    fNPlanes, fShape.size() + 1U, fNChannels
+  };
+  std::memcpy(buffer, header, sizeof(header));
+  buffer += sizeof(header);
+  std::memcpy(buffer, fPlaneOffsetData, header[4] * Word);
+  buffer += header[4] * Word;
+  std::memcpy(buffer, fChannelData, fNChannels * sizeof(Channel_t));
+
+} // geo::WireToChannelTable::serialize()
+
+
+//------------------------------------------------------------------------------
+inline auto geo::WireToChannelTable::view(std::byte const* buffer)
+  -> WireToChannelTable
+{
+  std::uint64_t header[6];
+  std::memcpy(header, buffer, sizeof(header));
+  buffer += sizeof(header);
+
+  WireToChannelTable table;
+  table.fShape = geo::PlaneIndexShape{ static_cast<unsigned int>(header[0]),
+    static_cast<unsigned int>(header[1]), static_cast<unsigned int>(header[2])
+    };
+  table.fNPlanes = header[3];
+  table.fPlaneOffsetData = reinterpret_cast<std::size_t const*>(buffer);
+  buffer += header[4] * Word;
+  table.fChannelData = reinterpret_cast<Channel_t const*>(buffer);
+  table.fNChannels = header[5];
+
+  // all the data is already there: declare filled all the existing planes
+  // (and only those, as `materializeAll()` would)
+  table.fPlaneInit = geo::LazyPlaneInitializer{ table.fShape.size() };
+  for (std::size_t iPlane = 0; iPlane < table.fShape.size(); ++iPlane) {
+    if (table.fPlaneOffsetData[iPlane + 1] == table.fPlaneOffsetData[iPlane])
+      continue;
+    table.fPlaneInit.ensure(iPlane, [](){});
+  }
+
+  return table;
+
+} // geo::WireToChannelTable::view()
+
+
+//------------------------------------------------------------------------------
+inline bool geo::WireToChannelTable::validView
+  (std::byte const* buffer, std::size_t size)
+{
+  if (size < 6U * Word) return false;
+  std::uint64_t header[6];
+  std::memcpy(header, buffer, sizeof(header));
+
+  // checked one at a time, so that large values can't overflow the sum
+  std::size_t const available = size - 6U * Word;
+  if ((header[4] == 0U) || (header[4] > available / Word)) return false;
+  if (header[5] > (available - header[4] * Word) / sizeof(Channel_t))
+    return false;
+
+  // the shape must have exactly one index per plane offset (but the last)
+  std::uint64_t const nIndices = header[4] - 1U;
+  std::uint64_t shapeSize = 1U;
+  for (std::size_t i = 0U; i < 3U; ++i) {
+    if (header[i] > std::numeric_limits<unsigned int>::max()) return false;
+  }
+  for (std::size_t i = 0U; i < 3U; ++i) {
+    if (header[i] == 0U) { shapeSize = 0U; break; }
+    if (shapeSize > nIndices / header[i]) return false;
+    shapeSize *= header[i];
+  }
+  if (shapeSize != nIndices) return false;
+
+  auto const* const offsets
+    = reinterpret_cast<std::size_t const*>(buffer + sizeof(header));
+  if (offsets[0] != 0U) return false;
+  std::size_t nPlanes = 0U;
+  for (std::size_t i = 1U; i < header[4]; ++i) {
+    if (offsets[i] < offsets[i - 1]) return false;
+    if (offsets[i] > offsets[i - 1]) ++nPlanes;
+  }
+  if ((offsets[nIndices] != header[5]) || (nPlanes != header[3])) return false;
+
+  return view(buffer).serializedSize() <= size;
+
+} // geo::WireToChannelTable::validView()
+
+
+//------------------------------------------------------------------------------
+
+
+#endif // LARCORE_GEOMETRY_WIRETOCHANNELTABLE_H
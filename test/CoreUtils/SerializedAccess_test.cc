@@ -0,0 +1,129 @@
+/**
+ * @file   SerializedAccess_test.cc
+ * @brief  Tests the serialized access adapter in SerializedAccess.h
+ * @see    larcore/CoreUtils/SerializedAccess.h
+ *
+ * This test takes no command line argument.
+ *
+ */
+
+#define BOOST_TEST_MODULE ( SerializedAccess_test )
+
+// LArSoft libraries
+#include "larcore/CoreUtils/SerializedAccess.h"
+
+// Boost libraries
+#include <cetlib/quiet_unit_test.hpp> // BOOST_AUTO_TEST_CASE()
+#include <boost/test/test_tools.hpp> // BOOST_CHECK(), BOOST_CHECK_EQUAL()
+
+// C/C++ standard libraries
+#include <sstream>
+#include <vector>
+#include <thread>
+#include <chrono>
+
+
+//------------------------------------------------------------------------------
+/// A "legacy" object with a non-atomic current state.
+struct Legacy {
+  int current = -1; ///< Value being processed.
+  unsigned int nProcessed = 0U; ///< Number of processed values.
+  unsigned int nCorrupted = 0U; ///< Times the state was changed by others.
+
+  explicit Legacy(unsigned int nProcessed = 0U): nProcessed(nProcessed) {}
+
+  void process(int value)
+    {
+      current = value;
+      std::this_thread::yield();
+      if (current != value) ++nCorrupted;
+      ++nProcessed;
+    }
+}; // Legacy
+
+
+//------------------------------------------------------------------------------
+void SerializedAccessSingleThreadTest() {
+
+  lar::SerializedAccess<Legacy> legacy { 5U };
+
+  BOOST_CHECK_EQUAL(legacy.statistics().nAccesses, 0U);
+
+  {
+    auto access = legacy.access();
+    BOOST_CHECK_EQUAL(access->nProcessed, 5U);
+    access->process(1);
+    (*access).process(2);
+  }
+  unsigned int const n
+    = legacy.apply([](Legacy& obj){ obj.process(3); return obj.nProcessed; });
+  BOOST_CHECK_EQUAL(n, 8U);
+
+  auto const stats = legacy.statistics();
+  BOOST_CHECK_EQUAL(stats.nAccesses, 2U);
+  BOOST_CHECK_EQUAL(stats.nContended, 0U);
+  BOOST_CHECK(stats.maxWait <= stats.totalWait);
+  BOOST_CHECK(stats.maxHold <= stats.totalHold);
+  BOOST_CHECK(stats.averageHold() <= stats.maxHold);
+
+  std::ostringstream sstr;
+  stats.dump(sstr);
+  BOOST_CHECK(sstr.str().find("2 accesses (0 had to wait)") == 0U);
+
+} // SerializedAccessSingleThreadTest()
+
+
+//------------------------------------------------------------------------------
+void SerializedAccessMultithreadTest() {
+
+  constexpr unsigned int NThreads = 8U;
+  constexpr unsigned int NValues = 2000U;
+
+  lar::SerializedAccess<Legacy> legacy;
+
+  auto worker = [&legacy](){
+    for (unsigned int i = 0; i < NValues; ++i) {
+      if (i % 100 == 0) { // hold the object for a while, now and then
+        auto access = legacy.access();
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+        access->process(i);
+      }
+      else legacy.apply([i](Legacy& obj){ obj.process(i); });
+    } // for
+  }; // worker
+
+  std::vector<std::thread> threads;
+  for (unsigned int i = 0; i < NThreads; ++i) threads.emplace_back(worker);
+  for (std::thread& thread: threads) thread.join();
+
+  unsigned int const nExpected = NThreads * NValues;
+  legacy.apply([nExpected](Legacy const& obj){
+      BOOST_CHECK_EQUAL(obj.nProcessed, nExpected);
+      BOOST_CHECK_EQUAL(obj.nCorrupted, 0U);
+    });
+
+  auto const stats = legacy.statistics();
+  BOOST_CHECK_EQUAL(stats.nAccesses, nExpected + 1U);
+  BOOST_CHECK(stats.nContended <= stats.nAccesses);
+  BOOST_CHECK(stats.maxHold >= std::chrono::microseconds(100));
+  BOOST_CHECK(stats.maxWait <= stats.totalWait);
+
+} // SerializedAccessMultithreadTest()
+
+
+//------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(SerializedAccessTestCase) {
+
+  SerializedAccessSingleThreadTest();
+
+} // BOOST_AUTO_TEST_CASE(SerializedAccessTestCase)
+
+
+BOOST_AUTO_TEST_CASE(SerializedAccessMultithreadTestCase) {
+
+  SerializedAccessMultithreadTest();
+
+} // BOOST_AUTO_TEST_CASE(SerializedAccessMultithreadTestCase)
+
+
+//------------------------------------------------------------------------------
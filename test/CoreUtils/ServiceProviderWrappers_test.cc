@@ -0,0 +1,174 @@
+/**
+ * @file   ServiceProviderWrappers_test.cc
+ * @brief  Tests the provider storage of the wrappers in
+ *         ServiceProviderWrappers.h
+ * @see    ServiceProviderWrappers.h
+ *
+ * This test takes no command line argument.
+ *
+ */
+
+#define BOOST_TEST_MODULE ( ServiceProviderWrappers_test )
+
+// LArSoft libraries
+#include "larcore/CoreUtils/ServiceProviderWrappers.h"
+#include "larcorealg/CoreUtils/UncopiableAndUnmovableClass.h"
+
+// art libraries
+#include "art/Framework/Services/Registry/ActivityRegistry.h"
+#include "art/Utilities/Globals.h"
+#include "art/Utilities/ScheduleID.h"
+#include "canvas/Utilities/Exception.h"
+
+// Boost libraries
+#include <cetlib/quiet_unit_test.hpp> // BOOST_AUTO_TEST_CASE()
+#include <boost/test/test_tools.hpp> // BOOST_CHECK(), BOOST_CHECK_EQUAL()
+
+// C/C++ standard libraries
+#include <thread>
+#include <array>
+#include <vector>
+#include <type_traits> // std::true_type
+
+
+//------------------------------------------------------------------------------
+//
+// two providers, one of them with an instance per schedule
+//
+struct SharedProvider: protected lar::UncopiableAndUnmovableClass {
+   struct Config { int value = 3; };
+   int value;
+   SharedProvider(Config const& config): value(config.value) {}
+}; // SharedProvider
+
+struct ScheduleProvider: protected lar::UncopiableAndUnmovableClass {
+   struct Config { int value = 5; };
+   int value;
+   ScheduleProvider(Config const& config): value(config.value) {}
+}; // ScheduleProvider
+
+template <>
+struct lar::ProviderPerSchedule<ScheduleProvider>: std::true_type {};
+
+
+template <typename Provider>
+using Storage_t = lar::details::ProviderStorage
+  <Provider, lar::providerPerSchedule_v<Provider>>;
+
+using Tracker_t = lar::details::ScheduleTracker;
+
+
+/// Returns whether `get()` throws the exception for unknown schedules.
+template <typename Storage>
+bool throwsUnknownSchedule(Storage const& storage) {
+   try {
+      storage.get();
+   }
+   catch (art::Exception const& e) {
+      return e.categoryCode() == art::errors::LogicError;
+   }
+   return false;
+} // throwsUnknownSchedule()
+
+
+//------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(SharedProviderTest) {
+
+   art::Globals::instance()->setNSchedules(3);
+   art::ActivityRegistry reg;
+   Storage_t<SharedProvider> const storage({}, reg);
+
+   SharedProvider const* prov = storage.get();
+   BOOST_TEST_REQUIRE(prov);
+   BOOST_CHECK_EQUAL(prov->value, 3);
+   for (std::size_t s = 0; s < 3; ++s)
+      BOOST_CHECK_EQUAL(storage.get(art::ScheduleID(s)), prov);
+
+   // no schedule is needed, from any thread
+   SharedProvider const* threadProv = nullptr;
+   std::thread([&storage, &threadProv](){ threadProv = storage.get(); })
+      .join();
+   BOOST_CHECK_EQUAL(threadProv, prov);
+
+} // BOOST_AUTO_TEST_CASE(SharedProviderTest)
+
+
+//------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(ScheduleProviderTest) {
+
+   art::Globals::instance()->setNSchedules(3);
+   art::ActivityRegistry reg;
+   Storage_t<ScheduleProvider> const storage({}, reg);
+
+   std::array<ScheduleProvider const*, 3U> provs;
+   for (std::size_t s = 0; s < provs.size(); ++s) {
+      provs[s] = storage.get(art::ScheduleID(s));
+      BOOST_TEST_REQUIRE(provs[s]);
+      BOOST_CHECK_EQUAL(provs[s]->value, 5);
+      for (std::size_t t = 0; t < s; ++t) BOOST_CHECK_NE(provs[s], provs[t]);
+      BOOST_CHECK_EQUAL(storage.get(art::ScheduleID(s)), provs[s]);
+   } // for
+
+   // outside of a module the schedule is unknown
+   BOOST_CHECK(throwsUnknownSchedule(storage));
+
+   Tracker_t::enter(art::ScheduleID(1));
+   BOOST_CHECK_EQUAL(storage.get(), provs[1]);
+
+   // a thread not running the module does not know its schedule either
+   bool threadThrows = false;
+   std::thread([&storage, &threadThrows]()
+      { threadThrows = throwsUnknownSchedule(storage); }
+      ).join();
+   BOOST_CHECK(threadThrows);
+
+   // while waiting, this thread runs a module of another schedule
+   Tracker_t::enter(art::ScheduleID(2));
+   BOOST_CHECK_EQUAL(storage.get(), provs[2]);
+   Tracker_t::leave();
+
+   // ... and then it's back to the first module
+   BOOST_CHECK_EQUAL(storage.get(), provs[1]);
+   Tracker_t::leave();
+
+   BOOST_CHECK(throwsUnknownSchedule(storage));
+
+   // concurrent requests on different schedules
+   Storage_t<ScheduleProvider> const newStorage({}, reg);
+   std::array<ScheduleProvider const*, 3U> threadProvs;
+   std::vector<std::thread> threads;
+   for (std::size_t s = 0; s < threadProvs.size(); ++s) {
+      threads.emplace_back([&newStorage, &threadProvs, s](){
+         Tracker_t::enter(art::ScheduleID(s));
+         threadProvs[s] = newStorage.get();
+         Tracker_t::leave();
+      });
+   } // for
+   for (std::thread& thread: threads) thread.join();
+   for (std::size_t s = 0; s < threadProvs.size(); ++s)
+      BOOST_CHECK_EQUAL(threadProvs[s], newStorage.get(art::ScheduleID(s)));
+
+} // BOOST_AUTO_TEST_CASE(ScheduleProviderTest)
+
+
+//------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(SingleScheduleProviderTest) {
+
+   // with a single schedule, there is no ambiguity
+   art::Globals::instance()->setNSchedules(1);
+   art::ActivityRegistry reg;
+   Storage_t<ScheduleProvider> const storage({}, reg);
+
+   ScheduleProvider const* prov = storage.get();
+   BOOST_TEST_REQUIRE(prov);
+   BOOST_CHECK_EQUAL(storage.get(art::ScheduleID(0)), prov);
+
+   ScheduleProvider const* threadProv = nullptr;
+   std::thread([&storage, &threadProv](){ threadProv = storage.get(); })
+      .join();
+   BOOST_CHECK_EQUAL(threadProv, prov);
+
+} // BOOST_AUTO_TEST_CASE(SingleScheduleProviderTest)
+
+
+//------------------------------------------------------------------------------
@@ -30,6 +30,9 @@
 #include <cetlib/quiet_unit_test.hpp> // BOOST_AUTO_TEST_CASE()
 #include <boost/test/test_tools.hpp> // BOOST_CHECK(), BOOST_CHECK_EQUAL()
 
+// C/C++ standard libraries
+#include <chrono>
+
 //------------------------------------------------------------------------------
 //
 // here are some services: three of them, all different classes.
@@ -218,4 +221,106 @@ BOOST_AUTO_TEST_CASE(providersFromTest) {
 
 
 
+BOOST_AUTO_TEST_CASE(cachedProviderFromTest) {
+
+   // previous tests may have left their providers in the cache
+   lar::invalidateCachedProviders();
+
+   // null providers are not cached
+   GlobalServices.myServicePtr = std::make_unique<MyService>();
+   BOOST_CHECK_EXCEPTION(lar::cachedProviderFrom<MyService>(), art::Exception,
+     [](art::Exception const& e)
+       { return e.categoryCode() == art::errors::NotFound; }
+     );
+
+   MyProvider prov;
+   GlobalServices.myServicePtr = std::make_unique<MyService>(&prov);
+   BOOST_CHECK_EQUAL(lar::cachedProviderFrom<MyService>(), &prov);
+
+   // the service replacing its provider must invalidate the cache
+   MyProvider newProv;
+   GlobalServices.myServicePtr = std::make_unique<MyService>(&newProv);
+   unsigned int const generation = lar::cachedProvidersGeneration();
+   lar::invalidateCachedProviders();
+   BOOST_CHECK_NE(lar::cachedProvidersGeneration(), generation);
+   BOOST_CHECK_EQUAL(lar::cachedProviderFrom<MyService>(), &newProv);
+   BOOST_CHECK_EQUAL(lar::providerFrom<MyService>(), &newProv);
+
+   // provider packs from the cache
+   MyOtherProvider oprov;
+   YetAnotherProvider yaprov;
+   GlobalServices.myOtherServicePtr = std::make_unique<MyOtherService>(&oprov);
+   GlobalServices.yetAnotherServicePtr
+     = std::make_unique<YetAnotherService>(&yaprov);
+   lar::invalidateCachedProviders();
+   BOOST_CHECK(
+     (lar::cachedProvidersFrom<MyService, MyOtherService, YetAnotherService>())
+     == lar::makeProviderPack(&newProv, &oprov, &yaprov)
+     );
+
+   // providersFrom() does not use the cache at all
+   GlobalServices.myServicePtr = std::make_unique<MyService>(&prov);
+   BOOST_CHECK(
+     (lar::providersFrom<MyService, MyOtherService, YetAnotherService>())
+     == lar::makeProviderPack(&prov, &oprov, &yaprov)
+     );
+   lar::invalidateCachedProviders();
+   BOOST_CHECK(
+     (lar::cachedProvidersFrom<MyService, MyOtherService, YetAnotherService>())
+     == lar::makeProviderPack(&prov, &oprov, &yaprov)
+     );
+
+   // that's enough; let's clean up
+   GlobalServices.myServicePtr.reset();
+   GlobalServices.myOtherServicePtr.reset();
+   GlobalServices.yetAnotherServicePtr.reset();
+   lar::invalidateCachedProviders();
+
+} // BOOST_AUTO_TEST_CASE(cachedProviderFromTest)
+
+
+BOOST_AUTO_TEST_CASE(cachedProviderFromTimingTest) {
+
+   /*
+    * This compares the time spent in many calls of `lar::providerFrom()` and
+    * `lar::cachedProviderFrom()`; only the results are checked, the times are
+    * reported (`--log_level=message`) for information.
+    * With the fake service registry of this test the lookup is cheap, so the
+    * difference is smaller than with art.
+    */
+   constexpr unsigned int NCalls = 1'000'000U;
+
+   MyProvider prov;
+   GlobalServices.myServicePtr = std::make_unique<MyService>(&prov);
+   lar::invalidateCachedProviders();
+
+   using Clock_t = std::chrono::steady_clock;
+   using Duration_t = std::chrono::duration<double, std::micro>;
+
+   unsigned int nMatches = 0U;
+   auto const startPlain = Clock_t::now();
+   for (unsigned int i = 0; i < NCalls; ++i)
+     if (lar::providerFrom<MyService>() == &prov) ++nMatches;
+   Duration_t const plainTime = Clock_t::now() - startPlain;
+   BOOST_CHECK_EQUAL(nMatches, NCalls);
+
+   nMatches = 0U;
+   auto const startCached = Clock_t::now();
+   for (unsigned int i = 0; i < NCalls; ++i)
+     if (lar::cachedProviderFrom<MyService>() == &prov) ++nMatches;
+   Duration_t const cachedTime = Clock_t::now() - startCached;
+   BOOST_CHECK_EQUAL(nMatches, NCalls);
+
+   BOOST_TEST_MESSAGE(NCalls << " calls: providerFrom() "
+     << plainTime.count() << " us, cachedProviderFrom() "
+     << cachedTime.count() << " us");
+
+   GlobalServices.myServicePtr.reset();
+   lar::invalidateCachedProviders();
+
+} // BOOST_AUTO_TEST_CASE(cachedProviderFromTimingTest)
+
+
+
+
 //------------------------------------------------------------------------------
@@ -0,0 +1,181 @@
+/**
+ * @file   SnapshotHolder_test.cc
+ * @brief  Tests the snapshot publication in SnapshotHolder.h
+ * @see    larcore/CoreUtils/SnapshotHolder.h
+ *
+ * This test takes no command line argument.
+ * The multithreading test mimics many threads accessing a service provider
+ * (like `geo::AuxDetGeometry::GetProvider()`) while it is being reloaded.
+ *
+ */
+
+#define BOOST_TEST_MODULE ( SnapshotHolder_test )
+
+// LArSoft libraries
+#include "larcore/CoreUtils/SnapshotHolder.h"
+
+// Boost libraries
+#include <cetlib/quiet_unit_test.hpp> // BOOST_AUTO_TEST_CASE()
+#include <boost/test/test_tools.hpp> // BOOST_CHECK(), BOOST_CHECK_EQUAL()
+
+// C/C++ standard libraries
+#include <memory> // std::make_shared()
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <numeric> // std::accumulate()
+
+
+//------------------------------------------------------------------------------
+/// Data in a snapshot.
+struct Data {
+  std::vector<int> values;
+  explicit Data(int n, int value): values(n, value) {}
+}; // Data
+
+
+//------------------------------------------------------------------------------
+void SnapshotHolderEmptyTest() {
+
+  lar::SnapshotHolder<Data> holder;
+
+  BOOST_CHECK(!holder.hasSnapshot());
+  BOOST_CHECK(holder.current() == nullptr);
+  BOOST_CHECK(!holder.snapshot());
+  BOOST_CHECK_EQUAL(holder.generation(), 0U);
+  BOOST_CHECK_EQUAL(holder.nRetired(), 0U);
+  BOOST_CHECK_EQUAL(holder.releaseRetired(), 0U);
+
+} // SnapshotHolderEmptyTest()
+
+
+//------------------------------------------------------------------------------
+void SnapshotHolderPublishTest() {
+
+  lar::SnapshotHolder<Data> holder { std::make_shared<Data>(3, 1) };
+
+  BOOST_CHECK(holder.hasSnapshot());
+  BOOST_CHECK_EQUAL(holder.generation(), 1U);
+  Data const* const first = holder.current();
+  BOOST_CHECK(first->values == std::vector<int>({ 1, 1, 1 }));
+
+  // a reader keeps the first snapshot
+  std::shared_ptr<Data const> const kept = holder.snapshot();
+  BOOST_CHECK(kept.get() == first);
+
+  auto const previous = holder.publish(std::make_shared<Data>(2, 5));
+  BOOST_CHECK(previous.get() == first);
+  BOOST_CHECK_EQUAL(holder.generation(), 2U);
+  BOOST_CHECK(holder.current() != first);
+  BOOST_CHECK(holder.current()->values == std::vector<int>({ 5, 5 }));
+  BOOST_CHECK(holder.snapshot().get() == holder.current());
+
+  // the retired snapshot is still alive (also for `current()` users)
+  BOOST_CHECK_EQUAL(holder.nRetired(), 1U);
+  BOOST_CHECK_EQUAL(first->values.size(), 3U);
+
+  BOOST_CHECK_EQUAL(holder.releaseRetired(), 1U);
+  BOOST_CHECK_EQUAL(holder.nRetired(), 0U);
+  BOOST_CHECK_EQUAL(holder.current()->values.size(), 2U);
+
+  // the reader still owns the first snapshot
+  BOOST_CHECK_EQUAL(kept.use_count(), 2); // `kept` and `previous`
+  BOOST_CHECK(kept->values == std::vector<int>({ 1, 1, 1 }));
+
+} // SnapshotHolderPublishTest()
+
+
+//------------------------------------------------------------------------------
+/// A "provider" whose content is consistent only if completely initialized.
+struct Provider {
+  int ID; ///< Identifier of the provider.
+  std::vector<int> values; ///< All equal to `ID`.
+  long long int sum; ///< Sum of all `values`.
+
+  explicit Provider(int ID): ID(ID), values(1000, ID), sum(1000LL * ID) {}
+
+  /// Returns whether the content of the provider is consistent.
+  bool isConsistent() const
+    {
+      return (values.size() == 1000U)
+        && (std::accumulate(values.begin(), values.end(), 0LL) == sum);
+    }
+}; // Provider
+
+
+void SnapshotHolderMultithreadTest() {
+
+  constexpr unsigned int NReaders = 8U;
+  constexpr int NReloads = 200;
+
+  lar::SnapshotHolder<Provider> holder { std::make_shared<Provider>(0) };
+
+  std::atomic<bool> done { false };
+  std::atomic<unsigned int> nInconsistent { 0U };
+  std::atomic<unsigned int> nBackwards { 0U };
+  std::atomic<unsigned long long int> nReads { 0U };
+
+  auto reader = [&](bool keepSnapshot){
+    int lastID = 0;
+    unsigned long long int n = 0U;
+    do { // at least one read, even if all the reloads are already over
+      int ID = 0;
+      if (keepSnapshot) {
+        std::shared_ptr<Provider const> const provider = holder.snapshot();
+        if (!provider->isConsistent()) ++nInconsistent;
+        ID = provider->ID;
+      }
+      else {
+        Provider const& provider = *(holder.current());
+        if (!provider.isConsistent()) ++nInconsistent;
+        ID = provider.ID;
+      }
+      if (ID < lastID) ++nBackwards; // providers are published in ID order
+      lastID = ID;
+      ++n;
+    } while (!done.load());
+    nReads += n;
+  }; // reader
+
+  std::vector<std::thread> readers;
+  for (unsigned int i = 0; i < NReaders; ++i)
+    readers.emplace_back(reader, (i % 2) == 0);
+
+  // the "reloads": no retired provider is released while readers run
+  for (int ID = 1; ID <= NReloads; ++ID)
+    holder.publish(std::make_shared<Provider>(ID));
+
+  done = true;
+  for (std::thread& thread: readers) thread.join();
+
+  BOOST_CHECK_EQUAL(nInconsistent.load(), 0U);
+  BOOST_CHECK_EQUAL(nBackwards.load(), 0U);
+  BOOST_CHECK_GT(nReads.load(), 0U);
+  BOOST_CHECK_EQUAL(holder.generation(), (unsigned int)(NReloads + 1));
+  BOOST_CHECK_EQUAL(holder.current()->ID, NReloads);
+  BOOST_CHECK_EQUAL(holder.nRetired(), (std::size_t) NReloads);
+
+  // with no reader left, retired providers can be released
+  BOOST_CHECK_EQUAL(holder.releaseRetired(), (std::size_t) NReloads);
+  BOOST_CHECK(holder.current()->isConsistent());
+
+} // SnapshotHolderMultithreadTest()
+
+
+//------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(SnapshotHolderTestCase) {
+
+  SnapshotHolderEmptyTest();
+  SnapshotHolderPublishTest();
+
+} // BOOST_AUTO_TEST_CASE(SnapshotHolderTestCase)
+
+
+BOOST_AUTO_TEST_CASE(SnapshotHolderMultithreadTestCase) {
+
+  SnapshotHolderMultithreadTest();
+
+} // BOOST_AUTO_TEST_CASE(SnapshotHolderMultithreadTestCase)
+
+
+//------------------------------------------------------------------------------
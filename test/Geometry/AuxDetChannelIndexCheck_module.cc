@@ -0,0 +1,498 @@
+/**
+ * @file   AuxDetChannelIndexCheck_module.cc
+ * @brief  Compares the queries of `AuxDetChannelIndex` with the geometry
+ * @see    larcore/Geometry/AuxDetChannelIndex.h
+ */
+
+// LArSoft includes
+#include "larcore/Geometry/AuxDetGeometry.h"
+#include "larcore/Geometry/AuxDetChannelIndex.h"
+#include "larcorealg/Geometry/AuxDetGeometryCore.h"
+#include "larcorealg/Geometry/AuxDetGeo.h"
+#include "larcorealg/Geometry/AuxDetSensitiveGeo.h"
+#include "larcorealg/CoreUtils/span.h"
+#include "larcoreobj/SimpleTypesAndConstants/geo_vectors.h" // geo::Point_t
+
+// Framework includes
+#include "art/Framework/Core/ModuleMacros.h"
+#include "art/Framework/Core/EDAnalyzer.h"
+#include "art/Framework/Services/Registry/ServiceHandle.h"
+#include "messagefacility/MessageLogger/MessageLogger.h"
+#include "canvas/Utilities/Exception.h"
+#include "fhiclcpp/types/Atom.h"
+#include "cetlib_except/exception.h"
+
+// ROOT libraries
+#include "TVector3.h"
+
+// C/C++ standard library
+#include <vector>
+#include <string>
+#include <algorithm> // std::max()
+#include <chrono>
+#include <cmath> // std::abs()
+#include <cstddef> // std::size_t
+
+
+namespace art { class Event; class Run; }
+
+namespace geo {
+
+  /**
+   * @brief Checks the queries of `AuxDetChannelIndex` against the geometry.
+   *
+   * Each query of the index published by `geo::AuxDetGeometry` (see
+   * `geo::AuxDetGeometry::ChannelIndex()`) is compared with the equivalent
+   * query of the `geo::AuxDetGeometryCore` provider:
+   *
+   * * `auxDetIndex()` with the name of each auxiliary detector;
+   * * `channelToSensitive()`, `channelsToSensitive()`, `channelPosition()`
+   *   and `channelPositions()` with `ChannelToAuxDetSensitive()` and
+   *   `AuxDetChannelToPosition()`, for the channels of each auxiliary
+   *   detector from `0` to `ChannelsPerSensitive` times the number of its
+   *   sensitive volumes;
+   * * `auxDetAt()`, `auxDetsAt()`, `sensitiveAt()` and `sensitivesAt()` with
+   *   `FindAuxDetAtPosition()` and `FindAuxDetSensitiveAtPosition()`, on a
+   *   grid of points around each auxiliary detector and on the center of
+   *   each sensitive volume.
+   *
+   * The time spent by the two sides of each comparison is also reported.
+   * An exception is thrown on mismatch.
+   *
+   * Configuration parameters
+   * =========================
+   *
+   * - *Tolerance* (real, default: `0`): tolerance of the position queries
+   *   [cm]; it must match the `IndexTolerance` of the `AuxDetGeometry`
+   *   service
+   * - *ChannelsPerSensitive* (integer, default: `4`): the channels checked
+   *   are this many times the sensitive volumes of each auxiliary detector
+   * - *PointsPerSide* (integer, default: `10`): the grids of test points have
+   *   this many points on each side
+   * - *OutputCategory* (string, default: `AuxDetChannelIndexCheck`): category
+   *   of the messages
+   */
+  class AuxDetChannelIndexCheck: public art::EDAnalyzer {
+      public:
+
+    struct Config {
+      using Name = fhicl::Name;
+      using Comment = fhicl::Comment;
+
+      fhicl::Atom<double> Tolerance {
+        Name("Tolerance"),
+        Comment("tolerance of the position queries [cm]"),
+        0.0
+        };
+
+      fhicl::Atom<unsigned int> ChannelsPerSensitive {
+        Name("ChannelsPerSensitive"),
+        Comment("channels checked per sensitive volume of each detector"),
+        4U
+        };
+
+      fhicl::Atom<unsigned int> PointsPerSide {
+        Name("PointsPerSide"),
+        Comment("number of test points on each side of the grids"),
+        10U
+        };
+
+      fhicl::Atom<std::string> OutputCategory {
+        Name("OutputCategory"),
+        Comment("message facility category for the output"),
+        "AuxDetChannelIndexCheck"
+        };
+
+    }; // Config
+
+    using Parameters = art::EDAnalyzer::Table<Config>;
+
+    explicit AuxDetChannelIndexCheck(Parameters const& config);
+
+    virtual void analyze(art::Event const&) override {}
+    virtual void beginRun(art::Run const&) override;
+
+      private:
+
+    using Clock_t = std::chrono::steady_clock;
+    using SensitiveID_t = geo::AuxDetChannelIndex::SensitiveID_t;
+
+    double fTolerance; ///< Tolerance of the position queries [cm].
+    unsigned int fChannelsPerSensitive; ///< Channels checked per volume.
+    unsigned int fPointsPerSide; ///< Points on each side of the grids.
+    std::string fOutputCategory; ///< Category of the messages.
+
+    /// Returns the number of mismatches in the name queries.
+    unsigned int checkNames(
+      geo::AuxDetChannelIndex const& index,
+      geo::AuxDetGeometryCore const& geom
+      ) const;
+
+    /// Returns the number of mismatches in the channel queries.
+    unsigned int checkChannels(
+      geo::AuxDetChannelIndex const& index,
+      geo::AuxDetGeometryCore const& geom
+      ) const;
+
+    /// Returns the number of mismatches in the position queries.
+    unsigned int checkPositions(
+      geo::AuxDetChannelIndex const& index,
+      geo::AuxDetGeometryCore const& geom
+      ) const;
+
+    /// Returns the sensitive volume of `channel` from the geometry.
+    SensitiveID_t expectedSensitive(geo::AuxDetGeometryCore const& geom,
+      std::size_t ad, geo::AuxDetChannelIndex::Channel_t channel) const;
+
+    /// Returns the sensitive volume containing `point` from the geometry.
+    SensitiveID_t expectedSensitiveAt
+      (geo::AuxDetGeometryCore const& geom, geo::Point_t const& point) const;
+
+    /// Returns a grid of points covering `auxDet` in any orientation.
+    std::vector<geo::Point_t> gridAround(geo::AuxDetGeo const& auxDet) const;
+
+    /// Reports the time of the index and of the provider queries of `what`.
+    void reportTimes(std::string const& what, std::size_t n,
+      Clock_t::duration index, Clock_t::duration core) const;
+
+  }; // class AuxDetChannelIndexCheck
+
+} // namespace geo
+
+
+//******************************************************************************
+namespace {
+
+  /// Returns whether two sensitive volume identifiers are the same.
+  bool sameSensitive(
+    geo::AuxDetChannelIndex::SensitiveID_t const& a,
+    geo::AuxDetChannelIndex::SensitiveID_t const& b
+  ) {
+    return (a.auxDet == b.auxDet) && (a.sensitive == b.sensitive);
+  } // sameSensitive()
+
+} // local namespace
+
+
+namespace geo {
+
+  //......................................................................
+  AuxDetChannelIndexCheck::AuxDetChannelIndexCheck(Parameters const& config)
+    : EDAnalyzer(config)
+    , fTolerance(config().Tolerance())
+    , fChannelsPerSensitive(config().ChannelsPerSensitive())
+    , fPointsPerSide(config().PointsPerSide())
+    , fOutputCategory(config().OutputCategory())
+  {
+    if (fPointsPerSide < 2U) {
+      throw art::Exception(art::errors::Configuration)
+        << "PointsPerSide must be at least 2 (" << fPointsPerSide
+        << " specified).\n";
+    }
+  } // AuxDetChannelIndexCheck::AuxDetChannelIndexCheck()
+
+
+  //......................................................................
+  void AuxDetChannelIndexCheck::beginRun(art::Run const&) {
+
+    geo::AuxDetGeometry const& service
+      = *(art::ServiceHandle<geo::AuxDetGeometry const>());
+    geo::AuxDetGeometryCore const& geom = service.GetProvider();
+    geo::AuxDetChannelIndex const& index = service.ChannelIndex();
+
+    if (geom.NAuxDets() == 0U) {
+      throw cet::exception("AuxDetChannelIndexCheck")
+        << "The geometry has no auxiliary detector to check.\n";
+    }
+
+    unsigned int const nErrors = checkNames(index, geom)
+      + checkChannels(index, geom) + checkPositions(index, geom);
+
+    if (nErrors > 0U) {
+      throw cet::exception("AuxDetChannelIndexCheck")
+        << nErrors << " mismatches between the auxiliary detector index and"
+        " the geometry provider.\n";
+    }
+    mf::LogInfo(fOutputCategory)
+      << "All auxiliary detector index queries match the geometry provider.";
+
+  } // AuxDetChannelIndexCheck::beginRun()
+
+
+  //......................................................................
+  unsigned int AuxDetChannelIndexCheck::checkNames(
+    geo::AuxDetChannelIndex const& index,
+    geo::AuxDetGeometryCore const& geom
+  ) const {
+    unsigned int nErrors = 0U;
+    if (index.nAuxDets() != geom.NAuxDets()) {
+      mf::LogError(fOutputCategory) << "The geometry has " << geom.NAuxDets()
+        << " auxiliary detectors, the index " << index.nAuxDets();
+      ++nErrors;
+    }
+    for (std::size_t ad = 0; ad < geom.NAuxDets(); ++ad) {
+      std::string const name = geom.AuxDet(ad).Name();
+      if ((index.auxDetIndex(name) == ad)
+        && (index.auxDet(ad) == &(geom.AuxDet(ad))))
+        continue;
+      mf::LogError(fOutputCategory) << "Auxiliary detector '" << name
+        << "' is #" << ad << ", but the index says #"
+        << index.auxDetIndex(name);
+      ++nErrors;
+    } // for auxiliary detectors
+    if (index.auxDetIndex("") != geo::AuxDetChannelIndex::NoIndex) {
+      mf::LogError(fOutputCategory)
+        << "An auxiliary detector with no name was found in the index";
+      ++nErrors;
+    }
+    return nErrors;
+  } // AuxDetChannelIndexCheck::checkNames()
+
+
+  //......................................................................
+  unsigned int AuxDetChannelIndexCheck::checkChannels(
+    geo::AuxDetChannelIndex const& index,
+    geo::AuxDetGeometryCore const& geom
+  ) const {
+    using Channel_t = geo::AuxDetChannelIndex::Channel_t;
+
+    unsigned int nErrors = 0U;
+    std::size_t nQueries = 0U;
+    Clock_t::duration indexTime { 0 }, coreTime { 0 };
+
+    for (std::size_t ad = 0; ad < geom.NAuxDets(); ++ad) {
+      geo::AuxDetGeo const& auxDet = geom.AuxDet(ad);
+      std::string const name = auxDet.Name();
+      std::size_t const nChannels
+        = fChannelsPerSensitive * auxDet.NSensitiveVolume();
+
+      std::vector<Channel_t> channels(nChannels);
+      for (std::size_t c = 0; c < nChannels; ++c) channels[c] = c;
+
+      std::vector<SensitiveID_t> expected(nChannels);
+      std::vector<geo::Point_t> expectedPos(nChannels);
+      auto const startCore = Clock_t::now();
+      for (std::size_t c = 0; c < nChannels; ++c) {
+        expected[c] = expectedSensitive(geom, ad, channels[c]);
+        if (!expected[c].isValid()) continue;
+        TVector3 const pos = geom.AuxDetChannelToPosition(channels[c], name);
+        expectedPos[c] = { pos.X(), pos.Y(), pos.Z() };
+      } // for channels
+      coreTime += Clock_t::now() - startCore;
+
+      std::vector<SensitiveID_t> sensitives(nChannels);
+      std::vector<geo::Point_t> positions(nChannels);
+      util::span<Channel_t const*> const channelSpan
+        { channels.data(), channels.data() + nChannels };
+      auto const startIndex = Clock_t::now();
+      index.channelsToSensitive(ad, channelSpan,
+        util::span<SensitiveID_t*>
+          { sensitives.data(), sensitives.data() + nChannels }
+        );
+      std::size_t const nInvalid = index.channelPositions(ad, channelSpan,
+        util::span<geo::Point_t*>
+          { positions.data(), positions.data() + nChannels }
+        );
+      indexTime += Clock_t::now() - startIndex;
+      nQueries += nChannels;
+
+      std::size_t nExpectedInvalid = 0U;
+      for (std::size_t c = 0; c < nChannels; ++c) {
+        Channel_t const channel = channels[c];
+        SensitiveID_t const single = index.channelToSensitive(ad, channel);
+        bool valid;
+        geo::Point_t const singlePos
+          = index.channelPosition(ad, channel, valid);
+
+        bool const expectedValid = expected[c].isValid();
+        if (!expectedValid) ++nExpectedInvalid;
+        bool const sameVolume = expectedValid
+          ? (sameSensitive(sensitives[c], expected[c])
+            && sameSensitive(single, expected[c]))
+          : (!sensitives[c].isValid() && !single.isValid());
+        bool const samePosition = (valid == expectedValid) && (!valid
+          || ((singlePos - expectedPos[c]).R() < 1e-6
+            && (positions[c] - expectedPos[c]).R() < 1e-6));
+        if (sameVolume && samePosition) continue;
+
+        mf::LogError(fOutputCategory) << "Channel " << channel << " of '"
+          << name << "' is in sensitive volume " << expected[c].sensitive
+          << " at " << expectedPos[c] << ", but the index says "
+          << single.sensitive << " (" << sensitives[c].sensitive
+          << " in the batch) at " << singlePos << " (" << positions[c]
+          << " in the batch, " << (valid? "": "not ") << "valid)";
+        ++nErrors;
+      } // for channels
+
+      if (nInvalid != nExpectedInvalid) {
+        mf::LogError(fOutputCategory) << "'" << name << "' has "
+          << nExpectedInvalid << " invalid channels out of " << nChannels
+          << ", but the index says " << nInvalid;
+        ++nErrors;
+      }
+    } // for auxiliary detectors
+
+    reportTimes("ChannelToAuxDetSensitive and AuxDetChannelToPosition",
+      nQueries, indexTime, coreTime);
+    return nErrors;
+  } // AuxDetChannelIndexCheck::checkChannels()
+
+
+  //......................................................................
+  unsigned int AuxDetChannelIndexCheck::checkPositions(
+    geo::AuxDetChannelIndex const& index,
+    geo::AuxDetGeometryCore const& geom
+  ) const {
+    std::vector<geo::Point_t> points;
+    for (std::size_t ad = 0; ad < geom.NAuxDets(); ++ad) {
+      geo::AuxDetGeo const& auxDet = geom.AuxDet(ad);
+      std::vector<geo::Point_t> const grid = gridAround(auxDet);
+      points.insert(points.end(), grid.begin(), grid.end());
+      for (std::size_t sv = 0; sv < auxDet.NSensitiveVolume(); ++sv) {
+        double center[3];
+        auxDet.SensitiveVolume(sv).GetCenter(center);
+        points.emplace_back(center[0], center[1], center[2]);
+      } // for sensitive volumes
+    } // for auxiliary detectors
+    std::size_t const nPoints = points.size();
+
+    std::vector<SensitiveID_t> expected(nPoints);
+    auto const startCore = Clock_t::now();
+    for (std::size_t i = 0; i < nPoints; ++i)
+      expected[i] = expectedSensitiveAt(geom, points[i]);
+    auto const coreTime = Clock_t::now() - startCore;
+
+    util::span<geo::Point_t const*> const pointSpan
+      { points.data(), points.data() + nPoints };
+    std::vector<std::size_t> auxDets(nPoints);
+    std::vector<SensitiveID_t> sensitives(nPoints);
+    auto const startIndex = Clock_t::now();
+    index.auxDetsAt(pointSpan,
+      util::span<std::size_t*>{ auxDets.data(), auxDets.data() + nPoints });
+    index.sensitivesAt(pointSpan,
+      util::span<SensitiveID_t*>
+        { sensitives.data(), sensitives.data() + nPoints }
+      );
+    auto const indexTime = Clock_t::now() - startIndex;
+
+    unsigned int nErrors = 0U;
+    std::size_t nInside = 0U;
+    for (std::size_t i = 0; i < nPoints; ++i) {
+      SensitiveID_t const& exp = expected[i];
+      if (exp.isValid()) ++nInside;
+      std::size_t const single = index.auxDetAt(points[i]);
+      SensitiveID_t const singleSensitive = index.sensitiveAt(points[i]);
+      // a point in an auxiliary detector but in none of its sensitive
+      // volumes has only the detector index valid
+      bool const sameDet
+        = (auxDets[i] == exp.auxDet) && (single == exp.auxDet);
+      bool const sameVolume = exp.isValid()
+        ? (sameSensitive(sensitives[i], exp)
+          && sameSensitive(singleSensitive, exp))
+        : (!sensitives[i].isValid() && !singleSensitive.isValid());
+      if (sameDet && sameVolume) continue;
+      mf::LogError(fOutputCategory) << "Point " << points[i]
+        << " is in auxiliary detector " << exp.auxDet << " (sensitive "
+        << exp.sensitive << "), but the index says " << single << " (batch: "
+        << auxDets[i] << "), sensitive " << singleSensitive.sensitive
+        << " (batch: " << sensitives[i].sensitive << ")";
+      ++nErrors;
+    } // for points
+
+    // the centers of the sensitive volumes at least must be found
+    if (nInside == 0U) {
+      mf::LogError(fOutputCategory)
+        << "No test point is in a sensitive volume";
+      ++nErrors;
+    }
+
+    reportTimes("FindAuxDetAtPosition and FindAuxDetSensitiveAtPosition",
+      nPoints, indexTime, coreTime);
+    return nErrors;
+  } // AuxDetChannelIndexCheck::checkPositions()
+
+
+  //......................................................................
+  auto AuxDetChannelIndexCheck::expectedSensitive(
+    geo::AuxDetGeometryCore const& geom,
+    std::size_t ad, geo::AuxDetChannelIndex::Channel_t channel
+  ) const -> SensitiveID_t {
+    geo::AuxDetGeo const& auxDet = geom.AuxDet(ad);
+    geo::AuxDetSensitiveGeo const* sensitive = nullptr;
+    try {
+      sensitive = &(geom.ChannelToAuxDetSensitive(auxDet.Name(), channel));
+    }
+    catch (cet::exception const&) {
+      return { ad, geo::AuxDetChannelIndex::NoIndex };
+    }
+    for (std::size_t sv = 0; sv < auxDet.NSensitiveVolume(); ++sv)
+      if (&(auxDet.SensitiveVolume(sv)) == sensitive) return { ad, sv };
+    return { ad, geo::AuxDetChannelIndex::NoIndex };
+  } // AuxDetChannelIndexCheck::expectedSensitive()
+
+
+  //......................................................................
+  auto AuxDetChannelIndexCheck::expectedSensitiveAt
+    (geo::AuxDetGeometryCore const& geom, geo::Point_t const& point) const
+    -> SensitiveID_t
+  {
+    double const world[3] = { point.X(), point.Y(), point.Z() };
+    SensitiveID_t sensitive;
+    try {
+      sensitive.auxDet = geom.FindAuxDetAtPosition(world, fTolerance);
+    }
+    catch (cet::exception const&) { return {}; }
+    try {
+      std::size_t ad, sv;
+      geom.FindAuxDetSensitiveAtPosition(world, ad, sv, fTolerance);
+      if (ad == sensitive.auxDet) sensitive.sensitive = sv;
+    }
+    catch (cet::exception const&) {}
+    return sensitive;
+  } // AuxDetChannelIndexCheck::expectedSensitiveAt()
+
+
+  //......................................................................
+  std::vector<geo::Point_t> AuxDetChannelIndexCheck::gridAround
+    (geo::AuxDetGeo const& auxDet) const
+  {
+    // a cube around the center, covering the detector whatever its rotation
+    double const reach = 1.1 * std::max({
+      auxDet.HalfWidth1(), auxDet.HalfWidth2(), auxDet.HalfHeight(),
+      auxDet.Length() / 2.0
+      }) + fTolerance;
+    double center[3];
+    auxDet.GetCenter(center);
+    double const step = 2.0 * reach / (fPointsPerSide - 1U);
+
+    std::vector<geo::Point_t> points;
+    points.reserve(fPointsPerSide * fPointsPerSide * fPointsPerSide);
+    for (unsigned int i = 0; i < fPointsPerSide; ++i) {
+      for (unsigned int j = 0; j < fPointsPerSide; ++j) {
+        for (unsigned int k = 0; k < fPointsPerSide; ++k) {
+          points.emplace_back(
+            center[0] - reach + i * step, center[1] - reach + j * step,
+            center[2] - reach + k * step
+            );
+        } // for k
+      } // for j
+    } // for i
+    return points;
+  } // AuxDetChannelIndexCheck::gridAround()
+
+
+  //......................................................................
+  void AuxDetChannelIndexCheck::reportTimes(std::string const& what,
+    std::size_t n, Clock_t::duration index, Clock_t::duration core) const
+  {
+    using us = std::chrono::duration<double, std::micro>;
+    mf::LogInfo(fOutputCategory) << what << ", " << n << " queries: "
+      << us(index).count() << " us with the index, "
+      << us(core).count() << " us with the geometry provider";
+  } // AuxDetChannelIndexCheck::reportTimes()
+
+
+  //......................................................................
+  DEFINE_ART_MODULE(AuxDetChannelIndexCheck)
+
+} // namespace geo
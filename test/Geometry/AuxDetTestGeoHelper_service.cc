@@ -0,0 +1,127 @@
+/**
+ * @file   AuxDetTestGeoHelper_service.cc
+ * @brief  Auxiliary detector geometry helper with a simple channel mapping
+ * @see    larcore/Geometry/AuxDetExptGeoHelperInterface.h
+ *
+ * This service is meant for the tests of the auxiliary detector geometry,
+ * which needs a channel mapping: LArSoft provides none.
+ */
+
+// LArSoft libraries
+#include "larcore/Geometry/AuxDetExptGeoHelperInterface.h"
+#include "larcorealg/Geometry/AuxDetChannelMapAlg.h"
+#include "larcorealg/Geometry/AuxDetGeometryCore.h" // AuxDetGeometryData_t
+#include "larcorealg/Geometry/AuxDetGeo.h"
+#include "larcorealg/Geometry/AuxDetSensitiveGeo.h"
+
+// framework libraries
+#include "art/Framework/Services/Registry/ServiceMacros.h"
+#include "fhiclcpp/ParameterSet.h"
+#include "cetlib_except/exception.h"
+
+// ROOT libraries
+#include "TVector3.h"
+
+// C/C++ standard libraries
+#include <vector>
+#include <string>
+#include <memory> // std::make_unique()
+#include <cstdint> // uint32_t
+#include <cstddef> // std::size_t
+
+
+namespace geo {
+
+  /**
+   * @brief Channel mapping of auxiliary detectors, for tests.
+   *
+   * Each auxiliary detector has two channels for each of its `N` sensitive
+   * volumes: the sensitive volume number `sv` has channels `sv` and
+   * `2N + sv`. Channels from `N` to `2N - 1` are not used.
+   * The channels are placed at the center of their sensitive volume.
+   *
+   * The channel numbers are chosen so that both the channel table and the
+   * fallback of `geo::AuxDetChannelIndex` (which tabulates channels up to
+   * `2N - 1`) are exercised, as well as unused channels in the table range.
+   */
+  class AuxDetTestChannelMapAlg: public geo::AuxDetChannelMapAlg {
+
+      public:
+
+    virtual void Initialize(geo::AuxDetGeometryData_t& geodata) override
+      {
+        Uninitialize();
+        auto const& auxDets = geodata.auxDets;
+        for (std::size_t ad = 0; ad < auxDets.size(); ++ad) {
+          std::string const name = auxDets[ad]->Name();
+          fADGeoToName[ad] = name;
+          fNameToADGeo[name] = ad;
+
+          std::size_t const nSensitive = auxDets[ad]->NSensitiveVolume();
+          std::vector<geo::chanAndSV>& channels = fADGeoToChannelAndSV[ad];
+          for (std::size_t sv = 0; sv < nSensitive; ++sv) {
+            channels.emplace_back(sv, sv);
+            channels.emplace_back(2U * nSensitive + sv, sv);
+          }
+        } // for auxiliary detectors
+      } // Initialize()
+
+    virtual void Uninitialize() override
+      {
+        fADGeoToChannelAndSV.clear();
+        fADGeoToName.clear();
+        fNameToADGeo.clear();
+      }
+
+    virtual uint32_t PositionToAuxDetChannel(
+      double const worldLoc[3], std::vector<geo::AuxDetGeo*> const& auxDets,
+      std::size_t& ad, std::size_t& sv
+      ) const override
+      {
+        sv = NearestSensitiveAuxDet(worldLoc, auxDets, ad);
+        return sv;
+      }
+
+    virtual TVector3 const AuxDetChannelToPosition(
+      uint32_t const& channel, std::string const& auxDetName,
+      std::vector<geo::AuxDetGeo*> const& auxDets
+      ) const override
+      {
+        // throws `cet::exception` on invalid channels
+        auto const [ ad, sv ]
+          = ChannelToSensitiveAuxDet(auxDets, auxDetName, channel);
+        double center[3];
+        auxDets[ad]->SensitiveVolume(sv).GetCenter(center);
+        return { center[0], center[1], center[2] };
+      }
+
+  }; // class AuxDetTestChannelMapAlg
+
+
+  /**
+   * @brief Auxiliary detector geometry helper for tests.
+   *
+   * The channel mapping is `geo::AuxDetTestChannelMapAlg`.
+   * There are no configuration parameters.
+   */
+  class AuxDetTestGeoHelper: public geo::AuxDetExptGeoHelperInterface {
+
+      public:
+
+    AuxDetTestGeoHelper(fhicl::ParameterSet const&) {}
+
+      private:
+
+    virtual AuxDetChannelMapAlgPtr_t doConfigureAuxDetChannelMapAlg
+      (fhicl::ParameterSet const&) const override
+      { return std::make_unique<geo::AuxDetTestChannelMapAlg>(); }
+
+  }; // class AuxDetTestGeoHelper
+
+} // namespace geo
+
+
+DECLARE_ART_SERVICE_INTERFACE_IMPL
+  (geo::AuxDetTestGeoHelper, geo::AuxDetExptGeoHelperInterface, SHARED)
+DEFINE_ART_SERVICE_INTERFACE_IMPL
+  (geo::AuxDetTestGeoHelper, geo::AuxDetExptGeoHelperInterface)
@@ -0,0 +1,256 @@
+/**
+ * @file   ChannelMapExportCheck_module.cc
+ * @brief  Compares the channel mapping exported by DumpChannelMap with geometry
+ * @see    larcore/Geometry/DumpChannelMap_module.cc
+ */
+
+// LArSoft includes
+#include "larcore/Geometry/ColumnarFile.h"
+#include "larcore/Geometry/Geometry.h"
+#include "larcorealg/Geometry/GeometryCore.h"
+#include "larcorealg/Geometry/OpDetGeo.h"
+#include "larcoreobj/SimpleTypesAndConstants/geo_types.h"
+#include "larcoreobj/SimpleTypesAndConstants/RawTypes.h" // raw::ChannelID_t
+
+// Framework includes
+#include "art/Framework/Core/ModuleMacros.h"
+#include "art/Framework/Core/EDAnalyzer.h"
+#include "art/Framework/Services/Registry/ServiceHandle.h"
+#include "messagefacility/MessageLogger/MessageLogger.h"
+#include "fhiclcpp/types/Atom.h"
+#include "cetlib_except/exception.h"
+
+// C/C++ standard library
+#include <vector>
+#include <string>
+#include <cstdint> // std::uint32_t, std::uint64_t
+
+
+namespace art { class Event; class Run; }
+
+namespace geo {
+
+  /**
+   * @brief Checks the binary channel map export against the geometry.
+   *
+   * The files written by `DumpChannelMap` with its `ExportPrefix` option are
+   * read back and their content compared, entry by entry, with the answers of
+   * `geo::GeometryCore` (`ChannelToWire()`, `PlaneWireToChannel()` and
+   * `OpDetGeoFromOpChannel()`). An exception is thrown on mismatch.
+   *
+   * Configuration parameters
+   * =========================
+   *
+   * - *ExportPrefix* (string, mandatory): path prefix of the exported files,
+   *   as configured in `DumpChannelMap`
+   * - *OutputCategory* (string, default: `ChannelMapExportCheck`): category
+   *   of the messages
+   */
+  class ChannelMapExportCheck: public art::EDAnalyzer {
+      public:
+
+    struct Config {
+      using Name = fhicl::Name;
+      using Comment = fhicl::Comment;
+
+      fhicl::Atom<std::string> ExportPrefix {
+        Name("ExportPrefix"),
+        Comment("path prefix of the exported channel map files")
+        };
+
+      fhicl::Atom<std::string> OutputCategory {
+        Name("OutputCategory"),
+        Comment("message facility category for the output"),
+        "ChannelMapExportCheck"
+        };
+
+    }; // Config
+
+    using Parameters = art::EDAnalyzer::Table<Config>;
+
+    explicit ChannelMapExportCheck(Parameters const& config);
+
+    virtual void analyze(art::Event const&) override {}
+    virtual void beginRun(art::Run const&) override;
+
+      private:
+
+    std::string fExportPrefix; ///< Path prefix of the exported files.
+    std::string fOutputCategory; ///< Category of the messages.
+
+    /// Returns the number of mismatches in the channel-to-wires export.
+    unsigned int checkChannelToWires(geo::GeometryCore const& geom) const;
+
+    /// Returns the number of mismatches in the wire-to-channel export.
+    unsigned int checkWireToChannel(geo::GeometryCore const& geom) const;
+
+    /// Returns the number of mismatches in the optical channel export.
+    unsigned int checkOpDetChannels(geo::GeometryCore const& geom) const;
+
+  }; // class ChannelMapExportCheck
+
+} // namespace geo
+
+
+//******************************************************************************
+namespace geo {
+
+  //......................................................................
+  ChannelMapExportCheck::ChannelMapExportCheck(Parameters const& config)
+    : EDAnalyzer(config)
+    , fExportPrefix(config().ExportPrefix())
+    , fOutputCategory(config().OutputCategory())
+  {
+  } // ChannelMapExportCheck::ChannelMapExportCheck()
+
+
+  //......................................................................
+  void ChannelMapExportCheck::beginRun(art::Run const&) {
+
+    geo::GeometryCore const& geom = *(art::ServiceHandle<geo::Geometry const>());
+
+    unsigned int const nErrors = checkChannelToWires(geom)
+      + checkWireToChannel(geom) + checkOpDetChannels(geom);
+
+    if (nErrors > 0U) {
+      throw cet::exception("ChannelMapExportCheck")
+        << nErrors << " mismatches between the channel map exported in '"
+        << fExportPrefix << "*' and the geometry.\n";
+    }
+    mf::LogInfo(fOutputCategory)
+      << "Channel map export in '" << fExportPrefix << "*' matches geometry.";
+
+  } // ChannelMapExportCheck::beginRun()
+
+
+  //......................................................................
+  unsigned int ChannelMapExportCheck::checkChannelToWires
+    (geo::GeometryCore const& geom) const
+  {
+    geo::ColumnarFileReader const file
+      { fExportPrefix + "channel_to_wires.lcol" };
+    auto const offsets = file.column<std::uint64_t>("offset");
+    auto const cryostats = file.column<std::uint32_t>("cryostat");
+    auto const TPCs = file.column<std::uint32_t>("tpc");
+    auto const planes = file.column<std::uint32_t>("plane");
+    auto const wires = file.column<std::uint32_t>("wire");
+
+    raw::ChannelID_t const nChannels = geom.Nchannels();
+    if (offsets.size() != nChannels + 1U) {
+      mf::LogError(fOutputCategory) << "Channel-to-wires export has "
+        << offsets.size() << " offsets, expected " << (nChannels + 1U);
+      return 1U;
+    }
+
+    unsigned int nErrors = 0U;
+    for (raw::ChannelID_t channel = 0; channel < nChannels; ++channel) {
+      std::vector<geo::WireID> const expected = geom.ChannelToWire(channel);
+      std::uint64_t const begin = offsets.begin()[channel];
+      std::uint64_t const end = offsets.begin()[channel + 1];
+      bool match = (end >= begin) && (end - begin == expected.size())
+        && (end <= wires.size());
+      for (std::size_t i = 0; match && (i < expected.size()); ++i) {
+        geo::WireID const& wireID = expected[i];
+        std::uint64_t const row = begin + i;
+        match = (cryostats.begin()[row] == wireID.Cryostat)
+          && (TPCs.begin()[row] == wireID.TPC)
+          && (planes.begin()[row] == wireID.Plane)
+          && (wires.begin()[row] == wireID.Wire);
+      } // for
+      if (match) continue;
+      mf::LogError(fOutputCategory)
+        << "Channel-to-wires export mismatch for channel " << channel;
+      ++nErrors;
+    } // for channels
+    return nErrors;
+  } // ChannelMapExportCheck::checkChannelToWires()
+
+
+  //......................................................................
+  unsigned int ChannelMapExportCheck::checkWireToChannel
+    (geo::GeometryCore const& geom) const
+  {
+    geo::ColumnarFileReader const file
+      { fExportPrefix + "wire_to_channel.lcol" };
+    auto const cryostats = file.column<std::uint32_t>("cryostat");
+    auto const TPCs = file.column<std::uint32_t>("tpc");
+    auto const planes = file.column<std::uint32_t>("plane");
+    auto const wires = file.column<std::uint32_t>("wire");
+    auto const channels = file.column<std::uint32_t>("channel");
+
+    unsigned int nErrors = 0U;
+    std::size_t row = 0U;
+    for (geo::WireID const& wireID: geom.IterateWireIDs()) {
+      if (row >= channels.size()) {
+        mf::LogError(fOutputCategory)
+          << "Wire-to-channel export is missing wires from " << wireID;
+        return nErrors + 1U;
+      }
+      bool const match = (cryostats.begin()[row] == wireID.Cryostat)
+        && (TPCs.begin()[row] == wireID.TPC)
+        && (planes.begin()[row] == wireID.Plane)
+        && (wires.begin()[row] == wireID.Wire)
+        && (channels.begin()[row] == geom.PlaneWireToChannel(wireID));
+      ++row;
+      if (match) continue;
+      mf::LogError(fOutputCategory)
+        << "Wire-to-channel export mismatch for " << wireID;
+      ++nErrors;
+    } // for wires
+    if (row != channels.size()) {
+      mf::LogError(fOutputCategory) << "Wire-to-channel export has "
+        << channels.size() << " wires, expected " << row;
+      ++nErrors;
+    }
+    return nErrors;
+  } // ChannelMapExportCheck::checkWireToChannel()
+
+
+  //......................................................................
+  unsigned int ChannelMapExportCheck::checkOpDetChannels
+    (geo::GeometryCore const& geom) const
+  {
+    geo::ColumnarFileReader const file
+      { fExportPrefix + "opchannel_to_opdet.lcol" };
+    auto const cryostats = file.column<std::uint32_t>("cryostat");
+    auto const opDets = file.column<std::uint32_t>("opdet");
+    auto const centerX = file.column<double>("center_x");
+    auto const centerY = file.column<double>("center_y");
+    auto const centerZ = file.column<double>("center_z");
+
+    if (opDets.size() < geom.NOpChannels()) {
+      mf::LogError(fOutputCategory) << "Optical channel export has "
+        << opDets.size() << " channels, expected at least "
+        << geom.NOpChannels();
+      return 1U;
+    }
+
+    unsigned int nErrors = 0U;
+    for (unsigned int channel = 0; channel < opDets.size(); ++channel) {
+      bool match = true;
+      if (geom.IsValidOpChannel(channel)) {
+        geo::OpDetGeo const& opDet = geom.OpDetGeoFromOpChannel(channel);
+        geo::Point_t const& center = opDet.GetCenter();
+        match = (cryostats.begin()[channel] == opDet.ID().Cryostat)
+          && (opDets.begin()[channel] == opDet.ID().OpDet)
+          && (centerX.begin()[channel] == center.X())
+          && (centerY.begin()[channel] == center.Y())
+          && (centerZ.begin()[channel] == center.Z());
+      }
+      else {
+        match = (cryostats.begin()[channel] == ColumnarFormat::InvalidIndex)
+          && (opDets.begin()[channel] == ColumnarFormat::InvalidIndex);
+      }
+      if (match) continue;
+      mf::LogError(fOutputCategory)
+        << "Optical channel export mismatch for channel " << channel;
+      ++nErrors;
+    } // for channels
+    return nErrors;
+  } // ChannelMapExportCheck::checkOpDetChannels()
+
+
+  //......................................................................
+  DEFINE_ART_MODULE(ChannelMapExportCheck)
+
+} // namespace geo
@@ -0,0 +1,210 @@
+/**
+ * @file   ChannelMapMemoCheck_module.cc
+ * @brief  Compares the memoized channel mapping tables with the algorithm
+ * @see    larcore/Geometry/ChannelMapTablesMemo.h
+ */
+
+// LArSoft includes
+#include "larcore/Geometry/ChannelMapTablesMemo.h"
+#include "larcore/Geometry/ExptGeoHelperInterface.h"
+#include "larcore/Geometry/Geometry.h"
+#include "larcore/Geometry/WireToChannelTable.h"
+#include "larcore/Geometry/ChannelToWireTable.h"
+#include "larcorealg/Geometry/GeometryCore.h"
+
+// Framework includes
+#include "art/Framework/Core/ModuleMacros.h"
+#include "art/Framework/Core/EDAnalyzer.h"
+#include "art/Framework/Services/Registry/ServiceHandle.h"
+#include "messagefacility/MessageLogger/MessageLogger.h"
+#include "fhiclcpp/types/Atom.h"
+#include "cetlib_except/exception.h"
+
+// C/C++ standard library
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstdint> // std::uint64_t
+#include <cstddef> // std::byte
+
+
+namespace art { class Event; class Run; }
+
+namespace geo {
+
+  /**
+   * @brief Checks the memoized channel mapping tables against the algorithm.
+   *
+   * The channel mapping tables of the `Geometry` service, which is expected
+   * to be configured with `MemoizeChannelMap`, are compared bit by bit with
+   * tables freshly filled by querying the channel mapping algorithm through
+   * `geo::GeometryCore`. An exception is thrown on mismatch.
+   *
+   * The time spent filling the tables from the algorithm is reported, and
+   * compared with the time to load them from the memo file, if a memo
+   * directory is specified.
+   *
+   * Configuration parameters
+   * =========================
+   *
+   * - *ExpectFromFile* (boolean, default: `false`): requires the tables to
+   *   have been read from a file written by a previous job
+   * - *MemoDirectory* (string, default: empty): directory of the memo files
+   *   (usually the `CacheDirectory` of `Geometry`), to time the loading of
+   *   the tables from there; if empty, that is not timed
+   * - *OutputCategory* (string, default: `ChannelMapMemoCheck`): category
+   *   of the messages
+   */
+  class ChannelMapMemoCheck: public art::EDAnalyzer {
+      public:
+
+    struct Config {
+      using Name = fhicl::Name;
+      using Comment = fhicl::Comment;
+
+      fhicl::Atom<bool> ExpectFromFile {
+        Name("ExpectFromFile"),
+        Comment("requires the tables to be read from a memo file"),
+        false
+        };
+
+      fhicl::Atom<std::string> MemoDirectory {
+        Name("MemoDirectory"),
+        Comment("directory of the memo files, to time their loading"),
+        ""
+        };
+
+      fhicl::Atom<std::string> OutputCategory {
+        Name("OutputCategory"),
+        Comment("message facility category for the output"),
+        "ChannelMapMemoCheck"
+        };
+
+    }; // Config
+
+    using Parameters = art::EDAnalyzer::Table<Config>;
+
+    explicit ChannelMapMemoCheck(Parameters const& config);
+
+    virtual void analyze(art::Event const&) override {}
+    virtual void beginRun(art::Run const&) override;
+
+      private:
+
+    bool fExpectFromFile; ///< Whether tables must come from a file.
+    std::string fMemoDirectory; ///< Directory of the memo files to time.
+    std::string fOutputCategory; ///< Category of the messages.
+
+    /// Returns the serialization of `table`.
+    template <typename Table>
+    static std::vector<std::uint64_t> serialized(Table const& table);
+
+  }; // class ChannelMapMemoCheck
+
+} // namespace geo
+
+
+//******************************************************************************
+namespace geo {
+
+  //......................................................................
+  ChannelMapMemoCheck::ChannelMapMemoCheck(Parameters const& config)
+    : EDAnalyzer(config)
+    , fExpectFromFile(config().ExpectFromFile())
+    , fMemoDirectory(config().MemoDirectory())
+    , fOutputCategory(config().OutputCategory())
+  {
+  } // ChannelMapMemoCheck::ChannelMapMemoCheck()
+
+
+  //......................................................................
+  void ChannelMapMemoCheck::beginRun(art::Run const&) {
+
+    geo::Geometry const& geom = *(art::ServiceHandle<geo::Geometry const>());
+    geo::ChannelMapTablesMemo const& memo
+      = art::ServiceHandle<geo::ExptGeoHelperInterface const>()
+        ->ChannelMapMemo();
+
+    mf::LogInfo(fOutputCategory) << "Channel map memo: "
+      << memo.nFileHits() << " hits from file, "
+      << memo.nWritten() << " tables written";
+
+    if (fExpectFromFile && (memo.nFileHits() == 0U)) {
+      throw cet::exception("ChannelMapMemoCheck")
+        << "Channel mapping tables were not read from a memo file.\n";
+    }
+
+    // the `geo::GeometryCore` interface queries the algorithm directly
+    geo::GeometryCore const& geomCore = geom;
+
+    using Clock_t = std::chrono::steady_clock;
+    using ms = std::chrono::duration<double, std::milli>;
+
+    auto const buildStart = Clock_t::now();
+    geo::WireToChannelTable const wireToChannel { geomCore };
+    geo::ChannelToWireTable const channelToWires { geomCore };
+    ms const buildTime = Clock_t::now() - buildStart;
+
+    if (!fMemoDirectory.empty()) {
+      // a new memo, reading the file again
+      geo::ChannelMapTablesMemo const fileMemo;
+      auto const loadStart = Clock_t::now();
+      auto const loaded
+        = fileMemo.find(geom.ChannelMapMemoKey(), fMemoDirectory);
+      ms const loadTime = Clock_t::now() - loadStart;
+      if (!loaded) {
+        throw cet::exception("ChannelMapMemoCheck")
+          << "No memoized channel mapping tables in '" << fMemoDirectory
+          << "'.\n";
+      }
+      mf::LogInfo(fOutputCategory)
+        << "Channel mapping tables filled from the algorithm in "
+        << buildTime.count() << " ms, loaded from the memo file in "
+        << loadTime.count() << " ms";
+    }
+    else {
+      mf::LogInfo(fOutputCategory)
+        << "Channel mapping tables filled from the algorithm in "
+        << buildTime.count() << " ms";
+    }
+
+    unsigned int nErrors = 0U;
+    if (serialized(geom.WireToChannelMap()) != serialized(wireToChannel)) {
+      mf::LogError(fOutputCategory)
+        << "Memoized wire-to-channel table differs from the algorithm.";
+      ++nErrors;
+    }
+    if (serialized(geom.ChannelToWireMap()) != serialized(channelToWires)) {
+      mf::LogError(fOutputCategory)
+        << "Memoized channel-to-wires table differs from the algorithm.";
+      ++nErrors;
+    }
+
+    if (nErrors > 0U) {
+      throw cet::exception("ChannelMapMemoCheck")
+        << nErrors << " memoized channel mapping tables do not match the"
+        " channel mapping algorithm.\n";
+    }
+    mf::LogInfo(fOutputCategory)
+      << "Memoized channel mapping tables match the algorithm.";
+
+  } // ChannelMapMemoCheck::beginRun()
+
+
+  //......................................................................
+  template <typename Table>
+  std::vector<std::uint64_t> ChannelMapMemoCheck::serialized
+    (Table const& table)
+  {
+    std::size_t const size = table.serializedSize();
+    std::vector<std::uint64_t> buffer
+      ((size + sizeof(std::uint64_t) - 1U) / sizeof(std::uint64_t), 0U);
+    table.serialize(reinterpret_cast<std::byte*>(buffer.data()));
+    return buffer;
+  } // ChannelMapMemoCheck::serialized()
+
+
+  //......................................................................
+  DEFINE_ART_MODULE(ChannelMapMemoCheck)
+
+} // namespace geo
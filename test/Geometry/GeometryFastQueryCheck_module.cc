@@ -0,0 +1,578 @@
+/**
+ * @file   GeometryFastQueryCheck_module.cc
+ * @brief  Compares the fast lookup queries of `Geometry` with `GeometryCore`
+ * @see    larcore/Geometry/Geometry.h
+ */
+
+// LArSoft includes
+#include "larcore/Geometry/Geometry.h"
+#include "larcorealg/Geometry/GeometryCore.h"
+#include "larcorealg/Geometry/CryostatGeo.h"
+#include "larcorealg/Geometry/TPCGeo.h"
+#include "larcorealg/Geometry/PlaneGeo.h"
+#include "larcorealg/Geometry/WireGeo.h"
+#include "larcorealg/Geometry/OpDetGeo.h"
+#include "larcorealg/Geometry/Exceptions.h" // geo::InvalidWireError
+#include "larcoreobj/SimpleTypesAndConstants/geo_types.h"
+#include "larcoreobj/SimpleTypesAndConstants/RawTypes.h" // raw::ChannelID_t
+
+// Framework includes
+#include "art/Framework/Core/ModuleMacros.h"
+#include "art/Framework/Core/EDAnalyzer.h"
+#include "art/Framework/Services/Registry/ServiceHandle.h"
+#include "messagefacility/MessageLogger/MessageLogger.h"
+#include "fhiclcpp/types/Atom.h"
+#include "cetlib_except/exception.h"
+
+// C/C++ standard library
+#include <vector>
+#include <string>
+#include <algorithm> // std::equal()
+#include <chrono>
+#include <cmath> // std::abs(), std::floor()
+
+
+namespace art { class Event; class Run; }
+
+namespace geo {
+
+  /**
+   * @brief Checks the fast lookup queries of `Geometry` against the provider.
+   *
+   * Each fast lookup query of `geo::Geometry` (see "Fast lookup tables" in
+   * its documentation) is compared with the equivalent query through the
+   * `geo::GeometryCore` interface, which does not use the lookup tables:
+   *
+   * * `ChannelToWireSpan()` with `ChannelToWire()`, on every channel;
+   * * `WireToChannelMap()` and `PlaneWireToChannel()` on a range, with
+   *   `PlaneWireToChannel()` on every wire;
+   * * `WireArrays()` with the `geo::WireGeo` of every wire, and empty
+   *   arrays for plane numbers not in the detector;
+   * * `NMaterializedPlanes()` and `NMaterializedWireArrayPlanes()`, once
+   *   all the tables are filled, with the number of planes;
+   * * `WireCoordinates()`, `NearestWires()` and `NearestWireIDs()` with
+   *   `WireCoordinate()` and `NearestWireID()`, on a grid of points around
+   *   each TPC, on each of its planes;
+   * * `PositionToCryostatID()`, `PositionToTPCID()` and `PositionToTPCIDs()`
+   *   with the same `geo::GeometryCore` queries, on a grid of points around
+   *   each cryostat;
+   * * `OpDetGeoPtrFromOpChannel()` and `OpDetGeosFromOpChannels()` with
+   *   `OpDetGeoFromOpChannel()`, on every optical channel.
+   *
+   * The time spent by the two sides of each comparison is also reported.
+   * An exception is thrown on mismatch.
+   *
+   * Configuration parameters
+   * =========================
+   *
+   * - *PointsPerSide* (integer, default: `10`): the grids of test points have
+   *   this many points on each side
+   * - *OutputCategory* (string, default: `GeometryFastQueryCheck`): category
+   *   of the messages
+   */
+  class GeometryFastQueryCheck: public art::EDAnalyzer {
+      public:
+
+    struct Config {
+      using Name = fhicl::Name;
+      using Comment = fhicl::Comment;
+
+      fhicl::Atom<unsigned int> PointsPerSide {
+        Name("PointsPerSide"),
+        Comment("number of test points on each side of the grids"),
+        10U
+        };
+
+      fhicl::Atom<std::string> OutputCategory {
+        Name("OutputCategory"),
+        Comment("message facility category for the output"),
+        "GeometryFastQueryCheck"
+        };
+
+    }; // Config
+
+    using Parameters = art::EDAnalyzer::Table<Config>;
+
+    explicit GeometryFastQueryCheck(Parameters const& config);
+
+    virtual void analyze(art::Event const&) override {}
+    virtual void beginRun(art::Run const&) override;
+
+      private:
+
+    using Clock_t = std::chrono::steady_clock;
+
+    unsigned int fPointsPerSide; ///< Points on each side of the grids.
+    std::string fOutputCategory; ///< Category of the messages.
+
+    /// Returns the number of mismatches in the channel-to-wire queries.
+    unsigned int checkChannelToWire
+      (geo::Geometry const& geom, geo::GeometryCore const& core) const;
+
+    /// Returns the number of mismatches in the wire-to-channel queries.
+    unsigned int checkWireToChannel
+      (geo::Geometry const& geom, geo::GeometryCore const& core) const;
+
+    /// Returns the number of mismatches in the wire arrays.
+    unsigned int checkWireArrays
+      (geo::Geometry const& geom, geo::GeometryCore const& core) const;
+
+    /// Returns the number of mismatches in the count of filled planes.
+    unsigned int checkMaterializedPlanes
+      (geo::Geometry const& geom, geo::GeometryCore const& core) const;
+
+    /// Returns the number of mismatches in the wire coordinate queries.
+    unsigned int checkWireCoordinates
+      (geo::Geometry const& geom, geo::GeometryCore const& core) const;
+
+    /// Returns the number of mismatches in the point location queries.
+    unsigned int checkPositions
+      (geo::Geometry const& geom, geo::GeometryCore const& core) const;
+
+    /// Returns the number of mismatches in the optical channel queries.
+    unsigned int checkOpDetChannels
+      (geo::Geometry const& geom, geo::GeometryCore const& core) const;
+
+    /// Returns a grid of points covering `box` enlarged by 10% per side.
+    std::vector<geo::Point_t> gridAround(geo::BoxBoundedGeo const& box) const;
+
+    /// Reports the time of the fast and of the provider queries of `what`.
+    void reportTimes(std::string const& what, std::size_t n,
+      Clock_t::duration fast, Clock_t::duration core) const;
+
+  }; // class GeometryFastQueryCheck
+
+} // namespace geo
+
+
+//******************************************************************************
+namespace geo {
+
+  //......................................................................
+  GeometryFastQueryCheck::GeometryFastQueryCheck(Parameters const& config)
+    : EDAnalyzer(config)
+    , fPointsPerSide(config().PointsPerSide())
+    , fOutputCategory(config().OutputCategory())
+  {
+    if (fPointsPerSide < 2U) {
+      throw art::Exception(art::errors::Configuration)
+        << "PointsPerSide must be at least 2 (" << fPointsPerSide
+        << " specified).\n";
+    }
+  } // GeometryFastQueryCheck::GeometryFastQueryCheck()
+
+
+  //......................................................................
+  void GeometryFastQueryCheck::beginRun(art::Run const&) {
+
+    geo::Geometry const& geom = *(art::ServiceHandle<geo::Geometry const>());
+
+    // the `geo::GeometryCore` interface does not use the lookup tables
+    geo::GeometryCore const& core = geom;
+
+    unsigned int const nErrors = checkChannelToWire(geom, core)
+      + checkWireToChannel(geom, core) + checkWireArrays(geom, core)
+      + checkMaterializedPlanes(geom, core)
+      + checkWireCoordinates(geom, core) + checkPositions(geom, core)
+      + checkOpDetChannels(geom, core);
+
+    if (nErrors > 0U) {
+      throw cet::exception("GeometryFastQueryCheck")
+        << nErrors << " mismatches between the fast lookup queries and"
+        " the geometry provider.\n";
+    }
+    mf::LogInfo(fOutputCategory)
+      << "All fast lookup queries match the geometry provider.";
+
+  } // GeometryFastQueryCheck::beginRun()
+
+
+  //......................................................................
+  unsigned int GeometryFastQueryCheck::checkChannelToWire
+    (geo::Geometry const& geom, geo::GeometryCore const& core) const
+  {
+    unsigned int const nChannels = core.Nchannels();
+
+    std::vector<std::vector<geo::WireID>> expected;
+    expected.reserve(nChannels);
+    auto const startCore = Clock_t::now();
+    for (raw::ChannelID_t channel = 0; channel < nChannels; ++channel)
+      expected.push_back(core.ChannelToWire(channel));
+    auto const coreTime = Clock_t::now() - startCore;
+
+    std::size_t nWires = 0U;
+    auto const startFast = Clock_t::now();
+    for (raw::ChannelID_t channel = 0; channel < nChannels; ++channel)
+      nWires += geom.ChannelToWireSpan(channel).size();
+    auto const fastTime = Clock_t::now() - startFast;
+
+    unsigned int nErrors = 0U;
+    for (raw::ChannelID_t channel = 0; channel < nChannels; ++channel) {
+      auto const wires = geom.ChannelToWireSpan(channel);
+      std::vector<geo::WireID> const& expectedWires = expected[channel];
+      if ((wires.size() == expectedWires.size())
+        && std::equal(wires.begin(), wires.end(), expectedWires.begin()))
+        continue;
+      mf::LogError(fOutputCategory) << "Channel " << channel << " covers "
+        << expectedWires.size() << " wires, but its span has "
+        << wires.size() << " (or different ones)";
+      ++nErrors;
+    } // for channels
+
+    if (!geom.ChannelToWireSpan(raw::InvalidChannelID).empty()) {
+      mf::LogError(fOutputCategory)
+        << "Invalid channel has a nonempty span of wires";
+      ++nErrors;
+    }
+
+    reportTimes("ChannelToWire (" + std::to_string(nWires) + " wires)",
+      nChannels, fastTime, coreTime);
+    return nErrors;
+  } // GeometryFastQueryCheck::checkChannelToWire()
+
+
+  //......................................................................
+  unsigned int GeometryFastQueryCheck::checkWireToChannel
+    (geo::Geometry const& geom, geo::GeometryCore const& core) const
+  {
+    std::vector<geo::WireID> wireIDs;
+    for (geo::WireID const& wireID: core.IterateWireIDs())
+      wireIDs.push_back(wireID);
+    std::size_t const nWires = wireIDs.size();
+
+    std::vector<raw::ChannelID_t> expected(nWires, raw::InvalidChannelID);
+    auto const startCore = Clock_t::now();
+    for (std::size_t i = 0; i < nWires; ++i)
+      expected[i] = core.PlaneWireToChannel(wireIDs[i]);
+    auto const coreTime = Clock_t::now() - startCore;
+
+    std::vector<raw::ChannelID_t> channels(nWires, raw::InvalidChannelID);
+    auto const startFast = Clock_t::now();
+    geom.PlaneWireToChannel(
+      util::span<geo::WireID const*>{ wireIDs.data(), wireIDs.data() + nWires },
+      util::span<raw::ChannelID_t*>{ channels.data(), channels.data() + nWires }
+      );
+    auto const fastTime = Clock_t::now() - startFast;
+
+    geo::WireToChannelTable const& table = geom.WireToChannelMap();
+    unsigned int nErrors = 0U;
+    for (std::size_t i = 0; i < nWires; ++i) {
+      raw::ChannelID_t const single = table.channel(wireIDs[i]);
+      if ((channels[i] == expected[i]) && (single == expected[i])) continue;
+      mf::LogError(fOutputCategory) << "Wire " << std::string(wireIDs[i])
+        << " is on channel " << expected[i] << ", but the table says "
+        << single << " and the range query " << channels[i];
+      ++nErrors;
+    } // for wires
+
+    reportTimes("PlaneWireToChannel", nWires, fastTime, coreTime);
+    return nErrors;
+  } // GeometryFastQueryCheck::checkWireToChannel()
+
+
+  //......................................................................
+  unsigned int GeometryFastQueryCheck::checkWireArrays
+    (geo::Geometry const& geom, geo::GeometryCore const& core) const
+  {
+    unsigned int nErrors = 0U;
+    for (geo::PlaneGeo const& plane: core.IteratePlanes()) {
+      geo::PlaneID const& planeID = plane.ID();
+      geo::PlaneWireArrays const& arrays = geom.WireArrays(planeID);
+      if (arrays.size() != plane.Nwires()) {
+        mf::LogError(fOutputCategory) << "Plane " << std::string(planeID)
+          << " has " << plane.Nwires() << " wires, but " << arrays.size()
+          << " in its arrays";
+        ++nErrors;
+        continue;
+      }
+      for (unsigned int iWire = 0; iWire < plane.Nwires(); ++iWire) {
+        geo::WireGeo const& wire = plane.Wire(iWire);
+        auto const start = wire.GetStart();
+        auto const end = wire.GetEnd();
+        auto const dir = wire.Direction();
+        // values are copied, not computed: they must match exactly
+        if ((arrays.startX[iWire] == start.X())
+          && (arrays.startY[iWire] == start.Y())
+          && (arrays.startZ[iWire] == start.Z())
+          && (arrays.endX[iWire] == end.X())
+          && (arrays.endY[iWire] == end.Y())
+          && (arrays.endZ[iWire] == end.Z())
+          && (arrays.dirX[iWire] == dir.X())
+          && (arrays.dirY[iWire] == dir.Y())
+          && (arrays.dirZ[iWire] == dir.Z())
+          )
+          continue;
+        mf::LogError(fOutputCategory) << "Wire " << iWire << " of plane "
+          << std::string(planeID) << " differs in the wire arrays";
+        ++nErrors;
+      } // for wires
+    } // for planes
+
+    // plane numbers in the range of the tables but not in the detector
+    for (geo::CryostatGeo const& cryo: core.IterateCryostats()) {
+      for (unsigned int t = 0; t < core.MaxTPCs(); ++t) {
+        for (unsigned int p = 0; p < core.MaxPlanes(); ++p) {
+          geo::PlaneID const planeID { cryo.ID(), t, p };
+          if (core.HasPlane(planeID) || geom.WireArrays(planeID).empty())
+            continue;
+          mf::LogError(fOutputCategory) << "Plane " << std::string(planeID)
+            << " is not in the detector, but it has wire arrays";
+          ++nErrors;
+        } // for planes
+      } // for TPCs
+    } // for cryostats
+
+    return nErrors;
+  } // GeometryFastQueryCheck::checkWireArrays()
+
+
+  //......................................................................
+  unsigned int GeometryFastQueryCheck::checkMaterializedPlanes
+    (geo::Geometry const& geom, geo::GeometryCore const& core) const
+  {
+    // all planes have been queried by now; this fills any left
+    geom.WireToChannelMap().materializeAll();
+
+    std::size_t nPlanes = 0U;
+    for (geo::TPCGeo const& tpc: core.IterateTPCs()) nPlanes += tpc.Nplanes();
+
+    unsigned int nErrors = 0U;
+    if (geom.NMaterializedPlanes() != nPlanes) {
+      mf::LogError(fOutputCategory) << "Wire-to-channel table filled for "
+        << geom.NMaterializedPlanes() << " planes, expected " << nPlanes;
+      ++nErrors;
+    }
+    if (geom.NMaterializedWireArrayPlanes() != nPlanes) {
+      mf::LogError(fOutputCategory) << "Wire arrays filled for "
+        << geom.NMaterializedWireArrayPlanes() << " planes, expected "
+        << nPlanes;
+      ++nErrors;
+    }
+    return nErrors;
+  } // GeometryFastQueryCheck::checkMaterializedPlanes()
+
+
+  //......................................................................
+  unsigned int GeometryFastQueryCheck::checkWireCoordinates
+    (geo::Geometry const& geom, geo::GeometryCore const& core) const
+  {
+    unsigned int nErrors = 0U;
+    std::size_t nQueries = 0U;
+    Clock_t::duration fastTime { 0 }, coreTime { 0 };
+
+    for (geo::TPCGeo const& TPC: core.IterateTPCs()) {
+      std::vector<geo::Point_t> const points = gridAround(TPC);
+      std::size_t const nPoints = points.size();
+      util::span<geo::Point_t const*> const pointSpan
+        { points.data(), points.data() + nPoints };
+
+      for (unsigned int p = 0; p < TPC.Nplanes(); ++p) {
+        geo::PlaneGeo const& plane = TPC.Plane(p);
+        geo::PlaneID const& planeID = plane.ID();
+
+        std::vector<double> expectedCoords(nPoints);
+        std::vector<geo::WireID> expectedWires(nPoints);
+        auto const startCore = Clock_t::now();
+        for (std::size_t i = 0; i < nPoints; ++i) {
+          expectedCoords[i] = core.WireCoordinate(points[i], planeID);
+          try {
+            expectedWires[i] = core.NearestWireID(points[i], planeID);
+          }
+          catch (geo::InvalidWireError const& e) {
+            expectedWires[i] = e.suggestedWireID(); // the closest border wire
+          }
+        } // for points
+        coreTime += Clock_t::now() - startCore;
+
+        std::vector<double> coords(nPoints);
+        std::vector<geo::WireID::WireID_t> wires(nPoints);
+        auto const startFast = Clock_t::now();
+        geom.WireCoordinates(pointSpan, planeID,
+          util::span<double*>{ coords.data(), coords.data() + nPoints });
+        geom.NearestWires(pointSpan, planeID,
+          util::span<geo::WireID::WireID_t*>
+            { wires.data(), wires.data() + nPoints }
+          );
+        fastTime += Clock_t::now() - startFast;
+
+        std::vector<geo::PlaneID> const planeIDs(nPoints, planeID);
+        std::vector<geo::WireID> wireIDs(nPoints);
+        geom.NearestWireIDs(pointSpan,
+          util::span<geo::PlaneID const*>
+            { planeIDs.data(), planeIDs.data() + nPoints },
+          util::span<geo::WireID*>{ wireIDs.data(), wireIDs.data() + nPoints }
+          );
+
+        nQueries += nPoints;
+        for (std::size_t i = 0; i < nPoints; ++i) {
+          double const expected = expectedCoords[i];
+          if (std::abs(coords[i] - expected) > 1e-6) {
+            mf::LogError(fOutputCategory) << "Point " << points[i]
+              << " has wire coordinate " << expected << " on plane "
+              << std::string(planeID) << ", but " << coords[i]
+              << " from the table";
+            ++nErrors;
+            continue;
+          }
+          // points halfway between two wires may legitimately go either way
+          double const frac = expected - std::floor(expected);
+          if (std::abs(frac - 0.5) < 1e-6) continue;
+          if ((wires[i] == expectedWires[i].Wire)
+            && (wireIDs[i] == expectedWires[i]))
+            continue;
+          mf::LogError(fOutputCategory) << "Point " << points[i]
+            << " is closest to " << std::string(expectedWires[i])
+            << ", but the table says wire " << wires[i] << " ("
+            << std::string(wireIDs[i]) << ")";
+          ++nErrors;
+        } // for points
+      } // for planes
+    } // for TPCs
+
+    reportTimes("WireCoordinate and NearestWireID", nQueries,
+      fastTime, coreTime);
+    return nErrors;
+  } // GeometryFastQueryCheck::checkWireCoordinates()
+
+
+  //......................................................................
+  unsigned int GeometryFastQueryCheck::checkPositions
+    (geo::Geometry const& geom, geo::GeometryCore const& core) const
+  {
+    std::vector<geo::Point_t> points;
+    for (geo::CryostatGeo const& cryo: core.IterateCryostats()) {
+      std::vector<geo::Point_t> const grid = gridAround(cryo);
+      points.insert(points.end(), grid.begin(), grid.end());
+    }
+    std::size_t const nPoints = points.size();
+
+    std::vector<geo::CryostatID> expectedCryos(nPoints);
+    std::vector<geo::TPCID> expectedTPCs(nPoints);
+    auto const startCore = Clock_t::now();
+    for (std::size_t i = 0; i < nPoints; ++i) {
+      expectedCryos[i] = core.PositionToCryostatID(points[i]);
+      expectedTPCs[i] = core.PositionToTPCID(points[i]);
+    }
+    auto const coreTime = Clock_t::now() - startCore;
+
+    std::vector<geo::CryostatID> cryos(nPoints);
+    std::vector<geo::TPCID> TPCs(nPoints);
+    auto const startFast = Clock_t::now();
+    for (std::size_t i = 0; i < nPoints; ++i)
+      cryos[i] = geom.PositionToCryostatID(points[i]);
+    geom.PositionToTPCIDs(
+      util::span<geo::Point_t const*>{ points.data(), points.data() + nPoints },
+      util::span<geo::TPCID*>{ TPCs.data(), TPCs.data() + nPoints }
+      );
+    auto const fastTime = Clock_t::now() - startFast;
+
+    unsigned int nErrors = 0U;
+    for (std::size_t i = 0; i < nPoints; ++i) {
+      geo::TPCID const single = geom.PositionToTPCID(points[i]);
+      if ((cryos[i] == expectedCryos[i]) && (TPCs[i] == expectedTPCs[i])
+        && (single == expectedTPCs[i]))
+        continue;
+      mf::LogError(fOutputCategory) << "Point " << points[i] << " is in "
+        << std::string(expectedTPCs[i]) << " (cryostat "
+        << std::string(expectedCryos[i]) << "), but the index says "
+        << std::string(TPCs[i]) << " (cryostat " << std::string(cryos[i])
+        << ")";
+      ++nErrors;
+    } // for points
+
+    reportTimes("PositionToCryostatID and PositionToTPCID", nPoints,
+      fastTime, coreTime);
+    return nErrors;
+  } // GeometryFastQueryCheck::checkPositions()
+
+
+  //......................................................................
+  unsigned int GeometryFastQueryCheck::checkOpDetChannels
+    (geo::Geometry const& geom, geo::GeometryCore const& core) const
+  {
+    if (core.NOpChannels() == 0U) return 0U;
+
+    // also one channel past the last valid one
+    unsigned int const nChannels = core.MaxOpChannel() + 2U;
+    std::vector<unsigned int> opChannels(nChannels);
+    for (unsigned int c = 0; c < nChannels; ++c) opChannels[c] = c;
+
+    std::vector<geo::OpDetGeo const*> expected(nChannels, nullptr);
+    auto const startCore = Clock_t::now();
+    for (unsigned int c = 0; c < nChannels; ++c) {
+      if (!core.IsValidOpChannel(c)) continue;
+      expected[c] = &(core.OpDetGeoFromOpChannel(c));
+    }
+    auto const coreTime = Clock_t::now() - startCore;
+
+    std::vector<geo::OpDetGeo const*> opDets(nChannels, nullptr);
+    auto const startFast = Clock_t::now();
+    geom.OpDetGeosFromOpChannels(
+      util::span<unsigned int const*>
+        { opChannels.data(), opChannels.data() + nChannels },
+      util::span<geo::OpDetGeo const**>
+        { opDets.data(), opDets.data() + nChannels }
+      );
+    auto const fastTime = Clock_t::now() - startFast;
+
+    unsigned int nErrors = 0U;
+    for (unsigned int c = 0; c < nChannels; ++c) {
+      if ((opDets[c] == expected[c])
+        && (geom.OpDetGeoPtrFromOpChannel(c) == expected[c]))
+        continue;
+      mf::LogError(fOutputCategory)
+        << "Optical channel " << c << " has a different optical detector"
+        " in the table";
+      ++nErrors;
+    } // for channels
+
+    reportTimes("OpDetGeoFromOpChannel", nChannels, fastTime, coreTime);
+    return nErrors;
+  } // GeometryFastQueryCheck::checkOpDetChannels()
+
+
+  //......................................................................
+  std::vector<geo::Point_t> GeometryFastQueryCheck::gridAround
+    (geo::BoxBoundedGeo const& box) const
+  {
+    double const margin = 0.1;
+    double const min[3] = { box.MinX(), box.MinY(), box.MinZ() };
+    double const max[3] = { box.MaxX(), box.MaxY(), box.MaxZ() };
+    double lower[3], step[3];
+    for (std::size_t axis = 0; axis < 3U; ++axis) {
+      double const size = max[axis] - min[axis];
+      lower[axis] = min[axis] - margin * size;
+      step[axis] = (1.0 + 2.0 * margin) * size / (fPointsPerSide - 1U);
+    }
+
+    std::vector<geo::Point_t> points;
+    points.reserve(fPointsPerSide * fPointsPerSide * fPointsPerSide);
+    for (unsigned int i = 0; i < fPointsPerSide; ++i) {
+      for (unsigned int j = 0; j < fPointsPerSide; ++j) {
+        for (unsigned int k = 0; k < fPointsPerSide; ++k) {
+          points.emplace_back(
+            lower[0] + i * step[0], lower[1] + j * step[1],
+            lower[2] + k * step[2]
+            );
+        } // for k
+      } // for j
+    } // for i
+    return points;
+  } // GeometryFastQueryCheck::gridAround()
+
+
+  //......................................................................
+  void GeometryFastQueryCheck::reportTimes(std::string const& what,
+    std::size_t n, Clock_t::duration fast, Clock_t::duration core) const
+  {
+    using us = std::chrono::duration<double, std::micro>;
+    mf::LogInfo(fOutputCategory) << what << ", " << n << " queries: "
+      << us(fast).count() << " us with the lookup tables, "
+      << us(core).count() << " us with the geometry provider";
+  } // GeometryFastQueryCheck::reportTimes()
+
+
+  //......................................................................
+  DEFINE_ART_MODULE(GeometryFastQueryCheck)
+
+} // namespace geo
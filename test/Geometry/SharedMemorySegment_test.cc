@@ -0,0 +1,202 @@
+/**
+ * @file   SharedMemorySegment_test.cc
+ * @brief  Tests the shared memory segment in SharedMemorySegment.h
+ * @see    larcore/Geometry/SharedMemorySegment.h
+ *
+ * This test takes no command line argument.
+ * It forks child processes, which communicate with the parent only through
+ * the shared memory segments and their exit codes.
+ *
+ */
+
+#define BOOST_TEST_MODULE ( SharedMemorySegment_test )
+
+// LArSoft libraries
+#include "larcore/Geometry/SharedMemorySegment.h"
+
+// framework libraries
+#include "cetlib_except/exception.h"
+
+// Boost libraries
+#include <cetlib/quiet_unit_test.hpp> // BOOST_AUTO_TEST_CASE()
+#include <boost/test/test_tools.hpp> // BOOST_CHECK(), BOOST_CHECK_EQUAL()
+
+// POSIX libraries
+#include <sys/wait.h> // waitpid()
+#include <unistd.h> // fork(), getpid(), _exit()
+
+// C/C++ standard libraries
+#include <string>
+#include <chrono>
+#include <thread> // std::this_thread::sleep_for()
+#include <cstring> // std::memcpy()
+#include <cstdint> // std::uint32_t
+
+
+//------------------------------------------------------------------------------
+namespace {
+
+  using namespace std::chrono_literals;
+
+  /// Returns a segment name unique to this test process.
+  std::string uniqueName(std::string const& tag)
+    { return "/larcore_test_" + tag + "_" + std::to_string(::getpid()); }
+
+  /// Removes the segment on destruction.
+  struct SegmentRemover {
+    std::string name;
+    ~SegmentRemover() { geo::SharedMemorySegment::remove(name); }
+  };
+
+  /// Fills `n` words at `data` with a known pattern.
+  void fillPattern(std::byte* data, std::size_t n) {
+    for (std::uint32_t i = 0; i < n; ++i) {
+      std::uint32_t const value = i * 7U + 3U;
+      std::memcpy(data + i * sizeof(value), &value, sizeof(value));
+    }
+  }
+
+  /// Returns whether `n` words at `data` hold the pattern of `fillPattern()`.
+  bool checkPattern(std::byte const* data, std::size_t n) {
+    for (std::uint32_t i = 0; i < n; ++i) {
+      std::uint32_t value;
+      std::memcpy(&value, data + i * sizeof(value), sizeof(value));
+      if (value != i * 7U + 3U) return false;
+    }
+    return true;
+  }
+
+  /// Waits for the process `pid` and returns its exit code (`-1` if killed).
+  int waitFor(pid_t pid) {
+    int status = 0;
+    ::waitpid(pid, &status, 0);
+    return WIFEXITED(status)? WEXITSTATUS(status): -1;
+  }
+
+  constexpr std::size_t NWords = 1024U; ///< Size of the test content.
+
+} // local namespace
+
+
+//------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(SingleProcessTest) {
+
+  std::string const name = uniqueName("single");
+  SegmentRemover const remover { name };
+
+  // nothing to attach to yet
+  BOOST_CHECK(!geo::SharedMemorySegment::attach(name, 0ms).isValid());
+
+  geo::SharedMemorySegment writer
+    = geo::SharedMemorySegment::create(name, NWords * sizeof(std::uint32_t));
+  BOOST_CHECK(writer.isValid());
+  BOOST_CHECK(writer.isWritable());
+  BOOST_CHECK_EQUAL(writer.size(), NWords * sizeof(std::uint32_t));
+
+  // creation is exclusive
+  BOOST_CHECK(!geo::SharedMemorySegment::create(name, 16U).isValid());
+
+  // not ready yet
+  BOOST_CHECK(!geo::SharedMemorySegment::attach(name, 20ms).isValid());
+
+  fillPattern(writer.writableData(), NWords);
+  writer.markReady();
+  BOOST_CHECK(!writer.isWritable());
+  BOOST_CHECK_THROW(writer.writableData(), cet::exception);
+
+  geo::SharedMemorySegment const reader
+    = geo::SharedMemorySegment::attach(name, 0ms);
+  BOOST_CHECK(reader.isValid());
+  BOOST_CHECK(!reader.isWritable());
+  BOOST_CHECK_EQUAL(reader.size(), writer.size());
+  BOOST_CHECK(checkPattern(reader.data(), NWords));
+
+} // BOOST_AUTO_TEST_CASE(SingleProcessTest)
+
+
+//------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(MultiProcessTest) {
+
+  /*
+   * The parent creates the segment and fills it slowly; the children attach
+   * while it's being filled, and must see the complete content.
+   */
+  std::string const name = uniqueName("multi");
+  SegmentRemover const remover { name };
+
+  geo::SharedMemorySegment writer
+    = geo::SharedMemorySegment::create(name, NWords * sizeof(std::uint32_t));
+  BOOST_REQUIRE(writer.isValid());
+
+  constexpr unsigned int NChildren = 4U;
+  pid_t children[NChildren];
+  for (pid_t& child: children) {
+    child = ::fork();
+    BOOST_REQUIRE(child >= 0);
+    if (child == 0) {
+      // in the child process: exit code 0 means success
+      int exitCode = 1;
+      try {
+        geo::SharedMemorySegment const reader
+          = geo::SharedMemorySegment::attach(name, 10s);
+        if (reader.isValid() && checkPattern(reader.data(), NWords))
+          exitCode = 0;
+      }
+      catch (...) { exitCode = 2; }
+      ::_exit(exitCode);
+    } // if child
+  } // for
+
+  std::this_thread::sleep_for(50ms);
+  fillPattern(writer.writableData(), NWords);
+  writer.markReady();
+
+  for (pid_t const child: children) BOOST_CHECK_EQUAL(waitFor(child), 0);
+
+} // BOOST_AUTO_TEST_CASE(MultiProcessTest)
+
+
+//------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(StaleSegmentTest) {
+
+  /*
+   * A child creates the segment and exits without declaring it ready:
+   * attaching must detect that promptly, without waiting for the timeout,
+   * and remove the segment so that it can be created again.
+   */
+  std::string const name = uniqueName("stale");
+  SegmentRemover const remover { name };
+
+  pid_t const child = ::fork();
+  BOOST_REQUIRE(child >= 0);
+  if (child == 0) {
+    int exitCode = 1;
+    try {
+      geo::SharedMemorySegment const writer = geo::SharedMemorySegment::create
+        (name, NWords * sizeof(std::uint32_t));
+      if (writer.isValid()) exitCode = 0;
+    }
+    catch (...) { exitCode = 2; }
+    ::_exit(exitCode); // never ready
+  } // if child
+  BOOST_REQUIRE_EQUAL(waitFor(child), 0);
+
+  auto const start = std::chrono::steady_clock::now();
+  BOOST_CHECK(!geo::SharedMemorySegment::attach(name, 10s).isValid());
+  BOOST_CHECK(std::chrono::steady_clock::now() - start < 5s);
+
+  geo::SharedMemorySegment writer
+    = geo::SharedMemorySegment::create(name, NWords * sizeof(std::uint32_t));
+  BOOST_REQUIRE(writer.isValid());
+  fillPattern(writer.writableData(), NWords);
+  writer.markReady();
+
+  geo::SharedMemorySegment const reader
+    = geo::SharedMemorySegment::attach(name, 0ms);
+  BOOST_CHECK(reader.isValid());
+  BOOST_CHECK(checkPattern(reader.data(), NWords));
+
+} // BOOST_AUTO_TEST_CASE(StaleSegmentTest)
+
+
+//------------------------------------------------------------------------------
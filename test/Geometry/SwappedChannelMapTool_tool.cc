@@ -0,0 +1,111 @@
+/**
+ * @file   SwappedChannelMapTool_tool.cc
+ * @brief  Tool creating a standard channel mapping with some channels swapped
+ * @see    larcore/Geometry/ChannelMapSetupTool.h
+ *
+ * This tool is meant to test the comparison of channel mappings
+ * (`DumpChannelMapDiff` module), which needs a mapping known to differ from
+ * the standard one in a known number of channels.
+ */
+
+// LArSoft libraries
+#include "larcore/Geometry/ChannelMapSetupTool.h"
+#include "larcorealg/Geometry/ChannelMapStandardAlg.h"
+#include "larcoreobj/SimpleTypesAndConstants/geo_types.h" // geo::WireID
+#include "larcoreobj/SimpleTypesAndConstants/RawTypes.h" // raw::ChannelID_t
+
+// framework libraries
+#include "art/Utilities/ToolMacros.h"
+#include "fhiclcpp/ParameterSet.h"
+
+// C/C++ standard libraries
+#include <vector>
+#include <memory> // std::make_unique()
+
+
+namespace geo {
+
+  /**
+   * @brief Standard channel mapping, with pairs of channels exchanged.
+   *
+   * The channels below `nSwapped` are exchanged in pairs (channel 0 with 1,
+   * 2 with 3, etc.); all the rest is the same as in
+   * `geo::ChannelMapStandardAlg`. With an even `nSwapped`, exactly `nSwapped`
+   * channels cover different wires than in the standard mapping.
+   * Only the channel and wire queries are affected.
+   */
+  class SwappedChannelMapAlg: public geo::ChannelMapStandardAlg {
+
+      public:
+
+    SwappedChannelMapAlg
+      (fhicl::ParameterSet const& sortingParameters, unsigned int nSwapped)
+      : geo::ChannelMapStandardAlg(sortingParameters)
+      , fNSwapped(nSwapped)
+      {}
+
+    virtual std::vector<geo::WireID> ChannelToWire
+      (raw::ChannelID_t channel) const override
+      { return geo::ChannelMapStandardAlg::ChannelToWire(swapped(channel)); }
+
+    virtual raw::ChannelID_t PlaneWireToChannel
+      (geo::WireID const& wireID) const override
+      {
+        return
+          swapped(geo::ChannelMapStandardAlg::PlaneWireToChannel(wireID));
+      }
+
+      private:
+
+    unsigned int fNSwapped; ///< Number of channels exchanged.
+
+    /// Returns the channel `channel` is exchanged with.
+    raw::ChannelID_t swapped(raw::ChannelID_t channel) const
+      {
+        return (raw::isValidChannelID(channel) && (channel < fNSwapped))
+          ? (channel ^ 1U): channel;
+      }
+
+  }; // class SwappedChannelMapAlg
+
+
+  /**
+   * @brief Tool creating a `geo::SwappedChannelMapAlg` channel mapping.
+   *
+   * Configuration parameters
+   * =========================
+   *
+   * - *SortingParameters* (parameter set, default: empty): configuration of
+   *   the standard channel mapping
+   * - *SwappedChannels* (integer, mandatory): number of channels exchanged in
+   *   pairs, starting from channel 0; it should be even
+   */
+  class SwappedChannelMapTool: public geo::ChannelMapSetupTool {
+
+      public:
+
+    explicit SwappedChannelMapTool(fhicl::ParameterSet const& config)
+      : fSortingParameters(config.get<fhicl::ParameterSet>
+          ("SortingParameters", fhicl::ParameterSet{}))
+      , fNSwapped(config.get<unsigned int>("SwappedChannels"))
+      {}
+
+      protected:
+
+    virtual std::unique_ptr<geo::ChannelMapAlg> doChannelMap() override
+      {
+        return std::make_unique<geo::SwappedChannelMapAlg>
+          (fSortingParameters, fNSwapped);
+      }
+
+      private:
+
+    fhicl::ParameterSet fSortingParameters; ///< Standard mapping settings.
+    unsigned int fNSwapped; ///< Number of channels exchanged.
+
+  }; // class SwappedChannelMapTool
+
+} // namespace geo
+
+
+DEFINE_ART_CLASS_TOOL(geo::SwappedChannelMapTool)
@@ -0,0 +1,245 @@
+/**
+ * @file   TabulatedChannelMapCheck_module.cc
+ * @brief  Compares a tabulated channel mapping with the one it tabulates
+ * @see    larcore/Geometry/TabulatedChannelMapAlg.h
+ */
+
+// LArSoft includes
+#include "larcore/Geometry/Geometry.h"
+#include "larcorealg/Geometry/GeometryCore.h"
+#include "larcorealg/Geometry/ChannelMapStandardAlg.h"
+#include "larcoreobj/SimpleTypesAndConstants/readout_types.h"
+#include "larcoreobj/SimpleTypesAndConstants/geo_types.h"
+#include "larcoreobj/SimpleTypesAndConstants/RawTypes.h" // raw::ChannelID_t
+
+// Framework includes
+#include "art/Framework/Core/ModuleMacros.h"
+#include "art/Framework/Core/EDAnalyzer.h"
+#include "art/Framework/Services/Registry/ServiceHandle.h"
+#include "messagefacility/MessageLogger/MessageLogger.h"
+#include "fhiclcpp/types/Atom.h"
+#include "fhiclcpp/types/OptionalDelegatedParameter.h"
+#include "fhiclcpp/ParameterSet.h"
+#include "cetlib_except/exception.h"
+
+// C/C++ standard library
+#include <memory> // std::make_unique()
+#include <string>
+
+
+namespace art { class Event; class Run; }
+
+namespace geo {
+
+  /**
+   * @brief Checks the channel mapping of the geometry against the standard one.
+   *
+   * The geometry service is expected to use a tabulated channel mapping
+   * (`geo::TabulatedChannelMapAlg`, e.g. from `StandardGeometryHelper` with
+   * `TabulatedChannelMap` set). A second geometry is built in the job with
+   * a plain `geo::ChannelMapStandardAlg`, and all the channel, wire, TPC set
+   * and readout plane queries of the two are compared. An exception is thrown
+   * on mismatch.
+   *
+   * Configuration parameters
+   * =========================
+   *
+   * - *SortingParameters* (parameter set, default: empty): sorting parameters
+   *   of the reference `geo::ChannelMapStandardAlg`; they should match the
+   *   ones of the geometry service
+   * - *OutputCategory* (string, default: `TabulatedChannelMapCheck`): category
+   *   of the messages
+   */
+  class TabulatedChannelMapCheck: public art::EDAnalyzer {
+      public:
+
+    struct Config {
+      using Name = fhicl::Name;
+      using Comment = fhicl::Comment;
+
+      fhicl::OptionalDelegatedParameter SortingParameters {
+        Name("SortingParameters"),
+        Comment("sorting parameters for the reference channel map")
+        };
+
+      fhicl::Atom<std::string> OutputCategory {
+        Name("OutputCategory"),
+        Comment("message facility category for the output"),
+        "TabulatedChannelMapCheck"
+        };
+
+    }; // Config
+
+    using Parameters = art::EDAnalyzer::Table<Config>;
+
+    explicit TabulatedChannelMapCheck(Parameters const& config);
+
+    virtual void analyze(art::Event const&) override {}
+    virtual void beginRun(art::Run const&) override;
+
+      private:
+
+    fhicl::ParameterSet fSortingParameters; ///< Reference sorting parameters.
+    std::string fOutputCategory; ///< Category of the messages.
+
+    /// Returns the number of mismatches in the channel queries.
+    unsigned int checkChannels
+      (geo::GeometryCore const& geom, geo::GeometryCore const& ref) const;
+
+    /// Returns the number of mismatches in the wire queries.
+    unsigned int checkWires
+      (geo::GeometryCore const& geom, geo::GeometryCore const& ref) const;
+
+    /// Returns the number of mismatches in the TPC set and ROP queries.
+    unsigned int checkReadout
+      (geo::GeometryCore const& geom, geo::GeometryCore const& ref) const;
+
+  }; // class TabulatedChannelMapCheck
+
+} // namespace geo
+
+
+//******************************************************************************
+namespace geo {
+
+  //......................................................................
+  TabulatedChannelMapCheck::TabulatedChannelMapCheck
+    (Parameters const& config)
+    : EDAnalyzer(config)
+    , fOutputCategory(config().OutputCategory())
+  {
+    config().SortingParameters.get_if_present(fSortingParameters);
+  } // TabulatedChannelMapCheck::TabulatedChannelMapCheck()
+
+
+  //......................................................................
+  void TabulatedChannelMapCheck::beginRun(art::Run const&) {
+
+    art::ServiceHandle<geo::Geometry const> geometry;
+    geo::GeometryCore const& geom = *geometry;
+
+    std::unique_ptr<geo::GeometryCore const> const ref
+      = geometry->MakeGeometryWithChannelMap
+        (std::make_unique<geo::ChannelMapStandardAlg>(fSortingParameters));
+
+    unsigned int const nErrors = checkChannels(geom, *ref)
+      + checkWires(geom, *ref) + checkReadout(geom, *ref);
+
+    if (nErrors > 0U) {
+      throw cet::exception("TabulatedChannelMapCheck")
+        << nErrors << " mismatches between the channel mapping of the"
+        " geometry and the standard one.\n";
+    }
+    mf::LogInfo(fOutputCategory)
+      << "Channel mapping of " << geom.Nchannels()
+      << " channels matches the standard one.";
+
+  } // TabulatedChannelMapCheck::beginRun()
+
+
+  //......................................................................
+  unsigned int TabulatedChannelMapCheck::checkChannels
+    (geo::GeometryCore const& geom, geo::GeometryCore const& ref) const
+  {
+    if (geom.Nchannels() != ref.Nchannels()) {
+      mf::LogError(fOutputCategory) << "Geometry has " << geom.Nchannels()
+        << " channels, expected " << ref.Nchannels();
+      return 1U;
+    }
+
+    unsigned int nErrors = 0U;
+    for (raw::ChannelID_t channel = 0; channel < ref.Nchannels(); ++channel) {
+      bool const match
+        = (geom.ChannelToWire(channel) == ref.ChannelToWire(channel))
+        && (geom.SignalType(channel) == ref.SignalType(channel))
+        && (geom.ChannelToROP(channel) == ref.ChannelToROP(channel));
+      if (match) continue;
+      mf::LogError(fOutputCategory) << "Mismatch for channel " << channel;
+      ++nErrors;
+    } // for channels
+    return nErrors;
+  } // TabulatedChannelMapCheck::checkChannels()
+
+
+  //......................................................................
+  unsigned int TabulatedChannelMapCheck::checkWires
+    (geo::GeometryCore const& geom, geo::GeometryCore const& ref) const
+  {
+    unsigned int nErrors = 0U;
+    for (geo::WireID const& wireID: ref.IterateWireIDs()) {
+      if (geom.PlaneWireToChannel(wireID) == ref.PlaneWireToChannel(wireID))
+        continue;
+      mf::LogError(fOutputCategory) << "Mismatch for wire " << wireID;
+      ++nErrors;
+    } // for wires
+    return nErrors;
+  } // TabulatedChannelMapCheck::checkWires()
+
+
+  //......................................................................
+  unsigned int TabulatedChannelMapCheck::checkReadout
+    (geo::GeometryCore const& geom, geo::GeometryCore const& ref) const
+  {
+    unsigned int nErrors = 0U;
+    if ((geom.MaxTPCsets() != ref.MaxTPCsets())
+      || (geom.MaxROPs() != ref.MaxROPs()))
+    {
+      mf::LogError(fOutputCategory)
+        << "Mismatch in the maximum number of TPC sets or readout planes";
+      ++nErrors;
+    }
+
+    for (geo::TPCID const& tpcid: ref.IterateTPCIDs()) {
+      if (geom.TPCtoTPCset(tpcid) == ref.TPCtoTPCset(tpcid)) continue;
+      mf::LogError(fOutputCategory) << "Mismatch for TPC set of " << tpcid;
+      ++nErrors;
+    } // for TPCs
+
+    for (geo::PlaneID const& planeid: ref.IteratePlaneIDs()) {
+      if (geom.WirePlaneToROP(planeid) == ref.WirePlaneToROP(planeid))
+        continue;
+      mf::LogError(fOutputCategory)
+        << "Mismatch for readout plane of " << planeid;
+      ++nErrors;
+    } // for planes
+
+    for (geo::CryostatID const& cryoid: ref.IterateCryostatIDs()) {
+      unsigned int const nTPCsets = ref.NTPCsets(cryoid);
+      if (geom.NTPCsets(cryoid) != nTPCsets) {
+        mf::LogError(fOutputCategory)
+          << "Mismatch for number of TPC sets in " << cryoid;
+        ++nErrors;
+        continue;
+      }
+      for (unsigned int s = 0; s < nTPCsets; ++s) {
+        readout::TPCsetID const tpcsetid
+          { cryoid, static_cast<readout::TPCsetID::TPCsetID_t>(s) };
+        unsigned int const nROPs = ref.NROPs(tpcsetid);
+        if (!geom.HasTPCset(tpcsetid) || (geom.NROPs(tpcsetid) != nROPs)
+          || (geom.TPCsetToTPCs(tpcsetid) != ref.TPCsetToTPCs(tpcsetid)))
+        {
+          mf::LogError(fOutputCategory) << "Mismatch for " << tpcsetid;
+          ++nErrors;
+          continue;
+        }
+        for (unsigned int r = 0; r < nROPs; ++r) {
+          readout::ROPID const ropid { tpcsetid, r };
+          bool const match = geom.HasROP(ropid)
+            && (geom.Nchannels(ropid) == ref.Nchannels(ropid))
+            && (geom.FirstChannelInROP(ropid) == ref.FirstChannelInROP(ropid))
+            && (geom.ROPtoWirePlanes(ropid) == ref.ROPtoWirePlanes(ropid))
+            && (geom.ROPtoTPCs(ropid) == ref.ROPtoTPCs(ropid));
+          if (match) continue;
+          mf::LogError(fOutputCategory) << "Mismatch for " << ropid;
+          ++nErrors;
+        } // for readout planes
+      } // for TPC sets
+    } // for cryostats
+    return nErrors;
+  } // TabulatedChannelMapCheck::checkReadout()
+
+
+  //......................................................................
+  DEFINE_ART_MODULE(TabulatedChannelMapCheck)
+
+} // namespace geo
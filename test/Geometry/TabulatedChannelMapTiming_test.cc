@@ -0,0 +1,177 @@
+/**
+ * @file   TabulatedChannelMapTiming_test.cc
+ * @brief  Times the tabulated channel mapping against the standard one
+ * @see    larcore/Geometry/TabulatedChannelMapAlg.h
+ *
+ * Usage:
+ *
+ *     TabulatedChannelMapTiming_test [GDMLfile [repetitions]]
+ *
+ * The GDML file (default: `LArTPCdetector.gdml`) is looked for in
+ * `FW_SEARCH_PATH`. Two geometries are built from it, one with a
+ * `geo::ChannelMapStandardAlg` and one with a `geo::TabulatedChannelMapAlg`
+ * wrapping another `geo::ChannelMapStandardAlg`. The channel of each wire and
+ * the wires of each channel are queried `repetitions` times (default: 10)
+ * from both, and the times are printed. The answers must be the same: the
+ * test fails on any mismatch.
+ */
+
+// LArSoft libraries
+#include "larcore/Geometry/TabulatedChannelMapAlg.h"
+#include "larcorealg/Geometry/GeometryCore.h"
+#include "larcorealg/Geometry/ChannelMapStandardAlg.h"
+#include "larcoreobj/SimpleTypesAndConstants/geo_types.h"
+#include "larcoreobj/SimpleTypesAndConstants/RawTypes.h" // raw::ChannelID_t
+
+// framework libraries
+#include "fhiclcpp/ParameterSet.h"
+#include "cetlib/search_path.h"
+
+// C/C++ standard libraries
+#include <iostream>
+#include <vector>
+#include <string>
+#include <memory> // std::make_unique()
+#include <chrono>
+#include <utility> // std::move()
+#include <cstdlib> // std::stoul()
+
+
+namespace {
+
+  using Clock_t = std::chrono::steady_clock;
+  using ms = std::chrono::duration<double, std::milli>;
+
+  /// Returns the time taken by `nRepetitions` calls of `f`, in milliseconds.
+  template <typename F>
+  ms timeRepeated(unsigned int nRepetitions, F&& f) {
+    auto const start = Clock_t::now();
+    for (unsigned int i = 0; i < nRepetitions; ++i) f();
+    return Clock_t::now() - start;
+  } // timeRepeated()
+
+
+  /// Builds a geometry from `GDMLpath` with the channel mapping `channelMap`.
+  std::unique_ptr<geo::GeometryCore> makeGeometry(
+    std::string const& GDMLpath,
+    std::unique_ptr<geo::ChannelMapAlg> channelMap
+  ) {
+    fhicl::ParameterSet config;
+    config.put("Name", std::string{ "lartpcdetector" });
+    config.put("SurfaceY", 0.0);
+    auto geom = std::make_unique<geo::GeometryCore>(config);
+    // the second geometry reuses the ROOT geometry loaded by the first one
+    geom->LoadGeometryFile(GDMLpath, GDMLpath, false);
+    geom->ApplyChannelMap(std::move(channelMap));
+    return geom;
+  } // makeGeometry()
+
+} // local namespace
+
+
+//------------------------------------------------------------------------------
+int main(int argc, char const** argv) {
+
+  std::string const GDMLfile
+    = (argc > 1)? argv[1]: "LArTPCdetector.gdml";
+  unsigned int const nRepetitions = (argc > 2)? std::stoul(argv[2]): 10U;
+
+  std::string GDMLpath;
+  if (!cet::search_path{ "FW_SEARCH_PATH" }.find_file(GDMLfile, GDMLpath)) {
+    std::cerr << "Can't find the geometry file '" << GDMLfile << "'."
+      << std::endl;
+    return 1;
+  }
+
+  fhicl::ParameterSet const sortingParameters;
+  auto standardAlg
+    = std::make_unique<geo::ChannelMapStandardAlg>(sortingParameters);
+  auto tabulatedAlg = std::make_unique<geo::TabulatedChannelMapAlg>
+    (std::make_unique<geo::ChannelMapStandardAlg>(sortingParameters));
+  geo::ChannelMapAlg const& standard = *standardAlg;
+  geo::TabulatedChannelMapAlg const& tabulated = *tabulatedAlg;
+
+  std::unique_ptr<geo::GeometryCore const> const geom
+    = makeGeometry(GDMLpath, std::move(standardAlg));
+  std::unique_ptr<geo::GeometryCore const> const tabGeom
+    = makeGeometry(GDMLpath, std::move(tabulatedAlg));
+
+  std::vector<geo::WireID> wireIDs;
+  for (geo::WireID const& wireID: geom->IterateWireIDs())
+    wireIDs.push_back(wireID);
+  raw::ChannelID_t const nChannels = geom->Nchannels();
+
+  //
+  // check
+  //
+  unsigned int nErrors = 0U;
+  if (tabGeom->Nchannels() != nChannels) {
+    std::cerr << "Tabulated geometry has " << tabGeom->Nchannels()
+      << " channels, expected " << nChannels << std::endl;
+    ++nErrors;
+  }
+  for (geo::WireID const& wireID: wireIDs) {
+    if (tabulated.PlaneWireToChannel(wireID)
+      == standard.PlaneWireToChannel(wireID))
+    {
+      continue;
+    }
+    std::cerr << "Mismatch for wire " << wireID << std::endl;
+    ++nErrors;
+  } // for wires
+  for (raw::ChannelID_t channel = 0; channel < nChannels; ++channel) {
+    std::vector<geo::WireID> const expected = standard.ChannelToWire(channel);
+    geo::TabulatedChannelMapAlg::WireIDs_t const wires
+      = tabulated.ChannelWires(channel);
+    if ((tabulated.ChannelToWire(channel) == expected)
+      && std::vector<geo::WireID>(wires.begin(), wires.end()) == expected)
+    {
+      continue;
+    }
+    std::cerr << "Mismatch for channel " << channel << std::endl;
+    ++nErrors;
+  } // for channels
+
+  //
+  // timing
+  //
+  unsigned long int checksum = 0UL; // keeps the calls from being optimized
+  ms const standardWireTime = timeRepeated(nRepetitions, [&](){
+    for (geo::WireID const& wireID: wireIDs)
+      checksum += standard.PlaneWireToChannel(wireID);
+    });
+  ms const tabulatedWireTime = timeRepeated(nRepetitions, [&](){
+    for (geo::WireID const& wireID: wireIDs)
+      checksum += tabulated.PlaneWireToChannel(wireID);
+    });
+  ms const standardChannelTime = timeRepeated(nRepetitions, [&](){
+    for (raw::ChannelID_t channel = 0; channel < nChannels; ++channel)
+      checksum += standard.ChannelToWire(channel).size();
+    });
+  ms const tabulatedChannelTime = timeRepeated(nRepetitions, [&](){
+    for (raw::ChannelID_t channel = 0; channel < nChannels; ++channel)
+      checksum += tabulated.ChannelToWire(channel).size();
+    });
+  ms const tabulatedSpanTime = timeRepeated(nRepetitions, [&](){
+    for (raw::ChannelID_t channel = 0; channel < nChannels; ++channel)
+      checksum += tabulated.ChannelWires(channel).size();
+    });
+
+  std::cout << "Timing of " << nRepetitions << " passes on "
+    << wireIDs.size() << " wires and " << nChannels << " channels:"
+    << "\n  PlaneWireToChannel(): standard " << standardWireTime.count()
+    << " ms, tabulated " << tabulatedWireTime.count() << " ms"
+    << "\n  ChannelToWire():      standard " << standardChannelTime.count()
+    << " ms, tabulated " << tabulatedChannelTime.count() << " ms"
+    << "\n  ChannelWires():       tabulated " << tabulatedSpanTime.count()
+    << " ms"
+    << "\n(checksum: " << checksum << ")"
+    << std::endl;
+
+  if (nErrors > 0U) {
+    std::cerr << nErrors << " mismatches found." << std::endl;
+    return 1;
+  }
+  return 0;
+
+} // main()